@@ -59,18 +59,262 @@
     \n \section FuncDesc Functional Description
 
     \n \subsection General General
-	The driver supports reading of the current value of the current channel via M_read()
+	The driver supports reading of the current value of the current channel via M_read(),
+	writing the PWM duty cycle via M_write()
 	and reading blocks of the current values from all channels via M_getblock(). The driver
 	provides the values within a signed 32-bit data quadword.
 
+	Channels (LM63_CH_xxx):
+	- ch 0: local temperature [degrees Celsius]
+	- ch 1: remote temperature [degrees Celsius]
+	- ch 2: fan speed [rpm]
+	- ch 3: PWM duty cycle 0..100 [%] (read and write)
+
+	Note: The PWM channel changed the number of channels from 3 to 4
+	(M_LL_CH_NUMBER). M_getblock() with a buffer for more than three values now
+	also returns the PWM duty cycle, and applications which iterate over all
+	channels of the device now also visit the PWM channel.
+
+	M_getblock() returns a coherent snapshot: all values belong to the same conversion
+	period and are read from the device in one sequence of SMBus transactions.
+
 	When the first path is opened to an LM63 device, the HW and the driver are being
 	initialized with default values	(see section about \ref descriptor_entries).
 
+    \n \subsection shadow Register shadow
+	The LM63 provides new measurement results only once per conversion period
+	(programmed in the conversion rate register, read at initialization). The driver
+	keeps a shadow of the measurement registers and returns the shadowed values
+	without any SMBus transaction if they were read within the last conversion
+	period. So several applications can poll the same device without loading the
+	SMBus with redundant transactions.\n
+	The shadow can be bypassed with the LM63_CACHE_BYPASS setstat code.
+	The reuse window defaults to the conversion period and can be changed with the
+	COALESCE_WINDOW descriptor key or the LM63_COALESCE_WIN setstat code. A read
+	which waits for a concurrent read of the same registers gets its result, too.
+	The LM63_COALESCED getstat code returns the number of device reads saved. It is
+	approximate: reads served lock-free from the published values (see
+	\ref locking) count without lock, so concurrent calls may rarely lose a count.
+	The LM63_XFER_COUNT getstat code returns the number of SMBus transactions of
+	the device (e.g. to compute the SMBus transactions per sample).
+
+    \n \subsection locking Locking
+	The driver doesn't use the MDIS call lock (LL_LOCK_NONE). The SMBus access is
+	serialized by a driver semaphore (taken in call context only), and setstat calls
+	are serialized by another driver semaphore. All SMBus transactions of the device,
+	including the hardware initialization, are done with the SMBus access granted.
+	Only the additional sensors of the aggregator are read under a third semaphore
+	(see \ref aggregator). Lock order: setstat lock, sweep lock, SMBus access. A
+	call interrupted by a signal while waiting for a lock returns the OSS error
+	code. After each SMBus access the driver publishes a copy of the register
+	shadow which M_read() and M_getblock() read lock-free (sequence lock with
+	memory barriers). So a read
+	that can be served from the shadow never waits for an SMBus transfer started by
+	another process. Getstat codes which only return driver state don't wait, either.
+
+    \n \subsection wordread SMBus word read
+	The tach count registers (0x46/0x47) are read with one SMBus word transaction
+	if the SMBus controller supports it (probed at initialization, can be disabled with
+	the SMB_WORD_READ descriptor key). Otherwise the registers are read with two byte
+	transactions in the order that latches the second byte (tach count: LSB first,
+	remote temperature: MSB first). The LM63_SMB_WORDREAD getstat code reports the used
+	method.
+
+    \n \subsection sampler Periodic sampler
+	Instead of reading the device on each M_read() call, the driver can sample
+	the channels periodically by itself (OSS alarm). The sample period of each channel
+	is set with the LM63_SMPL_PERIOD setstat code (current channel) or the
+	SMPL_PERIOD_n descriptor keys. The sampler is started and stopped with the
+	LM63_SMPL_START setstat code.\n
+	The SMBus can't be accessed in alarm context (the SMBus controller driver may
+	sleep), so the alarm routine only marks the channels whose sample period has
+	elapsed as due and wakes up a LM63_BLK_FIFO call waiting for samples (see
+	LM63_FIFO_WAIT). The waiting call reads the due channels and keeps waiting until
+	it got the requested samples, so a reader blocked in LM63_BLK_FIFO drives the
+	acquisition at the sample rate. Without a waiting call, the due channels are read
+	by the next call which accesses the device. Due samples are not caught up: a
+	sample period which elapses while the sample of the previous period is still due
+	is counted as missed (LM63_SMPL_MISSED). So an application should wait for the
+	samples with LM63_FIFO_WAIT.\n
+	For the same reason, the timestamp of a sample is the time the sample was taken
+	in call context, not the time it was due. It lags behind the due time by the
+	wake-up latency of the waiting call (or until the next call without one).\n
+	While the sampler is running, M_read() and M_getblock() return the latest sampled
+	values of the sampled channels without any SMBus transaction, even if the next
+	sample is due. A sampled value is used for at most twice the sample period, so
+	reads access the device again if the sampler doesn't run (e.g. no waiting call).
+	Channels with a sample period of 0 are read as before.
+
+    \n \subsection fifo Sample FIFO
+	Each value taken by the periodic sampler is also stored with its channel and
+	a timestamp [ms] in a sample FIFO (512 entries). The samples are read in bulk
+	with the LM63_BLK_FIFO getstat code (array of LM63_SAMPLE, up to the block size).
+	The FIFO is lock-free: the sampler only writes the in index, the getstat call only
+	the out index. Memory barriers order the entry and index accesses, so the FIFO
+	also works on weakly ordered CPUs.\n
+	If the FIFO is full, new samples are dropped and counted (LM63_FIFO_OVERFLOW).
+	Optionally, a signal (LM63_FIFO_SIG_SET) is sent once when the fill level reaches
+	the high-watermark (LM63_FIFO_HWM). It is re-armed when the fill level falls below
+	the high-watermark.\n
+	With LM63_FIFO_WAIT set, the LM63_BLK_FIFO getstat takes the due samples and waits
+	until the FIFO contains the requested number of samples (block size), or the
+	high-watermark if set, or the wait time has elapsed (the samples so far, no error).
+	To wake up on each sample, set the high-watermark to 1. Waiting does not block
+	other calls. Don't wait forever if the sampler is stopped.
+
+    \n \subsection deadband Deadband
+	To report only significant changes, a deadband can be set per channel
+	(LM63_DEADBAND setstat code for the current channel or DEADBAND_n descriptor
+	keys). The sampler then puts a sample into the FIFO only if its value differs
+	from the last reported value of the channel by at least the deadband (1: any
+	change), or if no sample of the channel was reported for the max. silence
+	interval (LM63_SILENCE_MAX, SILENCE_MAX_n). The first sample after setting the
+	deadband or changing LM63_TEMP_UNIT is always reported. Suppressed samples are
+	counted (LM63_DEADBAND_CNT), they are still included in the channel statistics.
+	Together with LM63_FIFO_WAIT and a high-watermark of 1, the application wakes
+	up only on changes.
+	M_read() and M_getblock() always return the current values.
+
+    \n \subsection alert ALERT handling
+	If ALERT handling is enabled (ALERT_ENABLE descriptor key or LM63_ALERT_ENABLE
+	setstat code), the driver programs the ALERT mask register (ALERT_MASK descriptor
+	key, LM63_ALERT_MASKED setstat code) and unmasks the ALERT output of the LM63.
+	When the LM63 asserts ALERT, the driver marks the ALERT pending and sends the
+	signal installed with LM63_ALERT_SIG_SET. The next driver call (e.g. the
+	LM63_ALERT_LATCH getstat of the signalled application) reads the ALERT status
+	register (which clears the inactive causes) and latches the causes
+	(LM63_ALERT_LATCH, see \ref alert_causes). So applications don't need to poll
+	for over-temperature or fan-stall conditions.\n
+	The ALERT is delivered via the alert callback of the SMBus controller driver
+	(SMBALERT#), which may run in interrupt context, so the callback doesn't access
+	the device. If the SMBus controller driver doesn't support alert callbacks,
+	enabling ALERT handling fails with ERR_LL_ILL_FUNC; the ALERT causes can still
+	be polled with the LM63_ALERT_STATUS getstat code. Note: The LM63 pin 8 is
+	either the ALERT output or the TACH input, depending on the board.
+
+    \n \subsection limits Hardware limits
+	The LM63 compares each conversion result with its limit registers. The limits
+	can be programmed via the LIM_xxx descriptor keys (only specified keys are written)
+	or the LM63_LIM_xxx setstat codes. The LM63_ALERT_STATUS getstat code reads the
+	current ALERT status (see \ref alert_causes) from the device with one SMBus
+	transaction, so limit supervision doesn't require reading and comparing all
+	channels. The LM63_LIM_xxx temperature limits are in the unit of the temperature
+	channels (see \ref tempunit) and are rounded to the register resolution: 1
+	degree, 0.125 degrees for the remote limits LM63_LIM_RMT_HIGH/LOW. The LIM_xxx
+	descriptor keys are always whole degrees Celsius.
+
+    \n \subsection pwm PWM output
+	By default, the PWM output is controlled by the lookup table of the LM63 and the
+	PWM value register is write-protected. The first M_write() to the PWM channel
+	(or the LM63_PWM_MANUAL setstat code) enables PWM programming, so the PWM
+	output follows the written duty cycle. The driver keeps a shadow of the PWM
+	registers: writing an unchanged duty cycle or reading the PWM channel causes no
+	SMBus transaction. LM63_PWM_MANUAL=0 hands the control back to the lookup table.
+
+    \n \subsection lut Fan lookup table
+	The LM63_BLK_LUT block setstat loads the 8-point lookup table and its hysteresis
+	(LM63_LUT) in one call, so the LM63 controls the fan without host interaction.
+	The table is verified completely (ascending temperatures 0..127, duty cycles
+	0..100 %, hysteresis 0..31) before any register is written, and only changed
+	entries are written. The LM63_BLK_LUT block getstat reads the table back.
+	The lookup table controls the PWM output if LM63_PWM_MANUAL is 0.
+
+    \n \subsection oneshot One-shot conversion mode
+	By default, the LM63 converts free-running at its conversion rate, so a read
+	returns a value up to one conversion period old. In one-shot mode (CONV_MODE
+	descriptor key or LM63_CONV_MODE setstat code) the LM63 stays in standby and
+	each M_read() or M_getblock() triggers a conversion. The driver waits the
+	nominal conversion time, polls the busy flag of the ALERT status until the
+	conversion is complete and returns the new values. As polling clears the
+	inactive ALERT causes, the ALERT causes read while polling are latched
+	(LM63_ALERT_LATCH), also with ALERT handling disabled. One-shot mode and the periodic sampler exclude each other
+	(ERR_LL_DEV_BUSY). Note that the fan lookup table is not updated in standby.
+	M_close() restores continuous conversions.
+
+    \n \subsection tempunit Temperature resolution
+	By default, the temperature channels return whole degrees Celsius (the remote
+	temperature is rounded). With LM63_TEMP_UNIT=LM63_UNIT_MILLIDEG (or the TEMP_UNIT
+	descriptor key) both temperature channels return milli-degrees Celsius, and the
+	remote temperature keeps the native 0.125 degrees resolution. The unit applies to
+	M_read(), M_getblock(), the samples of the periodic sampler and the LM63_LIM_xxx
+	temperature limits.
+
+    \n \subsection aggregator Multi-sensor aggregator
+	One device instance can read a list of LM63 sensors on several SMBus buses.
+	Sensor 0 is the device itself (SMB_BUSNBR, SMB_DEVADDR), sensor 1..n are
+	specified in the SENSOR_n descriptor directories (see SENSOR_NUM). The
+	LM63_BLK_SENSORS block getstat reads the temperatures and fan speed of all
+	sensors with one call (LM63_SENSOR_VAL[] in descriptor order). The driver reads
+	the sensors bus by bus, so sensors on the same bus are read back to back. Only
+	sensor 0 is read with the SMBus access of the device granted, the additional
+	sensors are read under a separate sweep lock (see \ref locking). So retries of
+	a slow or absent sensor don't delay the other calls of the device. An
+	inaccessible sensor does not abort the sweep, its error code is returned in
+	LM63_SENSOR_VAL.error. Apart from the tach mode, the driver does not program
+	the registers of the additional sensors.
+
+    \n \subsection hwinit Hardware initialization
+	By default, M_open() programs the PWM, fan spin-up and remote temperature offset
+	registers unconditionally. With the INIT_VERIFY descriptor key, the driver reads
+	these registers back and writes only the registers which differ. If the PWM
+	setup is already programmed, it is skipped completely, so the fan isn't
+	disturbed. With INIT_DEFER, M_open() doesn't access the device and the hardware
+	is programmed on the first M_read(), M_write(), M_getblock() or device specific
+	status call. The LM63_INIT_SAVED getstat code returns the net number of SMBus
+	transactions saved (skipped writes minus verify reads, negative if the verify
+	reads cost more than they saved), LM63_INIT_TIME the duration of the hardware initialization.
+
+	With the WARM_ATTACH descriptor key, M_close() keeps the driver's register
+	shadow (PWM setup, lookup table, conversion period) in a driver global
+	context. The next M_open() of the same device checks the PWM registers
+	against this context and, if they match, skips the PWM setup and takes the
+	PWM shadow, conversion period and lookup table from the context. So the fan
+	(including a PWM value written via the PWM channel) isn't disturbed. The
+	remote temperature offset, the LIM_xxx limits and the tach mode of the
+	additional sensors are verified as with INIT_VERIFY, so descriptor changes
+	take effect. LM63_WARM shows whether the device was attached warm.
+
+    \n \subsection retry SMBus retries
+	SMBus transactions failing with a transient error (bus or controller busy,
+	arbitration lost) are retried up to SMB_RETRY times. The delay before a
+	retry starts with SMB_RETRY_DELAY and doubles with each retry. A retry is only
+	done if it ends within SMB_DEADLINE, counted from the moment the call got the
+	SMBus access. So the time a call keeps the SMBus is bounded, and a call
+	waiting for the SMBus waits at most this time per call ahead. Other errors,
+	incl. NACK (absent device), are returned at once. The retry delay sleeps,
+	so retries are only done with the SMBus access granted, i.e. in call
+	context (see \ref locking). The LM63_PERF counters xferRetries and
+	xferDeadline show the retries done and the retries refused because of the
+	deadline.
+
+    \n \subsection perf Performance counters
+	The driver always counts the SMBus transactions, data bytes and failed
+	transactions, and the device reads of M_read() with their duration. The
+	latency of M_read() (per channel and total), M_getblock() and M_getstat() is
+	accounted in histograms with logarithmic buckets (bucket n: 2^(n-1)..2^n-1 us).
+	The LM63_BLK_PERF block getstat returns all counters (LM63_PERF), the
+	LM63_PERF_RESET setstat code clears them. The SMBus transaction and device
+	read counters are updated with the bus access granted (see \ref locking) and
+	are exact. The latency histograms are updated without lock, concurrent calls
+	may rarely lose a count. The time stamps have OSS tick resolution unless the
+	driver is built with LM63_PERF_CLOCK.
+
+    \n \subsection stats Channel statistics
+	For the input channels, the driver keeps min., max. and mean value and an
+	exponentially weighted moving average (time constant EWMA_TAU) of all values
+	read from the device, by M_read(), M_getblock() or the periodic sampler.
+	Values reused from the register shadow are not counted. The LM63_BLK_STATS
+	block getstat returns the statistics (LM63_STATS), LM63_BLK_STATS_RST
+	additionally resets them in the same step, so no value is lost between two
+	reporting intervals. Changing LM63_TEMP_UNIT restarts the statistics of the
+	temperature channels.
+
     \n \subsection channels Logical channels
-	The driver provides three logical channels:\n
+	The driver provides four logical channels:\n
 	 ch 0: LM63 die temperature (-55..125) [degrees Celsius]\n
 	 ch 1: remote temperature (-55..125) [degrees Celsius]\n
 	 ch 2: fan speed [rpm]\n
+	 ch 3: PWM duty cycle (0..100) [%] (read/write)\n
 	Note: The \ref channel_selector defines can be used from within user-mode applications to
 	select the current channel.
 
@@ -88,6 +332,8 @@
     <td>LM63_Exit())</td></tr>
     <tr><td>M_read()      </td><td>Read from device         </td>
     <td>LM63_Read()</td></tr>
+    <tr><td>M_write()     </td><td>Write to device          </td>
+    <td>LM63_Write()</td></tr>
     <tr><td>M_setstat()   </td><td>Set device parameter     </td>
     <td>LM63_SetStat()</td></tr>
     <tr><td>M_getstat()   </td><td>Get device parameter     </td>
@@ -132,15 +378,154 @@
         <td>-55..125 [degrees Celsius]\n
 			Default: 0</td>
     </tr>
+    <tr><td>ALERT_ENABLE</td>
+        <td>enable ALERT handling</td>
+        <td>0, 1\n
+			Default: 0</td>
+    </tr>
+    <tr><td>ALERT_MASK</td>
+        <td>masked ALERT causes (LM63_ALERT_xxx)</td>
+        <td>0x00..0x5f\n
+			Default: 0x00</td>
+    </tr>
+    <tr><td>LIM_TEMP_HIGH</td>
+        <td>local high setpoint</td>
+        <td>-128..127 [degrees Celsius]\n
+			Default: not programmed</td>
+    </tr>
+    <tr><td>LIM_RMT_HIGH</td>
+        <td>remote high setpoint</td>
+        <td>-128..127 [degrees Celsius]\n
+			Default: not programmed</td>
+    </tr>
+    <tr><td>LIM_RMT_LOW</td>
+        <td>remote low setpoint</td>
+        <td>-128..127 [degrees Celsius]\n
+			Default: not programmed</td>
+    </tr>
+    <tr><td>LIM_RMT_TCRIT</td>
+        <td>remote TCRIT setpoint</td>
+        <td>-128..127 [degrees Celsius]\n
+			Default: not programmed</td>
+    </tr>
+    <tr><td>LIM_RMT_TCRIT_HYS</td>
+        <td>remote TCRIT hysteresis</td>
+        <td>0..255 [degrees Celsius]\n
+			Default: not programmed</td>
+    </tr>
+    <tr><td>LIM_FANSPEED</td>
+        <td>min. fan speed</td>
+        <td>0=off, 1..10800000/TACH_PULSE [rpm]\n
+			Default: not programmed</td>
+    </tr>
+    <tr><td>INIT_DEFER</td>
+        <td>program the hardware on the first access instead of in M_open()</td>
+        <td>0, 1\n
+			Default: 0</td>
+    </tr>
+    <tr><td>WARM_ATTACH</td>
+        <td>attach to a device configured by a previous session without programming it</td>
+        <td>0, 1\n
+			Default: 0</td>
+    </tr>
+    <tr><td>INIT_VERIFY</td>
+        <td>read back the configuration registers and write only the differing ones</td>
+        <td>0, 1\n
+			Default: 0</td>
+    </tr>
+    <tr><td>SENSOR_NUM</td>
+        <td>number of sensors of the aggregator (incl. sensor 0 = this device)</td>
+        <td>1..64\n
+			Default: 1</td>
+    </tr>
+    <tr><td>SENSOR_n/SMB_BUSNBR</td>
+        <td>SMBus bus number of sensor n (n=1..SENSOR_NUM-1)</td>
+        <td>0..n\n
+			Default: none (required if SENSOR_NUM > n)</td>
+    </tr>
+    <tr><td>SENSOR_n/SMB_DEVADDR</td>
+        <td>SMBus address of sensor n (n=1..SENSOR_NUM-1)</td>
+        <td>0x00..0xff\n
+			Default: none (required if SENSOR_NUM > n)</td>
+    </tr>
+    <tr><td>TEMP_UNIT</td>
+        <td>unit of the temperature channels</td>
+        <td>0=degrees Celsius, 1=milli-degrees Celsius\n
+			Default: 0</td>
+    </tr>
+    <tr><td>CONV_MODE</td>
+        <td>conversion mode</td>
+        <td>0=continuous, 1=one-shot on read\n
+			Default: 0</td>
+    </tr>
+    <tr><td>COALESCE_WINDOW</td>
+        <td>window in which a device read is reused for further reads [ms]</td>
+        <td>0..n\n
+			Default: conversion period</td>
+    </tr>
+    <tr><td>SMPL_PERIOD_n</td>
+        <td>sample period of channel n for the periodic sampler [ms]</td>
+        <td>0=not sampled, 1..n\n
+			Default: 0</td>
+    </tr>
+    <tr><td>DEADBAND_n</td>
+        <td>min. change of channel n to put a sample into the FIFO</td>
+        <td>0=off (all samples), 1..n\n
+			Default: 0</td>
+    </tr>
+    <tr><td>SILENCE_MAX_n</td>
+        <td>max. time without sample of channel n in the FIFO if the deadband is on [ms]</td>
+        <td>0=unlimited, 1..n\n
+			Default: 0</td>
+    </tr>
+    <tr><td>SMB_WORD_READ</td>
+        <td>use SMBus word read for the tach count if supported by the SMBus controller</td>
+        <td>0, 1\n
+			Default: 1</td>
+    </tr>
+    <tr><td>SMB_RETRY</td>
+        <td>max. retries of an SMBus transaction with transient error</td>
+        <td>0..n\n
+			Default: 2</td>
+    </tr>
+    <tr><td>SMB_RETRY_DELAY</td>
+        <td>delay before the first retry [ms], doubled with each retry</td>
+        <td>0..n\n
+			Default: 1</td>
+    </tr>
+    <tr><td>SMB_DEADLINE</td>
+        <td>max. SMBus time of one call for retries [ms] (0=unlimited)</td>
+        <td>0..n\n
+			Default: 100</td>
+    </tr>
+    <tr><td>EWMA_TAU</td>
+        <td>time constant of the channel statistics EWMA [ms]</td>
+        <td>1..30000\n
+			Default: 1000</td>
+    </tr>
     </table>
 
     \n \section codes LM63 specific Getstat/Setstat codes
-    none
+    see \ref getstat_setstat_codes "LM63 specific Getstat/Setstat codes"
 
     \n \section programs Overview of provided LM63 programs
 
     \subsection lm63_simp  Simple example of using the driver
     lm63_simp.c (see Examples section)
+
+    \subsection lm63_trace  Binary trace recorder and CSV converter
+    lm63_trace records snapshots of all channels into a compact binary trace
+	file (2..5 bytes per sample instead of about 60 bytes of text) and
+	converts trace files to CSV. The format and the encoder/decoder library
+	lm63_trc are described in lm63_trc.h. The trace header contains the
+	driver ident string and the SMB address (LM63_SMB_DEVADDR).
+
+    \subsection lm63_log  Ring file logger
+    lm63_log samples all channels with a fixed period into a memory-mapped
+	ring file of fixed size, without memory allocation or write() calls per
+	sample (Linux only). Other processes can read the ring file while the
+	logger is running, see lm63_log.h for the layout and the read protocol.
+	lm63_log -r prints a ring file as CSV.
 */
 
 /** \example lm63_simp.c
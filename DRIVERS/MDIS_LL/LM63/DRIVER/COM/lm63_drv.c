@@ -9,6 +9,8 @@
  *     Required: OSS, DESC, DBG, libraries
  *
  *     \switches _ONE_NAMESPACE_PER_DRIVER_
+ *               LM63_PERF_CLOCK - time stamp function [us] for the
+ *                                 performance counters (default: OSS tick)
  */
  /*
  *---------------------------------------------------------------------------
@@ -52,7 +54,7 @@
 |  DEFINES                                 |
 +-----------------------------------------*/
 /* general defines */
-#define CH_NUMBER			3			/**< Number of device channels */
+#define CH_NUMBER			4			/**< Number of device channels */
 #define CH_BYTES			2			/**< Number of bytes per channel */
 #define USE_IRQ				FALSE		/**< Interrupt required  */
 #define ADDRSPACE_COUNT		0			/**< Number of required address spaces */
@@ -62,9 +64,166 @@
 #define DBG_MYLEVEL			llHdl->dbgLevel   /**< Debug level */
 #define DBH					llHdl->dbgHdl     /**< Debug handle */
 
+/* register shadow defines */
+#define SHADOW_TEMP			0			/**< local temp (0x00) */
+#define SHADOW_RMTTEMP		1			/**< remote temp (0x01/0x10) */
+#define SHADOW_TACH			2			/**< tach count (0x46/0x47) */
+#define SHADOW_ALERT		3			/**< ALERT status (0x02) */
+#define SHADOW_NUM			4			/**< Number of shadowed registers */
+#define SHADOW_NONE			-1			/**< channel without register shadow */
+
+/* PWM defines */
+#define PWM_RPM_PROGRAM		0x20		/**< PWM_RPM: PWM value/lookup table writable */
+#define PWM_RPM_INIT		0x2a		/**< PWM_RPM at init (see HwProgram()) */
+#define PWM_SPINUP_INIT		0x3f		/**< FAN_SPINUP_CFG at init (POR value) */
+#define PWM_FREQU_INIT		0x17		/**< PWM_FREQU at init (POR value) */
+#define PWM_VALUE_INIT		0x00		/**< PWM_VALUE at init (POR value) */
+#define PWM_TO_RAW(h,pct)	((u_int8)(((pct) * 2 * (h)->pwmFrequ + 50) / 100))
+									/**< duty cycle [%] to PWM register value */
+#define LUT_NUM				8			/**< lookup table entries */
+#define LUT_PWM_MASK		0x3f		/**< lookup table PWM value */
+#define LUT_TEMP_MAX		127			/**< max. lookup table temp [C] */
+#define LUT_HYS_MAX			31			/**< max. lookup table hysteresis [C] */
+
+/* warm attach defines */
+#define CTX_MAX				16			/**< max. saved device contexts */
+
+/* device specific status code */
+#define DEV_CODE(c)	((((c) >= M_DEV_OF) && ((c) < M_DEV_OF+0x100)) || \
+					 (((c) >= M_DEV_BLK_OF) && ((c) < M_DEV_BLK_OF+0x100)))
+
+/* published shadow defines */
+#define PUB_RETRY			8			/**< max. retries of lock-free read */
+
+/* aggregator defines */
+#define SENSOR_MAX			64			/**< max. sensors per device instance */
+#define PWM_RPM_TACH_MASK	0x03		/**< PWM_RPM: tach mode */
+#define PWM_RPM_TACH_MODE	0x02		/**< PWM_RPM: most accurate readings */
+
+/* SMBus transaction layer defines */
+#define SMB_RETRY_DEF		2			/**< default retries per transaction */
+#define SMB_RETRY_DELAY_DEF	1			/**< default first retry delay [ms] */
+#define SMB_DEADLINE_DEF	100			/**< default bus time per call [ms] */
+#define SMB_BACKOFF_MAX		8			/**< max. retry delay doublings */
+
+/* channel statistics defines */
+#define ACC_NUM				3			/**< channels with statistics (LM63_STATS_CH) */
+#define EWMA_TAU_DEF		1000		/**< default EWMA time constant [ms] */
+#define EWMA_TAU_MAX		30000		/**< max. EWMA time constant [ms] */
+#define EWMA_DT_MAX			32767		/**< max. interval of one EWMA step [ms] */
+#define EWMA_SCALE			16			/**< EWMA fixed point scale */
+
+/* one-shot conversion defines */
+#define ONESHOT_TIMEOUT		200			/**< max. one-shot conversion time [ms] */
+#define ONESHOT_CONV_MS		25			/**< nominal conversion time [ms] */
+#define ONESHOT_POLL_MS		1			/**< busy flag poll interval [ms] */
+
+/* limit register types */
+#define LIM_TEMP			0			/**< 8-bit temp [C] */
+#define LIM_RMTTEMP			1			/**< 11-bit remote temp (MSB/LSB) [C] */
+#define LIM_HYS				2			/**< 8-bit hysteresis [C] */
+#define LIM_TACH			3			/**< 16-bit tach count (LSB/MSB) [rpm] */
+
+/* sample FIFO defines */
+#define FIFO_SIZE			512			/**< FIFO entries (power of 2) */
+
+/*
+ * memory barriers for the lock-free data structures (sample FIFO,
+ * published shadow):
+ * volatile doesn't order the accesses on weakly ordered CPUs (PowerPC, ARM)
+ * MEM_WMB - stores before the barrier are visible before later stores
+ * MEM_RMB - loads before the barrier are done before later loads
+ * MEM_MB  - all accesses before the barrier are done before later accesses
+ */
+#ifndef MEM_MB
+# if defined(LINUX) && defined(__KERNEL__)
+#  define MEM_WMB()			smp_wmb()
+#  define MEM_RMB()			smp_rmb()
+#  define MEM_MB()			smp_mb()
+# elif defined(__GNUC__)
+#  define MEM_WMB()			__sync_synchronize()
+#  define MEM_RMB()			__sync_synchronize()
+#  define MEM_MB()			__sync_synchronize()
+# else
+#  error "define MEM_WMB(), MEM_RMB() and MEM_MB() for this compiler"
+# endif
+#endif
+
 /*-----------------------------------------+
 |  TYPEDEFS                                |
 +-----------------------------------------*/
+/** shadow of a measurement register (pair) */
+typedef struct {
+	u_int16			raw;			/**< raw value (MSB<<8 | LSB) */
+	u_int32			tick;			/**< OSS tick of last device read */
+	int32			valid;			/**< raw value is valid */
+	u_int32			sampled;		/**< sample period of periodic sampler [ms]
+										 (0=not sampled) */
+} LM63_SHADOW;
+
+/** statistics accumulator of an input channel */
+typedef struct {
+	u_int32			count;			/**< device reads since reset */
+	int32			min;			/**< min. value */
+	int32			max;			/**< max. value */
+	int32			mean;			/**< mean (sum = mean * count + rem) */
+	int32			rem;			/**< remainder of mean (0..count-1) */
+	int32			ewma;			/**< EWMA * EWMA_SCALE */
+	int32			ewmaValid;		/**< EWMA initialized */
+	int32			last;			/**< latest value */
+	u_int32			tick;			/**< OSS tick of latest value */
+} LM63_ACC;
+
+/** sample FIFO entry */
+typedef struct {
+	u_int32			time;			/**< sample time [ms] */
+	int32			ch;				/**< channel */
+	int32			value;			/**< channel value */
+} FIFO_ENTRY;
+
+/** SMBus transaction context (see SmbRetry()) */
+typedef struct {
+	volatile u_int32 locked;		/**< access granted (call context) */
+	u_int32			start;			/**< OSS tick of access start (deadline) */
+	u_int32			xfers;			/**< transactions (see XferMerge()) */
+	u_int32			xferBytes;		/**< data bytes transferred */
+	u_int32			xferErrors;		/**< failed transactions */
+	u_int32			xferRetries;	/**< retries done */
+	u_int32			xferDeadline;	/**< retries refused by the deadline */
+} LM63_XFER;
+
+/** sensor of the aggregator (sensor 0 is the device itself) */
+typedef struct {
+	SMB_HANDLE		*smbH;			/**< ptr to SMB_HANDLE struct */
+	u_int32			busNbr;			/**< SMBus bus number */
+	u_int16			smbAddr;		/**< SMB address of LM63 */
+	u_int32			wordRead;		/**< use SMBus word read for tach count */
+} LM63_SENSOR;
+
+/** device context saved for warm attach */
+typedef struct {
+	SMB_HANDLE		*smbH;			/**< SMBus of LM63 (0=unused) */
+	u_int16			smbAddr;		/**< SMB address of LM63 */
+	u_int8			pwmRpm;			/**< LM63_PWM_RPM */
+	u_int8			pwmValue;		/**< LM63_PWM_VALUE (if writable) */
+	u_int8			pwmFrequ;		/**< LM63_PWM_FREQU */
+	u_int32			convPeriod;		/**< conversion period [ms] */
+	u_int32			wordRead;		/**< SMBus word read usable */
+	u_int32			lutValid;		/**< lookup table shadow valid */
+	u_int8			lutHys;			/**< LM63_LOOKUP_HYS */
+	u_int8			lutTemp[LUT_NUM];	/**< LM63_LOOKUP_TBL_TEMP(n) */
+	u_int8			lutPwm[LUT_NUM];	/**< LM63_LOOKUP_TBL_PWM(n) */
+} LM63_CTX;
+
+/** hardware limit register (pair) */
+typedef struct {
+	int32			code;			/**< getstat/setstat code */
+	const char		*key;			/**< descriptor key */
+	int32			type;			/**< LIM_xxx */
+	u_int8			reg;			/**< register (MSB or single) */
+	u_int8			reg2;			/**< second register (LSB) */
+} LM63_LIMIT;
+
 /** low-level handle */
 typedef struct {
 	/* general */
@@ -81,6 +240,92 @@ typedef struct {
 	u_int16			smbAddr;		/**< SMB address of LM63 */
 	u_int32			tachPuls;		/**< pulse per revolution fan tachometer */
 	int32			rmtTempOff;		/**< remote temp offset [C] */
+	/* register shadow */
+	LM63_SHADOW		shadow[SHADOW_NUM];	/**< measurement register shadow */
+	u_int32			tickRate;		/**< OSS ticks per second */
+	u_int32			usPerTick;		/**< OSS tick period [us] */
+	u_int32			convPeriod;		/**< conversion period [ms] */
+	u_int32			coalesceWin;	/**< reuse window of device reads [ms] */
+	u_int32			coalesced;		/**< device reads saved by the shadow
+										 (approximate, see ReadFast()) */
+	u_int32			cacheBypass;	/**< always read from device */
+	u_int32			wordRead;		/**< use SMBus word read for tach count */
+	u_int32			oneShot;		/**< standby, convert on demand */
+	u_int32			tempUnit;		/**< temperature unit (LM63_TEMP_UNIT) */
+	/* bus access */
+	OSS_SEM_HANDLE	*busSem;		/**< bus access lock (see BusLock()) */
+	LM63_XFER		xfer;			/**< transactions with bus access granted */
+	OSS_SEM_HANDLE	*callSem;		/**< serializes setstat calls */
+	OSS_SEM_HANDLE	*sweepSem;		/**< serializes sensor sweeps */
+	/* hardware init */
+	volatile u_int32 hwReady;		/**< hardware programmed */
+	/* performance counters (SMBus counters updated with bus access granted) */
+	struct LM63_PERF *perf;			/**< counters and latency histograms
+										 (allocated behind the handle) */
+	/* channel statistics (updated with bus access granted) */
+	LM63_ACC		acc[ACC_NUM];	/**< statistics accumulators */
+	u_int32			accStart;		/**< OSS tick of statistics reset */
+	u_int32			ewmaTau;		/**< EWMA time constant [ms] */
+	/* SMBus transaction layer */
+	u_int32			smbRetry;		/**< max. retries per transaction */
+	u_int32			smbRetryDelay;	/**< first retry delay [ms] */
+	u_int32			smbDeadline;	/**< max. bus time per call [ms] (0=none) */
+	u_int32			initDefer;		/**< program hardware on first access */
+	u_int32			initVerify;		/**< write only differing registers */
+	u_int32			initAlert;		/**< ALERT_ENABLE from descriptor */
+	u_int32			initOneShot;	/**< CONV_MODE from descriptor */
+	int32			initSaved;		/**< SMBus transactions saved (net) */
+	u_int32			initTime;		/**< time of hardware init [ms] */
+	u_int32			warmAttach;		/**< reuse context of previous session */
+	u_int32			warm;			/**< attached to configured device */
+	/* published shadow (lock-free readers) */
+	volatile u_int32 pubSeq;		/**< sequence count (odd: update running) */
+	volatile LM63_SHADOW pub[SHADOW_NUM];	/**< copy of shadow at BusUnlock() */
+	/* periodic sampler */
+	OSS_ALARM_HANDLE *alarmHdl;		/**< sampler alarm handle */
+	u_int32			smplRun;		/**< sampler running */
+	u_int32			alarmPeriod;	/**< alarm period [ms] */
+	u_int32			smplPeriod[CH_NUMBER];	/**< sample period [ms] (0=off) */
+	int32			smplDue[CH_NUMBER];		/**< time until next sample [ms] */
+	volatile u_int32 smplPend[CH_NUMBER];	/**< sample due (set by alarm) */
+	u_int32			smplMissed;		/**< sample periods missed (sample still due) */
+	/* sample FIFO (producer: sampler, consumer: LM63_BLK_FIFO) */
+	FIFO_ENTRY		fifo[FIFO_SIZE];	/**< sample FIFO */
+	volatile u_int32 fifoIn;		/**< write index (free running) */
+	volatile u_int32 fifoOut;		/**< read index (free running) */
+	u_int32			fifoOverflow;	/**< samples lost due to full FIFO */
+	u_int32			fifoHwm;		/**< high-watermark level (0=off) */
+	u_int32			fifoHwmSent;	/**< high-watermark signal sent */
+	OSS_SIG_HANDLE	*fifoSigHdl;	/**< high-watermark signal handle */
+	OSS_SEM_HANDLE	*fifoSem;		/**< signaled by the sampler on new sample */
+	int32			fifoWait;		/**< max. wait for a sample [ms] (0=none) */
+	/* deadband (updated by the sampler with bus access granted) */
+	u_int32			dbBand[CH_NUMBER];		/**< min. change to report (0=off) */
+	u_int32			dbSilence[CH_NUMBER];	/**< max. time without report [ms] */
+	int32			dbLast[CH_NUMBER];		/**< last reported value */
+	u_int32			dbTime[CH_NUMBER];		/**< time of last report [ms] */
+	int32			dbValid[CH_NUMBER];		/**< last reported value valid */
+	u_int32			dbSuppressed;	/**< samples suppressed by the deadband */
+	u_int32			baseTick;		/**< OSS tick at init (sample time 0) */
+	/* ALERT */
+	u_int32			alertEnable;	/**< ALERT handling enabled */
+	u_int32			alertMask;		/**< masked ALERT causes */
+	volatile u_int32 alertPending;	/**< ALERT not yet serviced */
+	volatile u_int32 alertLatch;	/**< latched ALERT causes */
+	OSS_SIG_HANDLE	*alertSigHdl;	/**< ALERT signal handle */
+	/* PWM */
+	u_int8			pwmRpm;			/**< shadow of LM63_PWM_RPM */
+	u_int8			pwmValue;		/**< shadow of LM63_PWM_VALUE (if writable) */
+	u_int8			pwmFrequ;		/**< shadow of LM63_PWM_FREQU */
+	/* lookup table */
+	u_int32			lutValid;		/**< lookup table shadow valid */
+	u_int8			lutHys;			/**< shadow of LM63_LOOKUP_HYS */
+	u_int8			lutTemp[LUT_NUM];	/**< shadow of LM63_LOOKUP_TBL_TEMP(n) */
+	u_int8			lutPwm[LUT_NUM];	/**< shadow of LM63_LOOKUP_TBL_PWM(n) */
+	/* aggregator */
+	u_int32			sensorNum;		/**< number of sensors (incl. sensor 0) */
+	LM63_SENSOR		sensor[SENSOR_MAX];	/**< sensors (descriptor order) */
+	u_int8			sweep[SENSOR_MAX];	/**< sensor indices ordered by bus */
 } LL_HANDLE;
 
 /* include files which need LL_HANDLE */
@@ -89,6 +334,34 @@ typedef struct {
 
 static const char IdentString[]=MENT_XSTR(MAK_REVISION);
 
+/** device contexts of closed sessions (warm attach) */
+static LM63_CTX G_ctx[CTX_MAX];
+
+/** hardware limit registers */
+static const LM63_LIMIT G_limit[] = {
+	{ LM63_LIM_TEMP_HIGH,	"LIM_TEMP_HIGH",	LIM_TEMP,
+	  LM63_TEMP_HIGH,			0 },
+	{ LM63_LIM_RMT_HIGH,	"LIM_RMT_HIGH",		LIM_RMTTEMP,
+	  LM63_RMTTEMP_HIGH_MSB,	LM63_RMTTEMP_HIGH_LSB },
+	{ LM63_LIM_RMT_LOW,		"LIM_RMT_LOW",		LIM_RMTTEMP,
+	  LM63_RMTTEMP_LOW_MSB,		LM63_RMTTEMP_LOW_LSB },
+	{ LM63_LIM_RMT_TCRIT,	"LIM_RMT_TCRIT",	LIM_TEMP,
+	  LM63_RMTTEMP_TCRIT_SET,	0 },
+	{ LM63_LIM_RMT_TCRIT_HYS, "LIM_RMT_TCRIT_HYS", LIM_HYS,
+	  LM63_RMTTEMP_TCRIT_HYS,	0 },
+	{ LM63_LIM_FANSPEED,	"LIM_FANSPEED",		LIM_TACH,
+	  LM63_TACH_LIMIT_MSB,		LM63_TACH_LIMIT_LSB }
+};
+#define LIMIT_NUM	(sizeof(G_limit)/sizeof(LM63_LIMIT))	/**< Number of limits */
+
+/** shadowed register (pair) of each channel */
+static const int32 G_chShadow[CH_NUMBER] = {
+	SHADOW_TEMP,		/* LM63_CH_TEMP */
+	SHADOW_RMTTEMP,		/* LM63_CH_RMTTEMP */
+	SHADOW_TACH,		/* LM63_CH_FANSPEED */
+	SHADOW_NONE			/* LM63_CH_PWM */
+};
+
 /*-----------------------------------------+
 |  PROTOTYPES                              |
 +-----------------------------------------*/
@@ -117,6 +390,212 @@ static int32 ReadValue(
    LL_HANDLE    *llHdl,
    int32		ch,
    int32		*valueP);
+static int32 ReadSnapshot(
+   LL_HANDLE    *llHdl,
+   int32		nbrCh,
+   int32		*bufP);
+static void DecodeValue(
+   LL_HANDLE    *llHdl,
+   int32		ch,
+   u_int16		word,
+   int32		*valueP);
+static int32 FetchRaw(
+   LL_HANDLE    *llHdl,
+   int32		idx,
+   u_int16		*rawP);
+static int32 ReadRaw(
+   LL_HANDLE    *llHdl,
+   int32		idx,
+   u_int16		*rawP);
+static int32 ShadowValid(
+   LL_HANDLE    *llHdl,
+   const LM63_SHADOW *shP);
+static void Publish(
+   LL_HANDLE    *llHdl);
+static int32 PubRead(
+   LL_HANDLE    *llHdl,
+   LM63_SHADOW	*shP);
+static int32 ReadFast(
+   LL_HANDLE    *llHdl,
+   int32		first,
+   int32		nbrCh,
+   int32		*bufP);
+static u_int32 PerfTime(
+   LL_HANDLE    *llHdl);
+static void PerfHist(
+   LM63_HIST	*histP,
+   u_int32		us);
+static int32 DivFloor(
+   int32		a,
+   int32		b,
+   int32		*remP);
+static void StatAdd(
+   LL_HANDLE    *llHdl,
+   int32		idx,
+   u_int16		raw);
+static void StatGet(
+   LL_HANDLE    *llHdl,
+   LM63_STATS	*statsP,
+   int32		reset);
+static void StatClear(
+   LL_HANDLE    *llHdl,
+   int32		ch);
+static int32 SmbTransient(
+   int32		error);
+static int32 SmbRetry(
+   LL_HANDLE    *llHdl,
+   LM63_XFER	*xfer,
+   int32		error,
+   u_int32		n);
+static int32 SmbReadByte(
+   LL_HANDLE    *llHdl,
+   LM63_XFER	*xfer,
+   SMB_HANDLE	*smbH,
+   u_int16		smbAddr,
+   u_int8		reg,
+   u_int8		*valP);
+static int32 SmbReadWord(
+   LL_HANDLE    *llHdl,
+   LM63_XFER	*xfer,
+   SMB_HANDLE	*smbH,
+   u_int16		smbAddr,
+   u_int8		reg,
+   u_int16		*valP);
+static int32 SmbWriteByte(
+   LL_HANDLE    *llHdl,
+   LM63_XFER	*xfer,
+   SMB_HANDLE	*smbH,
+   u_int16		smbAddr,
+   u_int8		reg,
+   u_int8		val);
+static int32 ReadReg(
+   LL_HANDLE    *llHdl,
+   u_int8		reg,
+   u_int8		*valP);
+static int32 ReadRegWord(
+   LL_HANDLE    *llHdl,
+   u_int8		reg,
+   u_int16		*valP);
+static int32 WriteReg(
+   LL_HANDLE    *llHdl,
+   u_int8		reg,
+   u_int8		val);
+static u_int32 ElapsedMs(
+   LL_HANDLE    *llHdl,
+   u_int32		tick);
+static u_int32 ConvPeriodMs(
+   u_int8		convRate);
+static int32 BusLock(
+   LL_HANDLE    *llHdl);
+static void BusUnlock(
+   LL_HANDLE    *llHdl);
+static void XferMerge(
+   LL_HANDLE    *llHdl,
+   LM63_XFER	*xfer);
+static int32 SamplerStart(
+   LL_HANDLE    *llHdl);
+static int32 SamplerStop(
+   LL_HANDLE    *llHdl);
+static void SamplerAlarm(
+   void			*arg);
+static void SamplerService(
+   LL_HANDLE    *llHdl);
+static int32 SamplerPending(
+   LL_HANDLE    *llHdl);
+static void FifoPut(
+   LL_HANDLE    *llHdl,
+   int32		ch,
+   int32		value);
+static int32 FifoGet(
+   LL_HANDLE    *llHdl,
+   LM63_SAMPLE	*bufP,
+   u_int32		max);
+static int32 FifoWait(
+   LL_HANDLE    *llHdl,
+   int32		timeout,
+   u_int32		level);
+static int32 DeadbandPass(
+   LL_HANDLE    *llHdl,
+   int32		ch,
+   int32		value);
+static int32 AlertSetup(
+   LL_HANDLE    *llHdl,
+   u_int32		enable);
+static void AlertCb(
+   void			*arg);
+static u_int8 AlertService(
+   LL_HANDLE    *llHdl);
+static u_int8 AlertLatch(
+   LL_HANDLE    *llHdl,
+   u_int16		status,
+   u_int32		sig);
+static int32 ConvModeSet(
+   LL_HANDLE    *llHdl,
+   u_int32		oneShot);
+static int32 OneShot(
+   LL_HANDLE    *llHdl);
+static const LM63_LIMIT* LimitFind(
+   int32		code);
+static int32 LimitSteps(
+   int32		value,
+   u_int32		unit,
+   int32		step,
+   int32		min,
+   int32		max,
+   int32		*stepsP);
+static int32 LimitSet(
+   LL_HANDLE    *llHdl,
+   const LM63_LIMIT *limP,
+   int32		value,
+   u_int32		init);
+static int32 LimitGet(
+   LL_HANDLE    *llHdl,
+   const LM63_LIMIT *limP,
+   int32		*valueP);
+static int32 PwmRead(
+   LL_HANDLE    *llHdl,
+   int32		*valueP);
+static int32 PwmWrite(
+   LL_HANDLE    *llHdl,
+   int32		value);
+static int32 PwmProgram(
+   LL_HANDLE    *llHdl,
+   u_int32		enable);
+static int32 LutLoad(
+   LL_HANDLE    *llHdl);
+static int32 LutSet(
+   LL_HANDLE    *llHdl,
+   const LM63_LUT *lutP);
+static int32 LutGet(
+   LL_HANDLE    *llHdl,
+   LM63_LUT		*lutP);
+static int32 SensorSetup(
+   LL_HANDLE    *llHdl,
+   LM63_SENSOR	*sensP);
+static int32 SensorRead(
+   LL_HANDLE    *llHdl,
+   LM63_XFER	*xfer,
+   LM63_SENSOR	*sensP,
+   LM63_SENSOR_VAL *valP);
+static int32 SensorSweep(
+   LL_HANDLE    *llHdl,
+   LM63_SENSOR_VAL *bufP,
+   u_int32		max,
+   u_int32		*numP);
+static int32 HwReady(
+   LL_HANDLE    *llHdl);
+static int32 HwInit(
+   LL_HANDLE    *llHdl);
+static int32 HwProgram(
+   LL_HANDLE    *llHdl);
+static int32 CtxRestore(
+   LL_HANDLE    *llHdl);
+static void CtxSave(
+   LL_HANDLE    *llHdl);
+static int32 InitReg(
+   LL_HANDLE    *llHdl,
+   u_int8		reg,
+   u_int8		val);
 
 /****************************** LM63_GetEntry ********************************/
 /** Initialize driver's jump table
@@ -170,9 +649,9 @@ static int32 LM63_Init(
 {
     LL_HANDLE	*llHdl = NULL;
     u_int32		gotsize, smbBusNbr;
-    int32		error;
-    u_int32		value;
-	u_int8		pwmRpm;
+    int32		error, ch;
+    u_int32		value, n, i;
+	LM63_SENSOR	*sensP;
 
     /*------------------------------+
     |  prepare the handle           |
@@ -181,7 +660,8 @@ static int32 LM63_Init(
 
 	/* alloc */
     if((llHdl = (LL_HANDLE*)OSS_MemGet(
-    				osHdl, sizeof(LL_HANDLE), &gotsize)) == NULL)
+    				osHdl, sizeof(LL_HANDLE) + sizeof(LM63_PERF),
+    				&gotsize)) == NULL)
        return(ERR_OSS_MEM_ALLOC);
 
 	/* clear */
@@ -189,6 +669,7 @@ static int32 LM63_Init(
 
 	/* init */
     llHdl->memAlloc   = gotsize;
+    llHdl->perf       = (LM63_PERF*)(llHdl + 1);
     llHdl->osHdl      = osHdl;
     llHdl->irqHdl     = irqHdl;
 
@@ -216,6 +697,22 @@ static int32 LM63_Init(
     if((error = DESC_Init(descP, osHdl, &llHdl->descHdl)))
 		return( Cleanup(llHdl,error) );
 
+	/* setstat call lock (LL_LOCK_NONE) */
+    if((error = OSS_SemCreate(osHdl, OSS_SEM_BIN, 1, &llHdl->callSem)))
+		return( Cleanup(llHdl,error) );
+
+	/* bus access lock */
+    if((error = OSS_SemCreate(osHdl, OSS_SEM_BIN, 1, &llHdl->busSem)))
+		return( Cleanup(llHdl,error) );
+
+	/* sensor sweep lock */
+    if((error = OSS_SemCreate(osHdl, OSS_SEM_BIN, 1, &llHdl->sweepSem)))
+		return( Cleanup(llHdl,error) );
+
+	/* sample FIFO wait (LM63_FIFO_WAIT) */
+    if((error = OSS_SemCreate(osHdl, OSS_SEM_BIN, 0, &llHdl->fifoSem)))
+		return( Cleanup(llHdl,error) );
+
     /* DEBUG_LEVEL_DESC */
     if((error = DESC_GetUInt32(llHdl->descHdl, OSS_DBG_DEFAULT,
 								&value, "DEBUG_LEVEL_DESC")) &&
@@ -248,7 +745,7 @@ static int32 LM63_Init(
 								&llHdl->tachPuls, "TACH_PULSE")) &&
 		error != ERR_DESC_KEY_NOTFOUND)
 		return( Cleanup(llHdl,error) );
-	if( (llHdl->tachPuls < 1) && (llHdl->tachPuls > 3) ){
+	if( (llHdl->tachPuls < 1) || (llHdl->tachPuls > 3) ){
 		return( Cleanup(llHdl,ERR_LL_DESC_PARAM) );
 	}
 
@@ -258,83 +755,159 @@ static int32 LM63_Init(
 		error != ERR_DESC_KEY_NOTFOUND)
 		return( Cleanup(llHdl,error) );
 
-    /*------------------------------+
-    |  init hardware                |
-    +------------------------------*/
-	if((error = OSS_GetSmbHdl( llHdl->osHdl, smbBusNbr, (void**)&llHdl->smbH) ))
+    /* SMB_WORD_READ */
+    if((error = DESC_GetUInt32(llHdl->descHdl, TRUE,
+								&llHdl->wordRead, "SMB_WORD_READ")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
 		return( Cleanup(llHdl,error) );
 
-#if 0
-	/* just for debugging - dump all LM63 registers */
-	{
-	u_int8	regVal;
-    int32	regOff;
+    /* SMB_RETRY */
+    if((error = DESC_GetUInt32(llHdl->descHdl, SMB_RETRY_DEF,
+								&llHdl->smbRetry, "SMB_RETRY")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
 
-	for( regOff=0; regOff<=0xff; regOff++ ){
-		ReadByteData( llHdl->smbH, 0, llHdl->smbAddr, (u_int8)regOff, &regVal );
-		DBGWRT_2((DBH, "LM63 regOff=0x%02x : regVal=0x%02x\n", regOff, regVal));
-	}
-	}
-#endif
+    /* SMB_RETRY_DELAY */
+    if((error = DESC_GetUInt32(llHdl->descHdl, SMB_RETRY_DELAY_DEF,
+								&llHdl->smbRetryDelay, "SMB_RETRY_DELAY")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
 
-	/*
-	 * PWM and RPM register:
-	 *   bit - value: used configuration
-	 *   5   -  1: the PWM Value (register 4C) and the Lookup Table (50 5F) are read/write enabled
-	 *   4   -  0: the PWM output pin will be 0 V for fan OFF and open for fan ON
-	 *   3   -  1: master PWM clock is 1.4 kHz
-	 *   2   -  0: unused
-	 *   1:0 - 10: most accurate readings, FFFF reading when under minimum detectable RPM
-	 */
-	pwmRpm = 0x2a;
-	if( (error = llHdl->smbH->WriteByteData( llHdl->smbH, 0, llHdl->smbAddr,
-							  LM63_PWM_RPM, pwmRpm )) )
+    /* SMB_DEADLINE */
+    if((error = DESC_GetUInt32(llHdl->descHdl, SMB_DEADLINE_DEF,
+								&llHdl->smbDeadline, "SMB_DEADLINE")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
 		return( Cleanup(llHdl,error) );
 
-	/*
-	 * Fan Spin-Up Config register:
-	 *   use POR value
-	 */
-	if( (error = llHdl->smbH->WriteByteData( llHdl->smbH, 0, llHdl->smbAddr,
-							  LM63_FAN_SPINUP_CFG, 0x3F )) )
+    /* EWMA_TAU */
+    if((error = DESC_GetUInt32(llHdl->descHdl, EWMA_TAU_DEF,
+								&llHdl->ewmaTau, "EWMA_TAU")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
 		return( Cleanup(llHdl,error) );
+	if( (llHdl->ewmaTau < 1) || (llHdl->ewmaTau > EWMA_TAU_MAX) )
+		return( Cleanup(llHdl,ERR_LL_DESC_PARAM) );
 
-	/*
-	 * PWM Frequency register:
-	 *   use POR value
-	 */
-	if( (error = llHdl->smbH->WriteByteData( llHdl->smbH, 0, llHdl->smbAddr,
-							  LM63_PWM_FREQU, 0x17 )) )
+    /* ALERT_ENABLE */
+    if((error = DESC_GetUInt32(llHdl->descHdl, FALSE,
+								&llHdl->initAlert, "ALERT_ENABLE")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
 		return( Cleanup(llHdl,error) );
 
-	/*
-	 * PWM Value register:
-	 *   use POR value
-	 */
-	if( (error = llHdl->smbH->WriteByteData( llHdl->smbH, 0, llHdl->smbAddr,
-							  LM63_PWM_VALUE, 0x00 )) )
+    /* INIT_DEFER */
+    if((error = DESC_GetUInt32(llHdl->descHdl, FALSE,
+								&llHdl->initDefer, "INIT_DEFER")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
 		return( Cleanup(llHdl,error) );
 
-	/*
-	 * PWM and RPM register:
-	 *   bit - value: used configuration
-	 *   5   -  0: the PWM Value (register 4C) and the Lookup Table (50 5F) are read-only
-	 */
-	pwmRpm &= ~0x20;
-	if( (error = llHdl->smbH->WriteByteData( llHdl->smbH, 0, llHdl->smbAddr,
-							  LM63_PWM_RPM, pwmRpm )) )
+    /* WARM_ATTACH */
+    if((error = DESC_GetUInt32(llHdl->descHdl, FALSE,
+								&llHdl->warmAttach, "WARM_ATTACH")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+    /* INIT_VERIFY */
+    if((error = DESC_GetUInt32(llHdl->descHdl, FALSE,
+								&llHdl->initVerify, "INIT_VERIFY")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+    /* SENSOR_NUM */
+    if((error = DESC_GetUInt32(llHdl->descHdl, 1,
+								&llHdl->sensorNum, "SENSOR_NUM")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+	if( (llHdl->sensorNum < 1) || (llHdl->sensorNum > SENSOR_MAX) )
+		return( Cleanup(llHdl,ERR_LL_DESC_PARAM) );
+
+    /* TEMP_UNIT */
+    if((error = DESC_GetUInt32(llHdl->descHdl, LM63_UNIT_DEG,
+								&llHdl->tempUnit, "TEMP_UNIT")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+	if( llHdl->tempUnit > LM63_UNIT_MILLIDEG )
+		return( Cleanup(llHdl,ERR_LL_DESC_PARAM) );
+
+    /* CONV_MODE */
+    if((error = DESC_GetUInt32(llHdl->descHdl, 0,
+								&llHdl->initOneShot, "CONV_MODE")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+    /* ALERT_MASK */
+    if((error = DESC_GetUInt32(llHdl->descHdl, 0x00,
+								&llHdl->alertMask, "ALERT_MASK")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+	llHdl->alertMask &= LM63_ALERT_ALL;
+
+    /* SMPL_PERIOD_n */
+	for( ch=0; ch<CH_NUMBER; ch++ ){
+		if( G_chShadow[ch] == SHADOW_NONE )
+			continue;
+		if((error = DESC_GetUInt32(llHdl->descHdl, 0,
+									&llHdl->smplPeriod[ch], "SMPL_PERIOD_%d", ch)) &&
+			error != ERR_DESC_KEY_NOTFOUND)
+			return( Cleanup(llHdl,error) );
+
+		/* DEADBAND_n */
+		if((error = DESC_GetUInt32(llHdl->descHdl, 0,
+									&llHdl->dbBand[ch], "DEADBAND_%d", ch)) &&
+			error != ERR_DESC_KEY_NOTFOUND)
+			return( Cleanup(llHdl,error) );
+
+		/* SILENCE_MAX_n */
+		if((error = DESC_GetUInt32(llHdl->descHdl, 0,
+									&llHdl->dbSilence[ch], "SILENCE_MAX_%d", ch)) &&
+			error != ERR_DESC_KEY_NOTFOUND)
+			return( Cleanup(llHdl,error) );
+	}
+
+    /*------------------------------+
+    |  init hardware                |
+    +------------------------------*/
+	if((error = OSS_GetSmbHdl( llHdl->osHdl, smbBusNbr, (void**)&llHdl->smbH) ))
 		return( Cleanup(llHdl,error) );
 
 	/*
-	 * Remote temp offset:
+	 * Aggregator:
+	 *   sensor 0 is the device itself, sensor n is read from the
+	 *   SENSOR_n descriptor directory
 	 */
-	if( (error = llHdl->smbH->WriteByteData( llHdl->smbH, 0, llHdl->smbAddr,
-							  LM63_RMTTEMP_OFF_LSB, 0 )) )
-		return( Cleanup(llHdl,error) );
+	llHdl->sensor[0].smbH    = llHdl->smbH;
+	llHdl->sensor[0].busNbr  = smbBusNbr;
+	llHdl->sensor[0].smbAddr = llHdl->smbAddr;
+
+	for( n=1; n<llHdl->sensorNum; n++ ){
+		sensP = &llHdl->sensor[n];
+
+		if( (error = DESC_GetUInt32( llHdl->descHdl, 0, &sensP->busNbr,
+									 "SENSOR_%d/SMB_BUSNBR", n )) ||
+			(error = DESC_GetUInt32( llHdl->descHdl, 0, &value,
+									 "SENSOR_%d/SMB_DEVADDR", n )) )
+			return( Cleanup(llHdl,error) );
+		sensP->smbAddr = (u_int16)value;
+
+		if( (error = OSS_GetSmbHdl( llHdl->osHdl, sensP->busNbr,
+									(void**)&sensP->smbH )) )
+			return( Cleanup(llHdl,error) );
+	}
+
+	/* sweep order: sensors on the same bus back to back */
+	for( n=0; n<llHdl->sensorNum; n++ ){
+		for( i=n; (i>0) &&
+				 (llHdl->sensor[llHdl->sweep[i-1]].busNbr >
+				  llHdl->sensor[n].busNbr); i-- )
+			llHdl->sweep[i] = llHdl->sweep[i-1];
+		llHdl->sweep[i] = (u_int8)n;
+	}
+
+	llHdl->tickRate  = OSS_TickRateGet( llHdl->osHdl );
+	llHdl->baseTick  = OSS_TickGet( llHdl->osHdl );
+	llHdl->accStart  = llHdl->baseTick;
+	llHdl->usPerTick = 1000000 / llHdl->tickRate;
 
-	if( (error = llHdl->smbH->WriteByteData( llHdl->smbH, 0, llHdl->smbAddr,
-							  LM63_RMTTEMP_OFF_MSB,
-							  (u_int8)llHdl->rmtTempOff)) )
+	/* program hardware now or on first access */
+	if( !llHdl->initDefer && (error = HwReady( llHdl )) )
 		return( Cleanup(llHdl,error) );
 
 	*llHdlP = llHdl;	/* set low-level driver handle */
@@ -363,6 +936,14 @@ static int32 LM63_Exit(
     /*------------------------------+
     |  de-init hardware             |
     +------------------------------*/
+	SamplerStop( llHdl );
+	AlertSetup( llHdl, FALSE );
+	/* free-running converter for the lookup table */
+	ConvModeSet( llHdl, FALSE );
+
+	/* keep context for next session */
+	if( llHdl->warmAttach && llHdl->hwReady )
+		CtxSave( llHdl );
 
     /*------------------------------+
     |  clean up memory               |
@@ -378,8 +959,9 @@ static int32 LM63_Exit(
  *
  *  The function reads the current value of the current channel and stores
  *  it as signed 32-bit value in valueP:
- *   ch=0,1 : temperature [degrees Celsius]
+ *   ch=0,1 : temperature [degrees Celsius] (see LM63_TEMP_UNIT)
  *   ch=2   : pulse frequency [rpm]
+ *   ch=3   : PWM duty cycle 0..100 [%]
  *
  *  \param llHdl      \IN  Low-level handle
  *  \param ch         \IN  Current channel
@@ -393,21 +975,45 @@ static int32 LM63_Read(
     int32 *valueP
 )
 {
+	u_int32 t0 = PerfTime( llHdl ), t1;
+	int32 error;
+
     DBGWRT_1((DBH, "LL - LM63_Read: ch=%d\n",ch));
 
-	return ReadValue( llHdl, ch, valueP );
+	if( (error = HwReady( llHdl )) )
+		return( error );
+
+	/* published shadow, without waiting for bus access */
+	if( !ReadFast( llHdl, ch, 1, valueP ) &&
+		!(error = BusLock( llHdl )) ){
+		if( !llHdl->oneShot || (ch == LM63_CH_PWM) ||
+			!(error = OneShot( llHdl )) ){
+			t1 = PerfTime( llHdl );
+			error = ReadValue( llHdl, ch, valueP );
+			llHdl->perf->readValue++;
+			llHdl->perf->readValueUs += PerfTime( llHdl ) - t1;
+		}
+		BusUnlock( llHdl );
+	}
+
+	t1 = PerfTime( llHdl );
+	PerfHist( &llHdl->perf->ch[ch], t1 - t0 );
+	PerfHist( &llHdl->perf->read, t1 - t0 );
+
+	return( error );
 }
 
 /****************************** LM63_Write ***********************************/
 /** Write a value to the device
  *
- *  The function is not supported and always returns an ERR_LL_ILL_FUNC error.
+ *  The function writes the PWM duty cycle [%] to the PWM channel
+ *  (LM63_CH_PWM). The other channels are input channels.
  *
  *  \param llHdl      \IN  Low-level handle
  *  \param ch         \IN  Current channel
- *  \param value      \IN  Read value
+ *  \param value      \IN  Write value
  *
- *  \return           \c ERR_LL_ILL_FUNC
+ *  \return           \c 0 On success or error code
  */
 static int32 LM63_Write(
     LL_HANDLE *llHdl,
@@ -415,9 +1021,22 @@ static int32 LM63_Write(
     int32 value
 )
 {
+	int32 error;
+
     DBGWRT_1((DBH, "LL - LM63_Write: ch=%d\n",ch));
 
-	return(ERR_LL_ILL_FUNC);
+	if( ch != LM63_CH_PWM )
+		return(ERR_LL_ILL_DIR);
+
+	if( (error = HwReady( llHdl )) )
+		return( error );
+
+	if( (error = BusLock( llHdl )) )
+		return( error );
+	error = PwmWrite( llHdl, value );
+	BusUnlock( llHdl );
+
+	return( error );
 }
 
 /****************************** LM63_SetStat *********************************/
@@ -442,10 +1061,19 @@ static int32 LM63_SetStat(
 {
 	int32 error = ERR_SUCCESS;
 	int32 value	= (int32)value32_or_64;	/* 32bit value */
+	const LM63_LIMIT *limP;
 
     DBGWRT_1((DBH, "LL - LM63_SetStat: ch=%d code=0x%04x value=0x%x\n",
 			  ch,code,value));
 
+	/* deferred hardware init */
+	if( DEV_CODE(code) && (error = HwReady( llHdl )) )
+		return( error );
+
+	if( (error = OSS_SemWait( llHdl->osHdl, llHdl->callSem,
+							  OSS_SEM_WAITFOREVER )) )
+		return( error );
+
     switch(code) {
         /*--------------------------+
         |  debug level              |
@@ -457,16 +1085,278 @@ static int32 LM63_SetStat(
         |  channel direction        |
         +--------------------------*/
         case M_LL_CH_DIR:
-			if( value != M_CH_IN )
+			if( (ch == LM63_CH_PWM) ? (value != M_CH_INOUT) : (value != M_CH_IN) )
 				error = ERR_LL_ILL_DIR;
             break;
         /*--------------------------+
+        |  register shadow bypass   |
+        +--------------------------*/
+        case LM63_CACHE_BYPASS:
+			llHdl->cacheBypass = value ? TRUE : FALSE;
+            break;
+        case LM63_COALESCE_WIN:
+			if( value < 0 ){
+				error = ERR_LL_ILL_PARAM;
+				break;
+			}
+			llHdl->coalesceWin = value;
+            break;
+        case LM63_COALESCED:
+			/* reads from the shadow count with bus access granted
+			   (lock-free reads without lock, see ReadFast()) */
+			if( (error = BusLock( llHdl )) )
+				break;
+			llHdl->coalesced = value;
+			BusUnlock( llHdl );
+            break;
+        case LM63_XFER_COUNT:
+			if( (error = BusLock( llHdl )) )
+				break;
+			llHdl->perf->xfers = value;
+			BusUnlock( llHdl );
+            break;
+        /*--------------------------+
+        |  performance counters     |
+        +--------------------------*/
+        case LM63_PERF_RESET:
+			if( (error = BusLock( llHdl )) )
+				break;
+			OSS_MemFill( llHdl->osHdl, sizeof(LM63_PERF),
+						 (char*)llHdl->perf, 0 );
+			BusUnlock( llHdl );
+            break;
+        /*--------------------------+
+        |  channel statistics       |
+        +--------------------------*/
+        case LM63_EWMA_TAU:
+			if( (value < 1) || (value > EWMA_TAU_MAX) ){
+				error = ERR_LL_ILL_PARAM;
+				break;
+			}
+			llHdl->ewmaTau = value;
+            break;
+        /*--------------------------+
+        |  sample period            |
+        +--------------------------*/
+        case LM63_SMPL_PERIOD:
+			if( G_chShadow[ch] == SHADOW_NONE ){
+				error = ERR_LL_ILL_CHAN;
+				break;
+			}
+			if( value < 0 ){
+				error = ERR_LL_ILL_PARAM;
+				break;
+			}
+			llHdl->smplPeriod[ch] = value;
+			/* restart with new period */
+			if( llHdl->smplRun )
+				error = SamplerStart( llHdl );
+            break;
+        /*--------------------------+
+        |  start/stop sampler       |
+        +--------------------------*/
+        case LM63_SMPL_START:
+			if( value )
+				error = SamplerStart( llHdl );
+			else
+				error = SamplerStop( llHdl );
+            break;
+        case LM63_SMPL_MISSED:
+			/* counted by the alarm, so it may miss a concurrent count */
+			llHdl->smplMissed = value;
+            break;
+        /*--------------------------+
+        |  conversion mode          |
+        +--------------------------*/
+        case LM63_CONV_MODE:
+			error = ConvModeSet( llHdl, value ? TRUE : FALSE );
+            break;
+        /*--------------------------+
+        |  temperature unit         |
+        +--------------------------*/
+        case LM63_TEMP_UNIT:
+			if( (value != LM63_UNIT_DEG) && (value != LM63_UNIT_MILLIDEG) ){
+				error = ERR_LL_ILL_PARAM;
+				break;
+			}
+			if( (u_int32)value == llHdl->tempUnit )
+				break;
+			/* restart statistics of the temperature channels */
+			if( (error = BusLock( llHdl )) )
+				break;
+			llHdl->tempUnit = value;
+			StatClear( llHdl, LM63_CH_TEMP );
+			StatClear( llHdl, LM63_CH_RMTTEMP );
+			llHdl->dbValid[LM63_CH_TEMP]    = FALSE;
+			llHdl->dbValid[LM63_CH_RMTTEMP] = FALSE;
+			BusUnlock( llHdl );
+            break;
+        /*--------------------------+
+        |  FIFO                     |
+        +--------------------------*/
+        case LM63_FIFO_COUNT:
+			/* discard all samples */
+			llHdl->fifoOut = llHdl->fifoIn;
+			llHdl->fifoHwmSent = FALSE;
+            break;
+        case LM63_FIFO_OVERFLOW:
+			if( (error = BusLock( llHdl )) )
+				break;
+			llHdl->fifoOverflow = 0;
+			BusUnlock( llHdl );
+            break;
+        case LM63_FIFO_HWM:
+			if( (value < 0) || (value > FIFO_SIZE) ){
+				error = ERR_LL_ILL_PARAM;
+				break;
+			}
+			llHdl->fifoHwm = value;
+			llHdl->fifoHwmSent = FALSE;
+            break;
+        case LM63_FIFO_SIG_SET:
+			if( llHdl->fifoSigHdl ){
+				error = ERR_OSS_SIG_SET;
+				break;
+			}
+			error = OSS_SigCreate( llHdl->osHdl, value, &llHdl->fifoSigHdl );
+            break;
+        case LM63_FIFO_SIG_CLR:
+			if( !llHdl->fifoSigHdl ){
+				error = ERR_OSS_SIG_CLR;
+				break;
+			}
+			error = OSS_SigRemove( llHdl->osHdl, &llHdl->fifoSigHdl );
+            break;
+        case LM63_FIFO_WAIT:
+			if( (value < 0) && (value != OSS_SEM_WAITFOREVER) ){
+				error = ERR_LL_ILL_PARAM;
+				break;
+			}
+			llHdl->fifoWait = value;
+            break;
+        /*--------------------------+
+        |  deadband                 |
+        +--------------------------*/
+        case LM63_DEADBAND:
+			if( G_chShadow[ch] == SHADOW_NONE ){
+				error = ERR_LL_ILL_CHAN;
+				break;
+			}
+			if( value < 0 ){
+				error = ERR_LL_ILL_PARAM;
+				break;
+			}
+			/* report next sample */
+			if( (error = BusLock( llHdl )) )
+				break;
+			llHdl->dbBand[ch]  = value;
+			llHdl->dbValid[ch] = FALSE;
+			BusUnlock( llHdl );
+            break;
+        case LM63_SILENCE_MAX:
+			if( G_chShadow[ch] == SHADOW_NONE ){
+				error = ERR_LL_ILL_CHAN;
+				break;
+			}
+			if( value < 0 ){
+				error = ERR_LL_ILL_PARAM;
+				break;
+			}
+			llHdl->dbSilence[ch] = value;
+            break;
+        case LM63_DEADBAND_CNT:
+			if( (error = BusLock( llHdl )) )
+				break;
+			llHdl->dbSuppressed = value;
+			BusUnlock( llHdl );
+            break;
+        /*--------------------------+
+        |  ALERT                    |
+        +--------------------------*/
+        case LM63_ALERT_ENABLE:
+			error = AlertSetup( llHdl, value ? TRUE : FALSE );
+            break;
+        case LM63_ALERT_MASKED:
+			if( value & ~LM63_ALERT_ALL ){
+				error = ERR_LL_ILL_PARAM;
+				break;
+			}
+			llHdl->alertMask = value;
+			if( llHdl->alertEnable && !(error = BusLock( llHdl )) ){
+				error = WriteReg( llHdl, LM63_ALERT_MASK, (u_int8)value );
+				BusUnlock( llHdl );
+			}
+            break;
+        case LM63_ALERT_LATCH:
+			if( (error = BusLock( llHdl )) )
+				break;
+			llHdl->alertLatch &= ~value;
+			BusUnlock( llHdl );
+            break;
+        /*--------------------------+
+        |  hardware limits          |
+        +--------------------------*/
+        case LM63_LIM_TEMP_HIGH:
+        case LM63_LIM_RMT_HIGH:
+        case LM63_LIM_RMT_LOW:
+        case LM63_LIM_RMT_TCRIT:
+        case LM63_LIM_RMT_TCRIT_HYS:
+        case LM63_LIM_FANSPEED:
+			limP = LimitFind( code );
+			if( (error = BusLock( llHdl )) )
+				break;
+			error = LimitSet( llHdl, limP, value, FALSE );
+			BusUnlock( llHdl );
+            break;
+        /*--------------------------+
+        |  PWM control              |
+        +--------------------------*/
+        case LM63_PWM_MANUAL:
+			if( (error = BusLock( llHdl )) )
+				break;
+			error = PwmProgram( llHdl, value ? TRUE : FALSE );
+			BusUnlock( llHdl );
+            break;
+        /*--------------------------+
+        |  lookup table (block)     |
+        +--------------------------*/
+        case LM63_BLK_LUT:
+		{
+			M_SG_BLOCK *blk = (M_SG_BLOCK*)value32_or_64;
+
+			if( blk->size < sizeof(LM63_LUT) ){
+				error = ERR_LL_USERBUF;
+				break;
+			}
+			if( (error = BusLock( llHdl )) )
+				break;
+			error = LutSet( llHdl, (LM63_LUT*)blk->data );
+			BusUnlock( llHdl );
+            break;
+		}
+        case LM63_ALERT_SIG_SET:
+			if( llHdl->alertSigHdl ){
+				error = ERR_OSS_SIG_SET;
+				break;
+			}
+			error = OSS_SigCreate( llHdl->osHdl, value, &llHdl->alertSigHdl );
+            break;
+        case LM63_ALERT_SIG_CLR:
+			if( !llHdl->alertSigHdl ){
+				error = ERR_OSS_SIG_CLR;
+				break;
+			}
+			error = OSS_SigRemove( llHdl->osHdl, &llHdl->alertSigHdl );
+            break;
+        /*--------------------------+
         |  unknown                  |
         +--------------------------*/
         default:
 			error = ERR_LL_UNK_CODE;
     }
 
+
+	OSS_SemSignal( llHdl->osHdl, llHdl->callSem );
 	return(error);
 }
 
@@ -497,10 +1387,17 @@ static int32 LM63_GetStat(
 
 	int32		*valueP	  = (int32*)value32_or_64P;	/* pointer to 32bit value  */
 	INT32_OR_64	*value64P = value32_or_64P;		 	/* stores 32/64bit pointer */
+	const LM63_LIMIT *limP;
+	u_int16		word;
+	u_int32		t0 = PerfTime( llHdl );
 
     DBGWRT_1((DBH, "LL - LM63_GetStat: ch=%d code=0x%04x\n",
 			  ch,code));
 
+	/* deferred hardware init */
+	if( DEV_CODE(code) && (error = HwReady( llHdl )) )
+		return( error );
+
     switch(code)
     {
         /*--------------------------+
@@ -519,7 +1416,7 @@ static int32 LM63_GetStat(
         |  channel direction        |
         +--------------------------*/
         case M_LL_CH_DIR:
-            *valueP = M_CH_IN;
+            *valueP = (ch == LM63_CH_PWM) ? M_CH_INOUT : M_CH_IN;
             break;
         /*--------------------------+
         |  channel length [bits]    |
@@ -534,8 +1431,283 @@ static int32 LM63_GetStat(
             *valueP = M_CH_ANALOG;
             break;
         /*--------------------------+
-        |   ident table pointer     |
-        |   (treat as non-block!)   |
+        |  register shadow bypass   |
+        +--------------------------*/
+        case LM63_CACHE_BYPASS:
+            *valueP = llHdl->cacheBypass;
+            break;
+        case LM63_COALESCE_WIN:
+            *valueP = llHdl->coalesceWin;
+            break;
+        case LM63_COALESCED:
+            *valueP = llHdl->coalesced;
+            break;
+        case LM63_XFER_COUNT:
+            *valueP = llHdl->perf->xfers;
+            break;
+        /*--------------------------+
+        |  channel statistics       |
+        +--------------------------*/
+        case LM63_EWMA_TAU:
+            *valueP = llHdl->ewmaTau;
+            break;
+        /*--------------------------+
+        |  device identity          |
+        +--------------------------*/
+        case LM63_SMB_DEVADDR:
+            *valueP = llHdl->smbAddr;
+            break;
+        case LM63_SMB_BUSNBR:
+            *valueP = llHdl->sensor[0].busNbr;
+            break;
+        case LM63_CONV_PERIOD:
+            *valueP = llHdl->convPeriod;
+            break;
+        /*--------------------------+
+        |  hardware init            |
+        +--------------------------*/
+        case LM63_INIT_SAVED:
+            *valueP = llHdl->initSaved;
+            break;
+        case LM63_INIT_TIME:
+            *valueP = llHdl->initTime;
+            break;
+        case LM63_WARM:
+            *valueP = llHdl->warm;
+            break;
+        /*--------------------------+
+        |  SMBus word read active   |
+        +--------------------------*/
+        case LM63_SMB_WORDREAD:
+            *valueP = llHdl->wordRead;
+            break;
+        /*--------------------------+
+        |  sample period            |
+        +--------------------------*/
+        case LM63_SMPL_PERIOD:
+            *valueP = llHdl->smplPeriod[ch];
+            break;
+        /*--------------------------+
+        |  start/stop sampler       |
+        +--------------------------*/
+        case LM63_SMPL_START:
+            *valueP = llHdl->smplRun;
+            break;
+        case LM63_SMPL_MISSED:
+            *valueP = llHdl->smplMissed;
+            break;
+        /*--------------------------+
+        |  conversion mode          |
+        +--------------------------*/
+        case LM63_CONV_MODE:
+            *valueP = llHdl->oneShot;
+            break;
+        /*--------------------------+
+        |  temperature unit         |
+        +--------------------------*/
+        case LM63_TEMP_UNIT:
+            *valueP = llHdl->tempUnit;
+            break;
+        /*--------------------------+
+        |  aggregator               |
+        +--------------------------*/
+        case LM63_SENSOR_NUM:
+            *valueP = llHdl->sensorNum;
+            break;
+        /*--------------------------+
+        |  FIFO                     |
+        +--------------------------*/
+        case LM63_FIFO_COUNT:
+            *valueP = llHdl->fifoIn - llHdl->fifoOut;
+            break;
+        case LM63_FIFO_OVERFLOW:
+            *valueP = llHdl->fifoOverflow;
+            break;
+        case LM63_FIFO_HWM:
+            *valueP = llHdl->fifoHwm;
+            break;
+        case LM63_FIFO_SIG_SET:
+            *valueP = llHdl->fifoSigHdl ? TRUE : FALSE;
+            break;
+        case LM63_FIFO_WAIT:
+            *valueP = llHdl->fifoWait;
+            break;
+        /*--------------------------+
+        |  deadband                 |
+        +--------------------------*/
+        case LM63_DEADBAND:
+            *valueP = llHdl->dbBand[ch];
+            break;
+        case LM63_SILENCE_MAX:
+            *valueP = llHdl->dbSilence[ch];
+            break;
+        case LM63_DEADBAND_CNT:
+            *valueP = llHdl->dbSuppressed;
+            break;
+        /*--------------------------+
+        |  ALERT                    |
+        +--------------------------*/
+        case LM63_ALERT_ENABLE:
+            *valueP = llHdl->alertEnable;
+            break;
+        case LM63_ALERT_MASKED:
+            *valueP = llHdl->alertMask;
+            break;
+        case LM63_ALERT_LATCH:
+			/* services a pending ALERT (see BusLock()) */
+			if( (error = BusLock( llHdl )) )
+				break;
+            *valueP = llHdl->alertLatch;
+			BusUnlock( llHdl );
+            break;
+        case LM63_ALERT_SIG_SET:
+            *valueP = llHdl->alertSigHdl ? TRUE : FALSE;
+            break;
+        /*--------------------------+
+        |  ALERT status             |
+        +--------------------------*/
+        case LM63_ALERT_STATUS:
+			if( (error = BusLock( llHdl )) )
+				break;
+			/* current status: always from the device, never the shadow */
+			error = ReadRaw( llHdl, SHADOW_ALERT, &word );
+			if( !error )
+				AlertLatch( llHdl, word, FALSE );
+			BusUnlock( llHdl );
+			if( error )
+				break;
+			*valueP = word & LM63_ALERT_ALL;
+            break;
+        /*--------------------------+
+        |  hardware limits          |
+        +--------------------------*/
+        case LM63_LIM_TEMP_HIGH:
+        case LM63_LIM_RMT_HIGH:
+        case LM63_LIM_RMT_LOW:
+        case LM63_LIM_RMT_TCRIT:
+        case LM63_LIM_RMT_TCRIT_HYS:
+        case LM63_LIM_FANSPEED:
+			limP = LimitFind( code );
+			if( (error = BusLock( llHdl )) )
+				break;
+			error = LimitGet( llHdl, limP, valueP );
+			BusUnlock( llHdl );
+            break;
+        /*--------------------------+
+        |  PWM control              |
+        +--------------------------*/
+        case LM63_PWM_MANUAL:
+            *valueP = (llHdl->pwmRpm & PWM_RPM_PROGRAM) ? TRUE : FALSE;
+            break;
+        /*--------------------------+
+        |  performance (block)      |
+        +--------------------------*/
+        case LM63_BLK_PERF:
+		{
+			M_SG_BLOCK *blk = (M_SG_BLOCK*)value32_or_64P;
+
+			if( blk->size < sizeof(LM63_PERF) ){
+				error = ERR_LL_USERBUF;
+				break;
+			}
+			OSS_MemCopy( llHdl->osHdl, sizeof(LM63_PERF),
+						 (char*)llHdl->perf, (char*)blk->data );
+			blk->size = sizeof(LM63_PERF);
+            break;
+		}
+        /*--------------------------+
+        |  statistics (block)       |
+        +--------------------------*/
+        case LM63_BLK_STATS:
+        case LM63_BLK_STATS_RST:
+		{
+			M_SG_BLOCK *blk = (M_SG_BLOCK*)value32_or_64P;
+
+			if( blk->size < sizeof(LM63_STATS) ){
+				error = ERR_LL_USERBUF;
+				break;
+			}
+			/* copy and reset without intervening acquisition */
+			if( (error = BusLock( llHdl )) )
+				break;
+			StatGet( llHdl, (LM63_STATS*)blk->data,
+					 code == LM63_BLK_STATS_RST );
+			BusUnlock( llHdl );
+			blk->size = sizeof(LM63_STATS);
+            break;
+		}
+        /*--------------------------+
+        |  sensor sweep (block)     |
+        +--------------------------*/
+        case LM63_BLK_SENSORS:
+		{
+			M_SG_BLOCK *blk = (M_SG_BLOCK*)value32_or_64P;
+			u_int32 num;
+
+			if( (error = SensorSweep( llHdl, (LM63_SENSOR_VAL*)blk->data,
+									  blk->size / sizeof(LM63_SENSOR_VAL),
+									  &num )) )
+				break;
+			blk->size = num * sizeof(LM63_SENSOR_VAL);
+            break;
+		}
+        /*--------------------------+
+        |  lookup table (block)     |
+        +--------------------------*/
+        case LM63_BLK_LUT:
+		{
+			M_SG_BLOCK *blk = (M_SG_BLOCK*)value32_or_64P;
+
+			if( blk->size < sizeof(LM63_LUT) ){
+				error = ERR_LL_USERBUF;
+				break;
+			}
+			if( (error = BusLock( llHdl )) )
+				break;
+			error = LutGet( llHdl, (LM63_LUT*)blk->data );
+			BusUnlock( llHdl );
+			if( !error )
+				blk->size = sizeof(LM63_LUT);
+            break;
+		}
+        /*--------------------------+
+        |  FIFO samples (block)     |
+        +--------------------------*/
+        case LM63_BLK_FIFO:
+		{
+			M_SG_BLOCK *blk = (M_SG_BLOCK*)value32_or_64P;
+			u_int32 level = blk->size / sizeof(LM63_SAMPLE);
+
+			/* take due samples (see BusLock()) */
+			if( SamplerPending( llHdl ) ){
+				if( (error = BusLock( llHdl )) )
+					break;
+				BusUnlock( llHdl );
+			}
+
+			/* wait for the block or the high-watermark, without blocking
+			   setstat calls */
+			if( llHdl->fifoHwm && (level > llHdl->fifoHwm) )
+				level = llHdl->fifoHwm;
+			if( level > FIFO_SIZE )
+				level = FIFO_SIZE;
+			if( llHdl->fifoWait && level &&
+				(error = FifoWait( llHdl, llHdl->fifoWait, level )) )
+				break;
+
+			/* single consumer (see LM63_FIFO_COUNT setstat) */
+			if( (error = OSS_SemWait( llHdl->osHdl, llHdl->callSem,
+									  OSS_SEM_WAITFOREVER )) )
+				break;
+			blk->size = FifoGet( llHdl, (LM63_SAMPLE*)blk->data,
+								 blk->size / sizeof(LM63_SAMPLE) )
+						* sizeof(LM63_SAMPLE);
+			OSS_SemSignal( llHdl->osHdl, llHdl->callSem );
+            break;
+		}
+        /*--------------------------+
+        |   ident table pointer     |
+        |   (treat as non-block!)   |
         +--------------------------*/
         case M_MK_BLK_REV_ID:
            *value64P = (INT32_OR_64)&llHdl->idFuncTbl;
@@ -547,16 +1719,22 @@ static int32 LM63_GetStat(
 			error = ERR_LL_UNK_CODE;
     }
 
+	PerfHist( &llHdl->perf->getStat, PerfTime( llHdl ) - t0 );
+
 	return(error);
 }
 
 /******************************* LM63_BlockRead ******************************/
 /** Read a data block from the device
  *
- *  The function reads the current value of channels 0..x where x depends on
+ *  The function reads a coherent snapshot of channels 0..x where x depends on
  *  the buffer size n. For each channel to read the buffer must provide four
  *  bytes.
  *
+ *  All values of the snapshot are taken either from the register shadow
+ *  (same conversion period) or, if any of them is outdated, from one
+ *  uninterrupted sequence of SMBus transactions (see ReadSnapshot()).
+ *
  *                +--------------+
  *                | bytes   0..3 | channel 0
  *                +--------------+
@@ -566,8 +1744,9 @@ static int32 LM63_GetStat(
  *                +--------------+
  *
  *  The read values will be stored in the buffer as signed 32-bit values:
- *   ch=0,1 : temperature [degrees Celsius]
+ *   ch=0,1 : temperature [degrees Celsius] (see LM63_TEMP_UNIT)
  *   ch=2   : pulse frequency [rpm]
+ *   ch=3   : PWM duty cycle 0..100 [%]
  *
  *  \param llHdl       \IN  Low-level handle
  *  \param ch          \IN  Current channel
@@ -586,26 +1765,37 @@ static int32 LM63_BlockRead(
 )
 {
 	int32	status=ERR_SUCCESS;
-	int32	chan, ch2read;
+	int32	ch2read;
 	int32	*bufP = (int32*)buf;
+	u_int32	t0 = PerfTime( llHdl );
 
     DBGWRT_1((DBH, "LL - LM63_BlockRead: ch=%d, size=%d\n",ch,size));
 
 	/* return number of read bytes */
 	*nbrRdBytesP = 0;
 
+	if( (status = HwReady( llHdl )) )
+		return( status );
+
 	if ( size < (CH_NUMBER * 4) )
 		ch2read =  size / 4;
 	else
 		ch2read = CH_NUMBER;
 
-	for(chan=0; chan<ch2read; chan++) {
+	/* published shadow, without waiting for bus access */
+	if( !ReadFast( llHdl, 0, ch2read, bufP ) &&
+		!(status = BusLock( llHdl )) ){
+		if( !llHdl->oneShot || !(status = OneShot( llHdl )) )
+			status = ReadSnapshot( llHdl, ch2read, bufP );
+		BusUnlock( llHdl );
+	}
 
-		if( (status=ReadValue( llHdl, ch, bufP++ )) )
-			return status;
+	PerfHist( &llHdl->perf->blockRead, PerfTime( llHdl ) - t0 );
 
-		*nbrRdBytesP += 4;
-	}
+	if( status )
+		return status;
+
+	*nbrRdBytesP = ch2read * 4;
 
 	return(0);
 }
@@ -646,6 +1836,9 @@ static int32 LM63_BlockWrite(
  *  If the driver can detect the interrupt's cause it returns
  *  LL_IRQ_DEVICE or LL_IRQ_DEV_NOT, otherwise LL_IRQ_UNKNOWN.
  *
+ *  The LM63 ALERT is delivered via the SMB2 alert callback (see AlertCb()),
+ *  so USE_IRQ is FALSE.
+ *
  *  \param llHdl  	   \IN  Low-level handle
  *  \return LL_IRQ_DEVICE	IRQ caused by device
  *          LL_IRQ_DEV_NOT  IRQ not caused by device
@@ -758,7 +1951,7 @@ static int32 LM63_Info(
 		{
 			u_int32 *lockModeP = va_arg(argptr, u_int32*);
 
-			*lockModeP = LL_LOCK_CALL;
+			*lockModeP = LL_LOCK_NONE;
 			break;
 	    }
 		/*-------------------------------+
@@ -800,6 +1993,26 @@ static int32 Cleanup(
     /*------------------------------+
     |  close handles                |
     +------------------------------*/
+	/* clean up alarm */
+	if(llHdl->alarmHdl)
+		OSS_AlarmRemove(llHdl->osHdl, &llHdl->alarmHdl);
+
+	/* clean up signals */
+	if(llHdl->fifoSigHdl)
+		OSS_SigRemove(llHdl->osHdl, &llHdl->fifoSigHdl);
+	if(llHdl->alertSigHdl)
+		OSS_SigRemove(llHdl->osHdl, &llHdl->alertSigHdl);
+
+	/* clean up call and bus lock */
+	if(llHdl->callSem)
+		OSS_SemRemove(llHdl->osHdl, &llHdl->callSem);
+	if(llHdl->busSem)
+		OSS_SemRemove(llHdl->osHdl, &llHdl->busSem);
+	if(llHdl->sweepSem)
+		OSS_SemRemove(llHdl->osHdl, &llHdl->sweepSem);
+	if(llHdl->fifoSem)
+		OSS_SemRemove(llHdl->osHdl, &llHdl->fifoSem);
+
 	/* clean up desc */
 	if(llHdl->descHdl)
 		DESC_Exit(&llHdl->descHdl);
@@ -821,6 +2034,9 @@ static int32 Cleanup(
 
 /********************************* ReadValue *********************************/
 /** Read measured value from LM63
+ *
+ *  The raw register values are taken from the register shadow if they are
+ *  younger than one conversion period (see FetchRaw()).
  *
  *  \param llHdl      \IN  Low-level handle
  *  \param ch         \IN  Current channel
@@ -834,30 +2050,118 @@ static int32 ReadValue(
    int32		*valueP
 )
 {
-	u_int8	lowByte, highByte;
 	u_int16	word;
-	int32	error, sign, round;
+	int32	error;
+
+	if( ch == LM63_CH_PWM )
+		return( PwmRead( llHdl, valueP ) );
+
+	if( (error = FetchRaw( llHdl, G_chShadow[ch], &word )) )
+		return( error );
+
+	DecodeValue( llHdl, ch, word, valueP );
+
+	return(0);
+}
+
+/******************************** ReadSnapshot *******************************/
+/** Read coherent snapshot of channels 0..nbrCh-1
+ *
+ *  If the shadow of any requested channel is outdated, the registers of all
+ *  requested channels are read back to back in one sequence and stamped
+ *  with the same time. So all values of the snapshot belong to the same
+ *  conversion period and the registers are read with the minimum number
+ *  of SMBus transactions.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param nbrCh      \IN  Number of channels to read
+ *  \param bufP       \OUT Read values (nbrCh)
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 ReadSnapshot(
+   LL_HANDLE    *llHdl,
+   int32		nbrCh,
+   int32		*bufP
+)
+{
+	u_int16	word[CH_NUMBER];
+	u_int32	tick;
+	int32	ch, error, fresh = TRUE;
+
+	for( ch=0; ch<nbrCh; ch++ ){
+		if( (G_chShadow[ch] != SHADOW_NONE) &&
+			!ShadowValid( llHdl, &llHdl->shadow[G_chShadow[ch]] ) )
+			fresh = FALSE;
+	}
+
+	for( ch=0; ch<nbrCh; ch++ ){
+		if( G_chShadow[ch] == SHADOW_NONE )
+			continue;
+		if( fresh ){
+			word[ch] = llHdl->shadow[G_chShadow[ch]].raw;
+			llHdl->coalesced++;
+		}
+		else if( (error = ReadRaw( llHdl, G_chShadow[ch], &word[ch] )) )
+			return( error );
+	}
+
+	/* stamp snapshot with the same time */
+	if( !fresh ){
+		tick = OSS_TickGet( llHdl->osHdl );
+		for( ch=0; ch<nbrCh; ch++ ){
+			if( G_chShadow[ch] != SHADOW_NONE )
+				llHdl->shadow[G_chShadow[ch]].tick = tick;
+		}
+	}
+
+	for( ch=0; ch<nbrCh; ch++ ){
+		if( ch == LM63_CH_PWM ){
+			if( (error = PwmRead( llHdl, &bufP[ch] )) )
+				return( error );
+		}
+		else
+			DecodeValue( llHdl, ch, word[ch], &bufP[ch] );
+	}
+
+	return(0);
+}
+
+/******************************** DecodeValue ********************************/
+/** Convert raw register value to channel value
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param ch         \IN  Channel
+ *  \param word       \IN  Raw value (MSB<<8 | LSB)
+ *  \param valueP     \OUT Channel value
+ */
+static void DecodeValue(
+   LL_HANDLE    *llHdl,
+   int32		ch,
+   u_int16		word,
+   int32		*valueP
+)
+{
+	int32	sign, round;
 
 	switch( ch ){
 
-		/* local temp [C] */
+		/* local temp [C] or [mC] (1C resolution) */
 		case LM63_CH_TEMP:
-			if( (error = llHdl->smbH->ReadByteData( llHdl->smbH, 0,
-							llHdl->smbAddr, LM63_TEMP, &lowByte )) )
-				return( error );
-			*valueP = (int32)((int8)lowByte);
-			DBGWRT_2((DBH, " local temp [C] = %d\n", *valueP));
+			*valueP = (int32)((int8)word);
+			if( llHdl->tempUnit == LM63_UNIT_MILLIDEG )
+				*valueP *= 1000;
+			DBGWRT_2((DBH, " local temp = %d\n", *valueP));
 			break;
 
-		/* remote temp [C] */
+		/* remote temp [C] or [mC] (0.125C resolution) */
 		case LM63_CH_RMTTEMP:
-			if( (error = llHdl->smbH->ReadByteData( llHdl->smbH, 0,
-							llHdl->smbAddr, LM63_RMTTEMP_MSB, &highByte )) )
-				return( error );
-			if( (error = llHdl->smbH->ReadByteData( llHdl->smbH, 0,
-							llHdl->smbAddr, LM63_RMTTEMP_LSB, &lowByte )) )
-				return( error );
-			word = (u_int16)(((u_int16)highByte<<8) | lowByte);
+			if( llHdl->tempUnit == LM63_UNIT_MILLIDEG ){
+				/* 1/256C units, LSB bits 7..5 valid: 1000/256 = 125/32 */
+				*valueP = ((int32)((int16)(word & 0xffe0)) * 125) / 32;
+				DBGWRT_2((DBH, " remote temp [mC] = %d\n", *valueP));
+				break;
+			}
 
 			/* absolute temp */
 			if( word & 0x8000 ){
@@ -877,14 +2181,6 @@ static int32 ReadValue(
 
 		/* fan speed [rpm] */
 		case LM63_CH_FANSPEED:
-			if( (error = llHdl->smbH->ReadByteData( llHdl->smbH, 0,
-							llHdl->smbAddr, LM63_TACH_COUNT_MSB, &highByte )) )
-				return( error );
-			if( (error = llHdl->smbH->ReadByteData( llHdl->smbH, 0,
-							llHdl->smbAddr, LM63_TACH_COUNT_LSB, &lowByte )) )
-				return( error );
-			word = (u_int16)(((u_int16)highByte<<8) | lowByte);
-
 			if ( (word==0xffff) | (word==0) ){
 				*valueP = 0;	/* 0Hz */
 			}
@@ -894,6 +2190,2509 @@ static int32 ReadValue(
 			DBGWRT_2((DBH, " fan speed [rpm] = %d\n", *valueP));
 			break;
 		}
+}
+
+/********************************* FetchRaw **********************************/
+/** Get raw measurement register (pair) from shadow or device
+ *
+ *  The LM63 provides new measurement results only once per conversion
+ *  period. Therefore the shadowed value is returned without any SMBus
+ *  transaction if it was read from the device within the coalescing
+ *  window (default: conversion period). Otherwise (or if LM63_CACHE_BYPASS
+ *  is set) the register (pair) is read from the device and the shadow is
+ *  updated.
+ *
+ *  As the shadow is checked with bus access granted, a caller which waited
+ *  for a concurrent read of the same register gets the result of that read.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param idx        \IN  Shadow index (SHADOW_xxx)
+ *  \param rawP       \OUT Raw value (MSB<<8 | LSB)
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 FetchRaw(
+   LL_HANDLE    *llHdl,
+   int32		idx,
+   u_int16		*rawP
+)
+{
+	if( ShadowValid( llHdl, &llHdl->shadow[idx] ) ){
+		*rawP = llHdl->shadow[idx].raw;
+		llHdl->coalesced++;
+		return(0);
+	}
+
+	return( ReadRaw( llHdl, idx, rawP ) );
+}
+
+/********************************* ReadRaw ***********************************/
+/** Read raw measurement register (pair) from device and update shadow
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param idx        \IN  Shadow index (SHADOW_xxx)
+ *  \param rawP       \OUT Raw value (MSB<<8 | LSB)
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 ReadRaw(
+   LL_HANDLE    *llHdl,
+   int32		idx,
+   u_int16		*rawP
+)
+{
+	LM63_SHADOW	*shP = &llHdl->shadow[idx];
+	u_int8		lowByte = 0, highByte = 0;
+	u_int16		word;
+	int32		error;
+
+	switch( idx ){
+		case SHADOW_TEMP:
+			error = ReadReg( llHdl, LM63_TEMP, &lowByte );
+			break;
+		case SHADOW_RMTTEMP:
+			/* MSB first: reading the MSB latches the LSB */
+			if( (error = ReadReg( llHdl, LM63_RMTTEMP_MSB, &highByte )) )
+				break;
+			error = ReadReg( llHdl, LM63_RMTTEMP_LSB, &lowByte );
+			break;
+		case SHADOW_TACH:
+			/* one word transaction: LSB (0x46) and MSB (0x47) */
+			if( llHdl->wordRead ){
+				if( (error = ReadRegWord( llHdl, LM63_TACH_COUNT_LSB, &word )) )
+					break;
+				lowByte  = (u_int8)(word & 0xff);
+				highByte = (u_int8)(word >> 8);
+				break;
+			}
+			/* LSB first: reading the LSB latches the MSB */
+			if( (error = ReadReg( llHdl, LM63_TACH_COUNT_LSB, &lowByte )) )
+				break;
+			error = ReadReg( llHdl, LM63_TACH_COUNT_MSB, &highByte );
+			break;
+		case SHADOW_ALERT:
+			error = ReadReg( llHdl, LM63_ALERT_STATE, &lowByte );
+			break;
+		default:
+			error = ERR_LL_ILL_PARAM;
+	}
+
+	if( error ){
+		shP->valid = FALSE;
+		return( error );
+	}
 
+	shP->raw   = (u_int16)(((u_int16)highByte<<8) | lowByte);
+	shP->tick  = OSS_TickGet( llHdl->osHdl );
+	shP->valid = TRUE;
+
+	StatAdd( llHdl, idx, shP->raw );
+
+	*rawP = shP->raw;
 	return(0);
 }
+
+/******************************** ShadowValid ********************************/
+/** Check if shadowed register (pair) is younger than the coalescing window
+ *
+ *  A value of the periodic sampler is used up to twice its sample period,
+ *  so a failing or stalled sampler doesn't freeze the read values.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param shP        \IN  Shadow (or copy of published shadow)
+ *
+ *  \return            TRUE if shadow can be used, otherwise FALSE
+ */
+static int32 ShadowValid(
+   LL_HANDLE    *llHdl,
+   const LM63_SHADOW *shP
+)
+{
+	if( llHdl->cacheBypass || !shP->valid )
+		return( FALSE );
+
+	/* latest sample of periodic sampler */
+	if( shP->sampled )
+		return( ElapsedMs( llHdl, shP->tick ) < 2 * shP->sampled );
+
+	return( ElapsedMs( llHdl, shP->tick ) < llHdl->coalesceWin );
+}
+
+/********************************* PerfTime **********************************/
+/** Get time stamp for the performance counters
+ *
+ *  The time stamp has OSS tick resolution, unless the build provides a
+ *  finer clock with the LM63_PERF_CLOCK switch (function returning [us]).
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *
+ *  \return            time stamp [us] (wraps)
+ */
+static u_int32 PerfTime(
+   LL_HANDLE    *llHdl
+)
+{
+#ifdef LM63_PERF_CLOCK
+	return( LM63_PERF_CLOCK() );
+#else
+	return( (OSS_TickGet( llHdl->osHdl ) - llHdl->baseTick) *
+			llHdl->usPerTick );
+#endif
+}
+
+/********************************* PerfHist **********************************/
+/** Account a call in a latency histogram
+ *
+ *  The counters are updated without lock to keep the overhead negligible,
+ *  so concurrent calls may rarely lose a count.
+ *
+ *  \param histP      \IN  Histogram
+ *  \param us         \IN  Latency [us]
+ */
+static void PerfHist(
+   LM63_HIST	*histP,
+   u_int32		us
+)
+{
+	u_int32	b = 0;
+
+	/* bucket: number of significant bits */
+	while( us >> b )
+		b++;
+	if( b >= LM63_PERF_BUCKETS )
+		b = LM63_PERF_BUCKETS - 1;
+
+	histP->count++;
+	histP->sumUs += us;
+	if( us > histP->maxUs )
+		histP->maxUs = us;
+	histP->bucket[b]++;
+}
+
+/********************************* DivFloor **********************************/
+/** Integer division rounding towards minus infinity
+ *
+ *  \param a          \IN  Dividend
+ *  \param b          \IN  Divisor (>0)
+ *  \param remP       \OUT Remainder (0..b-1)
+ *
+ *  \return            quotient
+ */
+static int32 DivFloor(
+   int32		a,
+   int32		b,
+   int32		*remP
+)
+{
+	int32	q;
+
+	/* avoid implementation defined division of negative numbers */
+	if( a >= 0 )
+		q = a / b;
+	else
+		q = -((-a + b - 1) / b);
+
+	*remP = a - q * b;
+	return( q );
+}
+
+/********************************* StatAdd ***********************************/
+/** Account a device read in the channel statistics
+ *
+ *  Called for each measurement register (pair) read from the device, with
+ *  bus access granted. Reads saved by the register shadow are not counted.
+ *  All accumulators are updated in constant time:
+ *  - the mean is kept exact as mean and remainder of the sum
+ *  - the EWMA is weighted by the time since the previous read:
+ *    ewma += (value - ewma) * dt / (EWMA_TAU + dt)
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param idx        \IN  Shadow index (SHADOW_xxx)
+ *  \param raw        \IN  Raw value (MSB<<8 | LSB)
+ */
+static void StatAdd(
+   LL_HANDLE    *llHdl,
+   int32		idx,
+   u_int16		raw
+)
+{
+	LM63_ACC	*accP;
+	int32		ch, value, q, r, dt, div;
+
+	for( ch=0; ch<ACC_NUM; ch++ ){
+		if( G_chShadow[ch] == idx )
+			break;
+	}
+	if( ch == ACC_NUM )
+		return;
+
+	accP = &llHdl->acc[ch];
+	DecodeValue( llHdl, ch, raw, &value );
+
+	/* min/max/mean */
+	if( accP->count == 0 ){
+		accP->min  = value;
+		accP->max  = value;
+		accP->mean = value;
+		accP->rem  = 0;
+	}
+	else {
+		if( value < accP->min )
+			accP->min = value;
+		if( value > accP->max )
+			accP->max = value;
+		/* sum + value = (mean + q) * (count + 1) + r */
+		accP->mean += DivFloor( value - accP->mean + accP->rem,
+								(int32)accP->count + 1, &accP->rem );
+	}
+	accP->count++;
+
+	/* EWMA (fixed point) */
+	if( !accP->ewmaValid ){
+		accP->ewma = value * EWMA_SCALE;
+		accP->ewmaValid = TRUE;
+	}
+	else {
+		dt = (int32)ElapsedMs( llHdl, accP->tick );
+		if( dt > EWMA_DT_MAX )
+			dt = EWMA_DT_MAX;
+		div = (int32)llHdl->ewmaTau + dt;
+		/* split to avoid overflow: r * dt < 2^31 */
+		q = DivFloor( value * EWMA_SCALE - accP->ewma, div, &r );
+		accP->ewma += q * dt + (r * dt) / div;
+	}
+
+	accP->last = value;
+	accP->tick = OSS_TickGet( llHdl->osHdl );
+}
+
+/********************************* StatGet ***********************************/
+/** Get channel statistics
+ *
+ *  Called with bus access granted, so the copy is consistent and no device
+ *  read is lost between copy and reset. EWMA and latest value are kept
+ *  on reset.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param statsP     \OUT Statistics
+ *  \param reset      \IN  TRUE: reset statistics after copy
+ */
+static void StatGet(
+   LL_HANDLE    *llHdl,
+   LM63_STATS	*statsP,
+   int32		reset
+)
+{
+	LM63_ACC		*accP;
+	LM63_CH_STATS	*chP;
+	int32			ch, r;
+
+	statsP->intervalMs = ElapsedMs( llHdl, llHdl->accStart );
+
+	for( ch=0; ch<ACC_NUM; ch++ ){
+		accP = &llHdl->acc[ch];
+		chP  = &statsP->ch[ch];
+
+		chP->count = accP->count;
+		chP->min   = accP->count ? accP->min  : 0;
+		chP->max   = accP->count ? accP->max  : 0;
+		chP->mean  = accP->count ? accP->mean : 0;
+		chP->ewma  = DivFloor( accP->ewma + EWMA_SCALE/2, EWMA_SCALE, &r );
+		chP->last  = accP->last;
+
+		if( reset )
+			accP->count = 0;
+	}
+
+	if( reset )
+		llHdl->accStart = OSS_TickGet( llHdl->osHdl );
+}
+
+/******************************** StatClear **********************************/
+/** Restart statistics of a channel including EWMA (e.g. unit changed)
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param ch         \IN  Channel (< ACC_NUM)
+ */
+static void StatClear(
+   LL_HANDLE    *llHdl,
+   int32		ch
+)
+{
+	llHdl->acc[ch].count     = 0;
+	llHdl->acc[ch].ewmaValid = FALSE;
+	llHdl->acc[ch].ewma      = 0;
+	llHdl->acc[ch].last      = 0;
+}
+
+/******************************** SmbTransient *******************************/
+/** Classify SMBus error
+ *
+ *  Busy bus/controller and arbitration loss are transient. All other
+ *  errors are permanent, incl. NACK (SMB_ERR_NO_DEVICE): a NACK means an
+ *  absent or dead device, retrying it would only keep the SMBus busy up to
+ *  SMB_DEADLINE.
+ *
+ *  \param error      \IN  SMB_ERR_xxx error code
+ *
+ *  \return            TRUE if the transaction may succeed when retried
+ */
+static int32 SmbTransient(
+   int32		error
+)
+{
+	switch( error ){
+	case SMB_ERR_BUSY:
+	case SMB_ERR_COLL:
+	case SMB_ERR_CTRL_BUSY:
+		return( TRUE );
+	default:
+		return( FALSE );
+	}
+}
+
+/********************************** SmbRetry *********************************/
+/** Decide on retry of a failed SMBus transaction
+ *
+ *  Transient errors are retried up to SMB_RETRY times. The retry delay
+ *  starts with SMB_RETRY_DELAY and doubles with each retry. No retry is
+ *  done if the delay would exceed the SMB_DEADLINE bus time of the current
+ *  call (counted from getting the bus access, see BusLock()), so a call
+ *  never keeps the SMBus longer than the deadline for retries.
+ *
+ *  The retry delay sleeps (OSS_Delay()), so it must only be done in call
+ *  context. All transactions are done with an access lock held, which is
+ *  only taken in call context: the bus access lock (see BusLock()) or the
+ *  sensor sweep lock (see SensorSweep()). A transaction without it (e.g.
+ *  from a future interrupt path) is not retried.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param xfer       \IN  Transaction context
+ *  \param error      \IN  SMB_ERR_xxx error code
+ *  \param n          \IN  Retries done
+ *
+ *  \return            TRUE if the transaction shall be retried
+ */
+static int32 SmbRetry(
+   LL_HANDLE    *llHdl,
+   LM63_XFER	*xfer,
+   int32		error,
+   u_int32		n
+)
+{
+	u_int32	delay;
+
+	xfer->xferErrors++;
+
+	if( !SmbTransient( error ) || (n >= llHdl->smbRetry) )
+		return( FALSE );
+
+	/* no sleep outside call context */
+	if( !xfer->locked ){
+		DBGWRT_ERR((DBH, "*** LM63:SmbRetry: no access lock, no retry\n"));
+		return( FALSE );
+	}
+
+	delay = llHdl->smbRetryDelay << (n < SMB_BACKOFF_MAX ? n : SMB_BACKOFF_MAX);
+
+	if( llHdl->smbDeadline &&
+		(ElapsedMs( llHdl, xfer->start ) + delay >= llHdl->smbDeadline) ){
+		xfer->xferDeadline++;
+		return( FALSE );
+	}
+
+	if( delay )
+		OSS_Delay( llHdl->osHdl, delay );
+
+	xfer->xferRetries++;
+	return( TRUE );
+}
+
+/******************************** SmbReadByte ********************************/
+/** SMBus byte read transaction
+ *
+ *  All SMBus transactions of the driver go through SmbReadByte(),
+ *  SmbReadWord() and SmbWriteByte(). Failed transactions are retried
+ *  (see SmbRetry()).
+ *
+ *  The transactions are counted in the transaction context, which is
+ *  merged into LM63_BLK_PERF with the bus access lock held (see
+ *  XferMerge()). So the transaction counters are exact.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param xfer       \IN  Transaction context
+ *  \param smbH       \IN  SMBus handle
+ *  \param smbAddr    \IN  SMB address
+ *  \param reg        \IN  Register offset
+ *  \param valP       \OUT Register value
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 SmbReadByte(
+   LL_HANDLE    *llHdl,
+   LM63_XFER	*xfer,
+   SMB_HANDLE	*smbH,
+   u_int16		smbAddr,
+   u_int8		reg,
+   u_int8		*valP
+)
+{
+	u_int32	n = 0;
+	int32	error;
+
+	do {
+		xfer->xfers++;
+		if( !(error = smbH->ReadByteData( smbH, 0, smbAddr, reg, valP )) ){
+			xfer->xferBytes += 1;
+			break;
+		}
+	} while( SmbRetry( llHdl, xfer, error, n++ ) );
+
+	return( error );
+}
+
+/******************************** SmbReadWord ********************************/
+/** SMBus word read transaction
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param xfer       \IN  Transaction context
+ *  \param smbH       \IN  SMBus handle
+ *  \param smbAddr    \IN  SMB address
+ *  \param reg        \IN  Register offset of low byte
+ *  \param valP       \OUT Register values (reg+1)<<8 | (reg)
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 SmbReadWord(
+   LL_HANDLE    *llHdl,
+   LM63_XFER	*xfer,
+   SMB_HANDLE	*smbH,
+   u_int16		smbAddr,
+   u_int8		reg,
+   u_int16		*valP
+)
+{
+	u_int32	n = 0;
+	int32	error;
+
+	do {
+		xfer->xfers++;
+		if( !(error = smbH->ReadWordData( smbH, 0, smbAddr, reg, valP )) ){
+			xfer->xferBytes += 2;
+			break;
+		}
+	} while( SmbRetry( llHdl, xfer, error, n++ ) );
+
+	return( error );
+}
+
+/******************************** SmbWriteByte *******************************/
+/** SMBus byte write transaction
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param xfer       \IN  Transaction context
+ *  \param smbH       \IN  SMBus handle
+ *  \param smbAddr    \IN  SMB address
+ *  \param reg        \IN  Register offset
+ *  \param val        \IN  Register value
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 SmbWriteByte(
+   LL_HANDLE    *llHdl,
+   LM63_XFER	*xfer,
+   SMB_HANDLE	*smbH,
+   u_int16		smbAddr,
+   u_int8		reg,
+   u_int8		val
+)
+{
+	u_int32	n = 0;
+	int32	error;
+
+	do {
+		xfer->xfers++;
+		if( !(error = smbH->WriteByteData( smbH, 0, smbAddr, reg, val )) ){
+			xfer->xferBytes += 1;
+			break;
+		}
+	} while( SmbRetry( llHdl, xfer, error, n++ ) );
+
+	return( error );
+}
+
+/********************************* ReadReg ***********************************/
+/** Read one LM63 register via SMBus
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param reg        \IN  Register offset
+ *  \param valP       \OUT Register value
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 ReadReg(
+   LL_HANDLE    *llHdl,
+   u_int8		reg,
+   u_int8		*valP
+)
+{
+	return( SmbReadByte( llHdl, &llHdl->xfer, llHdl->smbH, llHdl->smbAddr,
+						 reg, valP ) );
+}
+
+/******************************** ReadRegWord ********************************/
+/** Read two consecutive LM63 registers with one SMBus word transaction
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param reg        \IN  Register offset of low byte
+ *  \param valP       \OUT Register values (reg+1)<<8 | (reg)
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 ReadRegWord(
+   LL_HANDLE    *llHdl,
+   u_int8		reg,
+   u_int16		*valP
+)
+{
+	return( SmbReadWord( llHdl, &llHdl->xfer, llHdl->smbH, llHdl->smbAddr,
+						 reg, valP ) );
+}
+
+/********************************* WriteReg **********************************/
+/** Write one LM63 register via SMBus
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param reg        \IN  Register offset
+ *  \param val        \IN  Register value
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 WriteReg(
+   LL_HANDLE    *llHdl,
+   u_int8		reg,
+   u_int8		val
+)
+{
+	return( SmbWriteByte( llHdl, &llHdl->xfer, llHdl->smbH, llHdl->smbAddr,
+						 reg, val ) );
+}
+
+/********************************* ElapsedMs *********************************/
+/** Get time elapsed since an OSS tick
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param tick       \IN  OSS tick count
+ *
+ *  \return            elapsed time [ms]
+ */
+static u_int32 ElapsedMs(
+   LL_HANDLE    *llHdl,
+   u_int32		tick
+)
+{
+	u_int32 diff = OSS_TickGet( llHdl->osHdl ) - tick;
+
+	/* avoid overflow for long intervals */
+	return( (diff / llHdl->tickRate) * 1000 +
+			((diff % llHdl->tickRate) * 1000) / llHdl->tickRate );
+}
+
+/******************************** ConvPeriodMs *******************************/
+/** Convert LM63 conversion rate register value to conversion period
+ *
+ *  \code
+ *  CONVRATE   period
+ *  --------   ---------
+ *  0x00       16s
+ *  0x01       8s
+ *   ...
+ *  0x08       62.5ms
+ *  >=0x09     31.25ms
+ *  \endcode
+ *
+ *  \param convRate   \IN  LM63_CONVRATE register value
+ *
+ *  \return            conversion period [ms]
+ */
+static u_int32 ConvPeriodMs(
+   u_int8		convRate
+)
+{
+	if( convRate >= 0x09 )
+		return( 31 );
+
+	return( 16000 >> convRate );
+}
+
+/********************************* BusLock ***********************************/
+/** Get exclusive access to the device and the register shadow
+ *
+ *  Serializes the application calls (the driver uses LL_LOCK_NONE) among
+ *  each other with the bus access semaphore, so it must only be called in
+ *  call context. A pending ALERT is serviced (see AlertCb()) and the due
+ *  samples of the periodic sampler are taken first (see SamplerService()).
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *
+ *  \return            \c 0 On success or error code (e.g. signal received)
+ */
+static int32 BusLock(
+   LL_HANDLE    *llHdl
+)
+{
+	int32	error;
+
+	if( (error = OSS_SemWait( llHdl->osHdl, llHdl->busSem,
+							  OSS_SEM_WAITFOREVER )) )
+		return( error );
+	llHdl->xfer.locked = TRUE;
+
+	/* deadline of the SMBus transaction layer */
+	llHdl->xfer.start = OSS_TickGet( llHdl->osHdl );
+
+	if( llHdl->alertPending )
+		AlertService( llHdl );
+	SamplerService( llHdl );
+
+	return(0);
+}
+
+/******************************** BusUnlock **********************************/
+/** Release exclusive access to the device and the register shadow
+ *
+ *  Publishes the register shadow for the lock-free readers (see Publish())
+ *  and the transaction counters (see XferMerge()).
+ *
+ *  \param llHdl      \IN  Low-level handle
+ */
+static void BusUnlock(
+   LL_HANDLE    *llHdl
+)
+{
+	Publish( llHdl );
+	XferMerge( llHdl, &llHdl->xfer );
+	llHdl->xfer.locked = FALSE;
+	OSS_SemSignal( llHdl->osHdl, llHdl->busSem );
+}
+
+/********************************* XferMerge *********************************/
+/** Add transaction counters to the performance counters
+ *
+ *  Called with bus access granted, so the LM63_BLK_PERF transaction
+ *  counters are only modified by one caller. The counters of the
+ *  transaction context are cleared.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param xfer       \IN  Transaction context
+ */
+static void XferMerge(
+   LL_HANDLE    *llHdl,
+   LM63_XFER	*xfer
+)
+{
+	llHdl->perf->xfers        += xfer->xfers;
+	llHdl->perf->xferBytes    += xfer->xferBytes;
+	llHdl->perf->xferErrors   += xfer->xferErrors;
+	llHdl->perf->xferRetries  += xfer->xferRetries;
+	llHdl->perf->xferDeadline += xfer->xferDeadline;
+
+	xfer->xfers        = 0;
+	xfer->xferBytes    = 0;
+	xfer->xferErrors   = 0;
+	xfer->xferRetries  = 0;
+	xfer->xferDeadline = 0;
+}
+
+/********************************** Publish **********************************/
+/** Publish register shadow for lock-free readers (seqlock writer)
+ *
+ *  Called with bus access granted, so there is only one writer. The
+ *  sequence count is odd while the copy is updated.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ */
+static void Publish(
+   LL_HANDLE    *llHdl
+)
+{
+	int32	i;
+
+	/* odd count visible before the copy changes */
+	llHdl->pubSeq++;
+	MEM_WMB();
+	for( i=0; i<SHADOW_NUM; i++ )
+		llHdl->pub[i] = llHdl->shadow[i];
+	/* copy visible before the count is even again */
+	MEM_WMB();
+	llHdl->pubSeq++;
+}
+
+/********************************** PubRead **********************************/
+/** Get consistent copy of the published register shadow (seqlock reader)
+ *
+ *  Never waits for bus access or sleeps. If the published shadow is being
+ *  updated, the copy is retried immediately, so the reader spins through
+ *  up to PUB_RETRY attempts (a few copies of the shadow) before it gives
+ *  up and the caller falls back to BusLock().
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param shP        \OUT Copy of published shadow (SHADOW_NUM)
+ *
+ *  \return            TRUE if copy is consistent, otherwise FALSE
+ */
+static int32 PubRead(
+   LL_HANDLE    *llHdl,
+   LM63_SHADOW	*shP
+)
+{
+	u_int32	seq;
+	int32	i, retry;
+
+	for( retry=0; retry<PUB_RETRY; retry++ ){
+		seq = llHdl->pubSeq;
+		if( seq & 1 )
+			continue;
+
+		/* count read before the copy */
+		MEM_RMB();
+		for( i=0; i<SHADOW_NUM; i++ )
+			shP[i] = llHdl->pub[i];
+
+		/* copy read before the count is read again */
+		MEM_RMB();
+		if( seq == llHdl->pubSeq )
+			return( TRUE );
+	}
+
+	return( FALSE );
+}
+
+/********************************* ReadFast **********************************/
+/** Read channels from the published register shadow
+ *
+ *  Succeeds only if the published shadow of all requested channels can be
+ *  used (see ShadowValid()). All values belong to the same published
+ *  shadow. The PWM channel is only served if the PWM value register
+ *  shadow is valid (LM63_PWM_MANUAL).
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param first      \IN  First channel
+ *  \param nbrCh      \IN  Number of channels to read
+ *  \param bufP       \OUT Read values (nbrCh)
+ *
+ *  \return            TRUE if values read, otherwise FALSE
+ */
+static int32 ReadFast(
+   LL_HANDLE    *llHdl,
+   int32		first,
+   int32		nbrCh,
+   int32		*bufP
+)
+{
+	LM63_SHADOW	sh[SHADOW_NUM];
+	int32		ch, idx;
+
+	/* one-shot mode: convert on each read */
+	if( llHdl->oneShot || !PubRead( llHdl, sh ) )
+		return( FALSE );
+
+	for( ch=first; ch<first+nbrCh; ch++ ){
+		idx = G_chShadow[ch];
+		if( idx == SHADOW_NONE ){
+			if( !(llHdl->pwmRpm & PWM_RPM_PROGRAM) )
+				return( FALSE );
+		}
+		/* latest sample, even if the next one is due */
+		else if( !ShadowValid( llHdl, &sh[idx] ) )
+			return( FALSE );
+	}
+
+	for( ch=first; ch<first+nbrCh; ch++ ){
+		idx = G_chShadow[ch];
+		if( idx == SHADOW_NONE )
+			PwmRead( llHdl, &bufP[ch-first] );
+		else {
+			DecodeValue( llHdl, ch, sh[idx].raw, &bufP[ch-first] );
+			/* without lock: concurrent calls may lose a count */
+			llHdl->coalesced++;
+		}
+	}
+
+	return( TRUE );
+}
+
+/******************************* SamplerStart ********************************/
+/** Start (or restart) the periodic sampler
+ *
+ *  The alarm period is the greatest common divisor of the configured
+ *  sample periods, so each channel is sampled exactly at its own rate.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 SamplerStart(
+   LL_HANDLE    *llHdl
+)
+{
+	u_int32	gcd = 0, a, b, t;
+	int32	ch, error;
+
+	/* no conversions in standby */
+	if( llHdl->oneShot )
+		return( ERR_LL_DEV_BUSY );
+
+	for( ch=0; ch<CH_NUMBER; ch++ ){
+		if( !llHdl->smplPeriod[ch] )
+			continue;
+		/* Euclid */
+		a = gcd;
+		b = llHdl->smplPeriod[ch];
+		while( b ){
+			t = a % b;
+			a = b;
+			b = t;
+		}
+		gcd = a;
+	}
+
+	if( (error = SamplerStop( llHdl )) )
+		return( error );
+
+	/* no channel to sample */
+	if( !gcd )
+		return( ERR_LL_ILL_PARAM );
+
+	if( !llHdl->alarmHdl &&
+		(error = OSS_AlarmCreate( llHdl->osHdl, SamplerAlarm, llHdl,
+								  &llHdl->alarmHdl )) )
+		return( error );
+
+	for( ch=0; ch<CH_NUMBER; ch++ ){
+		llHdl->smplDue[ch]  = 0;
+		llHdl->smplPend[ch] = FALSE;
+	}
+
+	if( (error = BusLock( llHdl )) )
+		return( error );
+
+	if( !(error = OSS_AlarmSet( llHdl->osHdl, llHdl->alarmHdl, gcd, TRUE,
+								&llHdl->alarmPeriod )) ){
+		for( ch=0; ch<CH_NUMBER; ch++ ){
+			if( G_chShadow[ch] != SHADOW_NONE )
+				llHdl->shadow[G_chShadow[ch]].sampled = llHdl->smplPeriod[ch];
+		}
+	}
+	BusUnlock( llHdl );
+
+	if( error )
+		return( error );
+
+	llHdl->smplRun = TRUE;
+	DBGWRT_2((DBH, " sampler started: alarm period=%dms\n",
+			  llHdl->alarmPeriod));
+
+	return(0);
+}
+
+/******************************** SamplerStop ********************************/
+/** Stop the periodic sampler
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *
+ *  \return            \c 0 On success or error code (bus access)
+ */
+static int32 SamplerStop(
+   LL_HANDLE    *llHdl
+)
+{
+	int32	ch, error;
+
+	if( !llHdl->smplRun )
+		return(0);
+
+	OSS_AlarmClear( llHdl->osHdl, llHdl->alarmHdl );
+	llHdl->smplRun = FALSE;
+
+	if( (error = BusLock( llHdl )) )
+		return( error );
+	for( ch=0; ch<CH_NUMBER; ch++ ){
+		llHdl->smplPend[ch] = FALSE;
+		if( G_chShadow[ch] != SHADOW_NONE )
+			llHdl->shadow[G_chShadow[ch]].sampled = 0;
+	}
+	BusUnlock( llHdl );
+
+	return(0);
+}
+
+/******************************* SamplerAlarm ********************************/
+/** Periodic sampler (alarm routine)
+ *
+ *  Runs in alarm context and therefore never accesses the SMBus: marks
+ *  the channels whose sample period has elapsed as due and wakes up a
+ *  waiting LM63_BLK_FIFO call. The due samples are read in call context
+ *  (see SamplerService()). A period which elapses while the sample of the
+ *  previous period is still due is missed (smplMissed).
+ *
+ *  \param arg        \IN  Low-level handle
+ */
+static void SamplerAlarm(
+   void			*arg
+)
+{
+	LL_HANDLE	*llHdl = (LL_HANDLE*)arg;
+	int32		ch, due = FALSE;
+
+	for( ch=0; ch<CH_NUMBER; ch++ ){
+		if( !llHdl->smplPeriod[ch] )
+			continue;
+
+		llHdl->smplDue[ch] -= llHdl->alarmPeriod;
+		if( llHdl->smplDue[ch] > 0 )
+			continue;
+
+		llHdl->smplDue[ch] += llHdl->smplPeriod[ch];
+		/* don't catch up missed samples */
+		if( llHdl->smplDue[ch] <= 0 )
+			llHdl->smplDue[ch] = llHdl->smplPeriod[ch];
+
+		if( llHdl->smplPend[ch] )
+			llHdl->smplMissed++;
+		llHdl->smplPend[ch] = TRUE;
+		due = TRUE;
+	}
+
+	if( due )
+		OSS_SemSignal( llHdl->osHdl, llHdl->fifoSem );
+}
+
+/****************************** SamplerService *******************************/
+/** Take the due samples of the periodic sampler
+ *
+ *  Reads the registers of the due channels into the register shadow and
+ *  puts the samples into the FIFO (see DeadbandPass()). Called in call
+ *  context with bus access granted (see BusLock()): by a LM63_BLK_FIFO
+ *  call waiting for samples, otherwise by the next call accessing the
+ *  device. A sample that is due again before it was taken is taken once
+ *  (see SamplerAlarm()). The sample time is the time of this call, not
+ *  the time the sample was due.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ */
+static void SamplerService(
+   LL_HANDLE    *llHdl
+)
+{
+	u_int16		word;
+	int32		ch, value;
+
+	for( ch=0; ch<CH_NUMBER; ch++ ){
+		if( !llHdl->smplPend[ch] )
+			continue;
+
+		/* single word write, no lock against the alarm needed */
+		llHdl->smplPend[ch] = FALSE;
+
+		if( ReadRaw( llHdl, G_chShadow[ch], &word ) == ERR_SUCCESS ){
+			DecodeValue( llHdl, ch, word, &value );
+			if( DeadbandPass( llHdl, ch, value ) )
+				FifoPut( llHdl, ch, value );
+		}
+	}
+}
+
+/****************************** SamplerPending *******************************/
+/** Check for due samples of the periodic sampler
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *
+ *  \return            TRUE if a sample is due
+ */
+static int32 SamplerPending(
+   LL_HANDLE    *llHdl
+)
+{
+	int32	ch;
+
+	for( ch=0; ch<CH_NUMBER; ch++ ){
+		if( llHdl->smplPend[ch] )
+			return( TRUE );
+	}
+
+	return( FALSE );
+}
+
+/********************************* FifoPut ***********************************/
+/** Put sample into FIFO (producer side)
+ *
+ *  Called by SamplerService() only. If the FIFO is full, the sample is
+ *  dropped and counted as overflow. When the fill level reaches the
+ *  high-watermark, the installed signal is sent once.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param ch         \IN  Channel
+ *  \param value      \IN  Channel value
+ */
+static void FifoPut(
+   LL_HANDLE    *llHdl,
+   int32		ch,
+   int32		value
+)
+{
+	u_int32		in = llHdl->fifoIn;
+	u_int32		level = in - llHdl->fifoOut;
+	FIFO_ENTRY	*smpP;
+
+	if( level >= FIFO_SIZE ){
+		llHdl->fifoOverflow++;
+		return;
+	}
+
+	smpP = &llHdl->fifo[in & (FIFO_SIZE-1)];
+	smpP->time  = ElapsedMs( llHdl, llHdl->baseTick );
+	smpP->ch    = ch;
+	smpP->value = value;
+
+	/* publish sample (entry written before index) */
+	MEM_WMB();
+	llHdl->fifoIn = in + 1;
+	level++;
+
+	if( llHdl->fifoHwm && (level >= llHdl->fifoHwm) &&
+		!llHdl->fifoHwmSent && llHdl->fifoSigHdl ){
+		llHdl->fifoHwmSent = TRUE;
+		OSS_SigSend( llHdl->osHdl, llHdl->fifoSigHdl );
+	}
+
+	/* wake up waiting LM63_BLK_FIFO call */
+	OSS_SemSignal( llHdl->osHdl, llHdl->fifoSem );
+}
+
+/********************************* FifoGet ***********************************/
+/** Get samples from FIFO (consumer side)
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param bufP       \OUT Sample buffer
+ *  \param max        \IN  Max. number of samples to get
+ *
+ *  \return            number of samples
+ */
+static int32 FifoGet(
+   LL_HANDLE    *llHdl,
+   LM63_SAMPLE	*bufP,
+   u_int32		max
+)
+{
+	u_int32		out = llHdl->fifoOut;
+	u_int32		n = llHdl->fifoIn - out;
+	u_int32		i;
+	FIFO_ENTRY	*smpP;
+
+	/* index read before entries */
+	MEM_RMB();
+
+	if( n > max )
+		n = max;
+
+	for( i=0; i<n; i++ ){
+		smpP = &llHdl->fifo[(out + i) & (FIFO_SIZE-1)];
+		bufP[i].time  = smpP->time;
+		bufP[i].ch    = smpP->ch;
+		bufP[i].value = smpP->value;
+	}
+
+	/* release entries (read before the producer may overwrite them) */
+	MEM_MB();
+	llHdl->fifoOut = out + n;
+
+	/* re-arm high-watermark signal */
+	if( (llHdl->fifoIn - llHdl->fifoOut) < llHdl->fifoHwm )
+		llHdl->fifoHwmSent = FALSE;
+
+	return( n );
+}
+
+/********************************* FifoWait **********************************/
+/** Wait until the FIFO contains the given number of samples (consumer side)
+ *
+ *  The waiting call takes the due samples itself (see SamplerService()),
+ *  so the sampler keeps its rate while a consumer waits. A timeout is no
+ *  error, the caller gets the samples taken so far then.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param timeout    \IN  Max. wait time [ms] or OSS_SEM_WAITFOREVER
+ *  \param level      \IN  Fill level to wait for (1..FIFO_SIZE)
+ *
+ *  \return            \c 0 On success or error code (e.g. signal received)
+ */
+static int32 FifoWait(
+   LL_HANDLE    *llHdl,
+   int32		timeout,
+   u_int32		level
+)
+{
+	u_int32	start = OSS_TickGet( llHdl->osHdl );
+	int32	left = timeout, error;
+
+	/* the semaphore may be signaled for samples already read */
+	while( llHdl->fifoIn - llHdl->fifoOut < level ){
+		/* take due samples (see BusLock()) */
+		if( SamplerPending( llHdl ) ){
+			if( (error = BusLock( llHdl )) )
+				return( error );
+			BusUnlock( llHdl );
+			continue;
+		}
+
+		if( timeout != OSS_SEM_WAITFOREVER ){
+			left = timeout - (int32)ElapsedMs( llHdl, start );
+			if( left <= 0 )
+				break;
+		}
+
+		error = OSS_SemWait( llHdl->osHdl, llHdl->fifoSem, left );
+		if( error == ERR_OSS_TIMEOUT )
+			break;
+		if( error )
+			return( error );
+	}
+
+	return( 0 );
+}
+
+/******************************* DeadbandPass ********************************/
+/** Check a sample against the deadband of its channel
+ *
+ *  Called by SamplerService() only. The sample passes if the deadband
+ *  of the channel is off, if no sample was reported yet, if the value
+ *  differs from the last reported value by at least the deadband, or if
+ *  the max. silence interval has elapsed since the last reported sample.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param ch         \IN  Channel
+ *  \param value      \IN  Channel value
+ *
+ *  \return            TRUE if the sample is put into the FIFO
+ */
+static int32 DeadbandPass(
+   LL_HANDLE    *llHdl,
+   int32		ch,
+   int32		value
+)
+{
+	u_int32	time = ElapsedMs( llHdl, llHdl->baseTick );
+	int32	diff;
+
+	if( !llHdl->dbBand[ch] )
+		return( TRUE );
+
+	if( llHdl->dbValid[ch] ){
+		diff = value - llHdl->dbLast[ch];
+		if( diff < 0 )
+			diff = -diff;
+
+		if( ((u_int32)diff < llHdl->dbBand[ch]) &&
+			(!llHdl->dbSilence[ch] ||
+			 ((time - llHdl->dbTime[ch]) < llHdl->dbSilence[ch])) ){
+			llHdl->dbSuppressed++;
+			return( FALSE );
+		}
+	}
+
+	llHdl->dbLast[ch]  = value;
+	llHdl->dbTime[ch]  = time;
+	llHdl->dbValid[ch] = TRUE;
+
+	return( TRUE );
+}
+
+/******************************** AlertSetup *********************************/
+/** Enable/disable ALERT handling
+ *
+ *  Enable: programs the ALERT mask register, installs the SMB2 alert
+ *  callback and unmasks the ALERT output in the configuration register.
+ *  If the SMBus controller driver doesn't support alert callbacks, the
+ *  ALERT can't be delivered and ERR_LL_ILL_FUNC is returned without
+ *  touching the device (the ALERT causes can still be polled with the
+ *  LM63_ALERT_STATUS getstat code).\n
+ *  Disable: masks the ALERT output and removes the alert callback.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param enable     \IN  TRUE=enable, FALSE=disable
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 AlertSetup(
+   LL_HANDLE    *llHdl,
+   u_int32		enable
+)
+{
+	SMB_HANDLE	*smbH = llHdl->smbH;
+	void		*cbArg;
+	u_int8		cfg;
+	int32		error;
+
+	if( enable == llHdl->alertEnable )
+		return(0);
+
+	/* no alert callback: ALERT would never be serviced */
+	if( enable && !smbH->AlertCbInstall ){
+		DBGWRT_ERR((DBH, "*** LM63:AlertSetup: no SMBus alert callback\n"));
+		return(ERR_LL_ILL_FUNC);
+	}
+
+	if( (error = BusLock( llHdl )) )
+		return( error );
+
+	if( (error = ReadReg( llHdl, LM63_CFG, &cfg )) )
+		goto EXIT;
+
+	if( enable ){
+		if( (error = WriteReg( llHdl, LM63_ALERT_MASK,
+							   (u_int8)llHdl->alertMask )) )
+			goto EXIT;
+
+		if( (error = smbH->AlertCbInstall( smbH, llHdl->smbAddr,
+										   AlertCb, (void*)llHdl )) )
+			goto EXIT;
+
+		llHdl->alertEnable = TRUE;
+		cfg &= ~LM63_CFG_ALERT_MASK;
+	}
+	else {
+		llHdl->alertEnable = FALSE;
+		cfg |= LM63_CFG_ALERT_MASK;
+	}
+
+	error = WriteReg( llHdl, LM63_CFG, cfg );
+
+	if( !enable && smbH->AlertCbRemove )
+		smbH->AlertCbRemove( smbH, llHdl->smbAddr, &cbArg );
+
+EXIT:
+	BusUnlock( llHdl );
+	return( error );
+}
+
+/********************************** AlertCb **********************************/
+/** SMB2 alert callback
+ *
+ *  Called by the SMBus controller driver when the LM63 asserts ALERT,
+ *  possibly in interrupt context. So the callback doesn't access the
+ *  device: it marks the ALERT pending and sends the signal installed with
+ *  LM63_ALERT_SIG_SET. The ALERT status is read in call context by the
+ *  next call that gets the bus access (see BusLock()), e.g. the
+ *  LM63_ALERT_LATCH getstat of the signalled application.
+ *
+ *  \param arg        \IN  Low-level handle
+ */
+static void AlertCb(
+   void			*arg
+)
+{
+	LL_HANDLE	*llHdl = (LL_HANDLE*)arg;
+
+	llHdl->alertPending = TRUE;
+
+	if( llHdl->alertSigHdl )
+		OSS_SigSend( llHdl->osHdl, llHdl->alertSigHdl );
+}
+
+/******************************* AlertService ********************************/
+/** Read and clear ALERT status and latch causes of a pending ALERT
+ *
+ *  Must be called with bus access granted (see BusLock()).
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *
+ *  \return            ALERT causes (LM63_ALERT_xxx)
+ */
+static u_int8 AlertService(
+   LL_HANDLE    *llHdl
+)
+{
+	u_int16	word;
+
+	llHdl->alertPending = FALSE;
+
+	/* reading the status clears the causes which are no longer active */
+	if( ReadRaw( llHdl, SHADOW_ALERT, &word ) )
+		return(0);
+
+	/* signal already sent by AlertCb() */
+	return( AlertLatch( llHdl, word, FALSE ) );
+}
+
+/******************************** AlertLatch *********************************/
+/** Latch ALERT causes of a read ALERT status and send signal
+ *
+ *  Must be called with bus access granted (see BusLock()).
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param status     \IN  LM63_ALERT_STATUS register value
+ *  \param sig        \IN  TRUE: send ALERT signal on new cause
+ *
+ *  \return            ALERT causes (LM63_ALERT_xxx)
+ */
+static u_int8 AlertLatch(
+   LL_HANDLE    *llHdl,
+   u_int16		status,
+   u_int32		sig
+)
+{
+	u_int8	cause;
+
+	cause = (u_int8)(status & LM63_ALERT_ALL & ~llHdl->alertMask);
+	DBGWRT_2((DBH, " ALERT: cause=0x%02x\n", cause));
+
+	if( sig && (cause & ~llHdl->alertLatch) && llHdl->alertSigHdl )
+		OSS_SigSend( llHdl->osHdl, llHdl->alertSigHdl );
+
+	llHdl->alertLatch |= cause;
+
+	return( cause );
+}
+
+/********************************* LimitFind *********************************/
+/** Get hardware limit register description
+ *
+ *  \param code       \IN  Getstat/setstat code (LM63_LIM_xxx)
+ *
+ *  \return            limit description or NULL
+ */
+static const LM63_LIMIT* LimitFind(
+   int32		code
+)
+{
+	u_int32	i;
+
+	for( i=0; i<LIMIT_NUM; i++ ){
+		if( G_limit[i].code == code )
+			return( &G_limit[i] );
+	}
+
+	return( NULL );
+}
+
+/******************************** LimitSteps *********************************/
+/** Convert temperature limit to register steps
+ *
+ *  The value is rounded to the nearest step.
+ *
+ *  \param value      \IN  Limit [C] or [mC] (see unit)
+ *  \param unit       \IN  LM63_UNIT_xxx of value
+ *  \param step       \IN  Register resolution [mC]
+ *  \param min        \IN  Min. register value [steps]
+ *  \param max        \IN  Max. register value [steps]
+ *  \param stepsP     \OUT Register value [steps]
+ *
+ *  \return            \c 0 On success or ERR_LL_ILL_PARAM (out of range)
+ */
+static int32 LimitSteps(
+   int32		value,
+   u_int32		unit,
+   int32		step,
+   int32		min,
+   int32		max,
+   int32		*stepsP
+)
+{
+	/* avoid overflow below */
+	if( unit != LM63_UNIT_MILLIDEG ){
+		if( (value < -1000) || (value > 1000) )
+			return( ERR_LL_ILL_PARAM );
+		value *= 1000;
+	}
+	else if( (value < -1000000) || (value > 1000000) )
+		return( ERR_LL_ILL_PARAM );
+
+	/* round: <0.5=0, >=0.5=1 */
+	if( value < 0 )
+		*stepsP = -((-value + step / 2) / step);
+	else
+		*stepsP = (value + step / 2) / step;
+
+	if( (*stepsP < min) || (*stepsP > max) )
+		return( ERR_LL_ILL_PARAM );
+
+	return(0);
+}
+
+/********************************* LimitSet **********************************/
+/** Program hardware limit
+ *
+ *  Temperature limits are rounded to the register resolution: 1C
+ *  (LIM_TEMP, LIM_HYS) or 0.125C (LIM_RMTTEMP).
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param limP       \IN  Limit description
+ *  \param value      \IN  Limit [C] or [mC] (LM63_TEMP_UNIT) or [rpm]
+ *                         (LIM_TACH, 0=off, max. 10800000/TACH_PULSE)
+ *  \param init       \IN  TRUE: descriptor limit during hardware init,
+ *                         temperature [C], written with InitReg()
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 LimitSet(
+   LL_HANDLE    *llHdl,
+   const LM63_LIMIT *limP,
+   int32		value,
+   u_int32		init
+)
+{
+	int32	(*writeReg)(LL_HANDLE*, u_int8, u_int8) =
+		init ? InitReg : WriteReg;
+	u_int32	unit = init ? LM63_UNIT_DEG : llHdl->tempUnit;
+	u_int32	count;
+	u_int16	word;
+	int32	steps, error;
+
+	switch( limP->type ){
+		case LIM_TEMP:
+			if( (error = LimitSteps( value, unit, 1000, -128, 127, &steps )) )
+				return( error );
+			return( writeReg( llHdl, limP->reg, (u_int8)steps ) );
+
+		case LIM_RMTTEMP:
+			if( (error = LimitSteps( value, unit, 125, -1024, 1023, &steps )) )
+				return( error );
+			/* MSB: integer part, LSB bits 7..5: fraction (1/8C) */
+			word = (u_int16)(steps * 32);
+			if( (error = writeReg( llHdl, limP->reg, (u_int8)(word >> 8) )) )
+				return( error );
+			return( writeReg( llHdl, limP->reg2, (u_int8)(word & 0xe0) ) );
+
+		case LIM_HYS:
+			if( (error = LimitSteps( value, unit, 1000, 0, 255, &steps )) )
+				return( error );
+			return( writeReg( llHdl, limP->reg, (u_int8)steps ) );
+
+		case LIM_TACH:
+			/* tach count must be >= 1 (also avoids overflow below) */
+			if( (value < 0) ||
+				(value > (int32)((2 * 5400000) / llHdl->tachPuls)) )
+				return( ERR_LL_ILL_PARAM );
+			/* min. fan speed -> max. tach count */
+			if( value == 0 )
+				count = 0xffff;
+			else {
+				count = (2 * 5400000) / (llHdl->tachPuls * value);
+				if( count > 0xffff )
+					count = 0xffff;
+			}
+			/* LSB first */
+			if( (error = writeReg( llHdl, limP->reg2, (u_int8)(count & 0xff) )) )
+				return( error );
+			return( writeReg( llHdl, limP->reg, (u_int8)(count >> 8) ) );
+	}
+
+	return( ERR_LL_ILL_PARAM );
+}
+
+/********************************* LimitGet **********************************/
+/** Read hardware limit
+ *
+ *  Temperature limits are returned in the unit of the temperature channels
+ *  (LM63_TEMP_UNIT, LIM_RMTTEMP rounded like the remote temperature).
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param limP       \IN  Limit description
+ *  \param valueP     \OUT Limit [C] or [mC] or [rpm] (LIM_TACH, 0=off)
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 LimitGet(
+   LL_HANDLE    *llHdl,
+   const LM63_LIMIT *limP,
+   int32		*valueP
+)
+{
+	u_int8	lowByte, highByte;
+	u_int16	count;
+	int32	error;
+
+	switch( limP->type ){
+		case LIM_TEMP:
+			if( (error = ReadReg( llHdl, limP->reg, &highByte )) )
+				return( error );
+			DecodeValue( llHdl, LM63_CH_TEMP, highByte, valueP );
+			return(0);
+
+		case LIM_RMTTEMP:
+			if( (error = ReadReg( llHdl, limP->reg, &highByte )) ||
+				(error = ReadReg( llHdl, limP->reg2, &lowByte )) )
+				return( error );
+			DecodeValue( llHdl, LM63_CH_RMTTEMP,
+						 (u_int16)(((u_int16)highByte<<8) | lowByte), valueP );
+			return(0);
+
+		case LIM_HYS:
+			if( (error = ReadReg( llHdl, limP->reg, &highByte )) )
+				return( error );
+			*valueP = (int32)highByte;
+			if( llHdl->tempUnit == LM63_UNIT_MILLIDEG )
+				*valueP *= 1000;
+			return(0);
+
+		case LIM_TACH:
+			/* LSB first */
+			if( (error = ReadReg( llHdl, limP->reg2, &lowByte )) )
+				return( error );
+			if( (error = ReadReg( llHdl, limP->reg, &highByte )) )
+				return( error );
+			count = (u_int16)(((u_int16)highByte<<8) | lowByte);
+			if( (count == 0xffff) || (count == 0) )
+				*valueP = 0;
+			else
+				*valueP = (2 * 5400000) / (llHdl->tachPuls * count);
+			return(0);
+	}
+
+	return( ERR_LL_ILL_PARAM );
+}
+
+/********************************** PwmRead **********************************/
+/** Read PWM duty cycle
+ *
+ *  If the PWM value register is writable, the shadow is returned without
+ *  SMBus transaction. Otherwise the lookup table controls the PWM output
+ *  and the register is read from the device.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param valueP     \OUT PWM duty cycle [%]
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 PwmRead(
+   LL_HANDLE    *llHdl,
+   int32		*valueP
+)
+{
+	u_int8	pwmValue = llHdl->pwmValue;
+	int32	error;
+
+	if( !(llHdl->pwmRpm & PWM_RPM_PROGRAM) &&
+		(error = ReadReg( llHdl, LM63_PWM_VALUE, &pwmValue )) )
+		return( error );
+
+	/* duty cycle = PWM value / (2 * PWM frequency) */
+	*valueP = ((int32)pwmValue * 100 + llHdl->pwmFrequ) / (2 * llHdl->pwmFrequ);
+	if( *valueP > 100 )
+		*valueP = 100;
+
+	DBGWRT_2((DBH, " PWM duty cycle [%%] = %d\n", *valueP));
+	return(0);
+}
+
+/********************************* PwmWrite **********************************/
+/** Write PWM duty cycle
+ *
+ *  Enables PWM programming (write-unlock) only if not already done and
+ *  writes the PWM value register only if the value changes.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param value      \IN  PWM duty cycle [%]
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 PwmWrite(
+   LL_HANDLE    *llHdl,
+   int32		value
+)
+{
+	u_int8	pwmValue;
+	int32	error;
+
+	if( (value < 0) || (value > 100) )
+		return( ERR_LL_ILL_PARAM );
+
+	pwmValue = PWM_TO_RAW( llHdl, value );
+
+	if( (error = PwmProgram( llHdl, TRUE )) )
+		return( error );
+
+	/* unchanged */
+	if( pwmValue == llHdl->pwmValue )
+		return(0);
+
+	if( (error = WriteReg( llHdl, LM63_PWM_VALUE, pwmValue )) )
+		return( error );
+
+	llHdl->pwmValue = pwmValue;
+	return(0);
+}
+
+/******************************** PwmProgram *********************************/
+/** Enable/disable PWM programming
+ *
+ *  Enabled: PWM value register and lookup table are writable and the
+ *  PWM output is controlled by the PWM value register.\n
+ *  Disabled: the PWM output is controlled by the lookup table.
+ *
+ *  The PWM and RPM register is only written if the state changes.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param enable     \IN  TRUE=enable, FALSE=disable
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 PwmProgram(
+   LL_HANDLE    *llHdl,
+   u_int32		enable
+)
+{
+	u_int8	pwmRpm;
+	int32	error;
+
+	if( enable )
+		pwmRpm = (u_int8)(llHdl->pwmRpm | PWM_RPM_PROGRAM);
+	else
+		pwmRpm = (u_int8)(llHdl->pwmRpm & ~PWM_RPM_PROGRAM);
+
+	if( pwmRpm == llHdl->pwmRpm )
+		return(0);
+
+	/* take over value set by lookup table */
+	if( enable &&
+		(error = ReadReg( llHdl, LM63_PWM_VALUE, &llHdl->pwmValue )) )
+		return( error );
+
+	if( (error = WriteReg( llHdl, LM63_PWM_RPM, pwmRpm )) )
+		return( error );
+
+	llHdl->pwmRpm = pwmRpm;
+	return(0);
+}
+
+/********************************** LutLoad **********************************/
+/** Load lookup table shadow from the device
+ *
+ *  The lookup table registers are only read once, afterwards the
+ *  shadow is kept up to date by LutSet().
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 LutLoad(
+   LL_HANDLE    *llHdl
+)
+{
+	int32	n, error;
+
+	if( llHdl->lutValid )
+		return(0);
+
+	if( (error = ReadReg( llHdl, LM63_LOOKUP_HYS, &llHdl->lutHys )) )
+		return( error );
+
+	for( n=0; n<LM63_LUT_NUM; n++ ){
+		if( (error = ReadReg( llHdl, (u_int8)LM63_LOOKUP_TBL_TEMP(n),
+							  &llHdl->lutTemp[n] )) ||
+			(error = ReadReg( llHdl, (u_int8)LM63_LOOKUP_TBL_PWM(n),
+							  &llHdl->lutPwm[n] )) )
+			return( error );
+	}
+
+	llHdl->lutValid = TRUE;
+	return(0);
+}
+
+/********************************** LutSet ***********************************/
+/** Program lookup table and hysteresis
+ *
+ *  The complete table is verified before any register is written.
+ *  Only entries which differ from the shadow are written. The lookup
+ *  table is write-unlocked for the update and afterwards the previous
+ *  PWM control (see LM63_PWM_MANUAL) is restored.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param lutP       \IN  lookup table
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 LutSet(
+   LL_HANDLE    *llHdl,
+   const LM63_LUT *lutP
+)
+{
+	u_int8	temp[LM63_LUT_NUM], pwm[LM63_LUT_NUM];
+	u_int32	manual = (llHdl->pwmRpm & PWM_RPM_PROGRAM) ? TRUE : FALSE;
+	int32	n, error, error2;
+
+	/* verify table */
+	if( (lutP->hys < 0) || (lutP->hys > LUT_HYS_MAX) )
+		return( ERR_LL_ILL_PARAM );
+
+	for( n=0; n<LM63_LUT_NUM; n++ ){
+		if( (lutP->entry[n].temp < 0) ||
+			(lutP->entry[n].temp > LUT_TEMP_MAX) ||
+			(lutP->entry[n].pwm < 0) || (lutP->entry[n].pwm > 100) )
+			return( ERR_LL_ILL_PARAM );
+
+		/* temperatures must be ascending */
+		if( n && (lutP->entry[n].temp < lutP->entry[n-1].temp) )
+			return( ERR_LL_ILL_PARAM );
+
+		temp[n] = (u_int8)lutP->entry[n].temp;
+		pwm[n]  = (u_int8)(PWM_TO_RAW( llHdl, lutP->entry[n].pwm )
+						   & LUT_PWM_MASK);
+	}
+
+	if( (error = LutLoad( llHdl )) )
+		return( error );
+
+	/* write-unlock */
+	if( (error = PwmProgram( llHdl, TRUE )) )
+		return( error );
+
+	if( (u_int8)lutP->hys != llHdl->lutHys ){
+		if( (error = WriteReg( llHdl, LM63_LOOKUP_HYS, (u_int8)lutP->hys )) )
+			goto RESTORE;
+		llHdl->lutHys = (u_int8)lutP->hys;
+	}
+
+	for( n=0; n<LM63_LUT_NUM; n++ ){
+		if( temp[n] != llHdl->lutTemp[n] ){
+			if( (error = WriteReg( llHdl, (u_int8)LM63_LOOKUP_TBL_TEMP(n),
+								   temp[n] )) )
+				goto RESTORE;
+			llHdl->lutTemp[n] = temp[n];
+		}
+		if( pwm[n] != llHdl->lutPwm[n] ){
+			if( (error = WriteReg( llHdl, (u_int8)LM63_LOOKUP_TBL_PWM(n),
+								   pwm[n] )) )
+				goto RESTORE;
+			llHdl->lutPwm[n] = pwm[n];
+		}
+	}
+
+RESTORE:
+	/* write-lock, lookup table controls the PWM output again */
+	if( !manual && (error2 = PwmProgram( llHdl, FALSE )) && !error )
+		error = error2;
+
+	return( error );
+}
+
+/********************************** LutGet ***********************************/
+/** Get lookup table and hysteresis
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param lutP       \OUT lookup table
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 LutGet(
+   LL_HANDLE    *llHdl,
+   LM63_LUT		*lutP
+)
+{
+	int32	n, error;
+
+	if( (error = LutLoad( llHdl )) )
+		return( error );
+
+	lutP->hys = llHdl->lutHys;
+	for( n=0; n<LM63_LUT_NUM; n++ ){
+		lutP->entry[n].temp = llHdl->lutTemp[n];
+		lutP->entry[n].pwm  = ((int32)(llHdl->lutPwm[n] & LUT_PWM_MASK) * 100
+							   + llHdl->pwmFrequ) / (2 * llHdl->pwmFrequ);
+		if( lutP->entry[n].pwm > 100 )
+			lutP->entry[n].pwm = 100;
+	}
+
+	return(0);
+}
+
+/******************************** ConvModeSet ********************************/
+/** Set conversion mode
+ *
+ *  One-shot: the LM63 is put in standby and converts only on demand
+ *  (see OneShot()). Not possible while the periodic sampler is running.\n
+ *  Continuous: the LM63 converts free-running at the conversion rate.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param oneShot    \IN  TRUE=one-shot, FALSE=continuous
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 ConvModeSet(
+   LL_HANDLE    *llHdl,
+   u_int32		oneShot
+)
+{
+	u_int8	cfg;
+	int32	error;
+
+	if( oneShot == llHdl->oneShot )
+		return(0);
+
+	if( oneShot && llHdl->smplRun )
+		return( ERR_LL_DEV_BUSY );
+
+	if( (error = BusLock( llHdl )) )
+		return( error );
+
+	if( (error = ReadReg( llHdl, LM63_CFG, &cfg )) )
+		goto EXIT;
+
+	if( oneShot )
+		cfg |= LM63_CFG_STANDBY;
+	else
+		cfg &= ~LM63_CFG_STANDBY;
+
+	if( (error = WriteReg( llHdl, LM63_CFG, cfg )) )
+		goto EXIT;
+
+	llHdl->oneShot = oneShot;
+
+EXIT:
+	BusUnlock( llHdl );
+	return( error );
+}
+
+/********************************** OneShot **********************************/
+/** Trigger one-shot conversion and wait for completion
+ *
+ *  Waits the nominal conversion time, then polls the busy flag of the
+ *  ALERT status with a short sleep between the polls (each poll is an
+ *  SMBus transaction). The register shadow is invalidated, so the next
+ *  read fetches the new results.\n
+ *  Reading the ALERT status clears its inactive causes, so the causes read
+ *  while polling are always latched (LM63_ALERT_LATCH), also with ALERT
+ *  handling disabled. The ALERT signal is sent only with ALERT handling
+ *  enabled.
+ *
+ *  Must be called with bus access granted (see BusLock()).
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 OneShot(
+   LL_HANDLE    *llHdl
+)
+{
+	u_int32	tick;
+	u_int16	status;
+	int32	error;
+
+	/* any value starts a conversion */
+	if( (error = WriteReg( llHdl, LM63_ONESHOT, 0 )) )
+		return( error );
+
+	tick = OSS_TickGet( llHdl->osHdl );
+	OSS_Delay( llHdl->osHdl, ONESHOT_CONV_MS );
+
+	do {
+		if( (error = ReadRaw( llHdl, SHADOW_ALERT, &status )) )
+			return( error );
+
+		AlertLatch( llHdl, status, llHdl->alertEnable );
+
+		if( !(status & LM63_ALST_BUSY) )
+			break;
+
+		if( ElapsedMs( llHdl, tick ) > ONESHOT_TIMEOUT )
+			return( ERR_LL_DEV_NOTRDY );
+
+		OSS_Delay( llHdl->osHdl, ONESHOT_POLL_MS );
+	} while( TRUE );
+
+	llHdl->shadow[SHADOW_TEMP].valid    = FALSE;
+	llHdl->shadow[SHADOW_RMTTEMP].valid = FALSE;
+	llHdl->shadow[SHADOW_TACH].valid    = FALSE;
+
+	return(0);
+}
+
+/******************************** SensorSetup ********************************/
+/** Set up additional sensor of the aggregator
+ *
+ *  Only the tach mode is programmed (as for sensor 0), all other
+ *  registers keep their values. Called with bus access granted (see
+ *  HwProgram()). Probes the SMBus word read for the
+ *  tach count (see SMB_WORD_READ).
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param sensP      \IN  Sensor
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 SensorSetup(
+   LL_HANDLE    *llHdl,
+   LM63_SENSOR	*sensP
+)
+{
+	LM63_XFER	*xfer = &llHdl->xfer;
+	SMB_HANDLE	*smbH = sensP->smbH;
+	u_int16		word;
+	u_int8		pwmRpm;
+	int32		error;
+
+	if( (error = SmbReadByte( llHdl, xfer, smbH, sensP->smbAddr,
+							  LM63_PWM_RPM, &pwmRpm )) )
+		return( error );
+
+	if( (pwmRpm & PWM_RPM_TACH_MASK) != PWM_RPM_TACH_MODE ){
+		pwmRpm = (u_int8)((pwmRpm & ~PWM_RPM_TACH_MASK) | PWM_RPM_TACH_MODE);
+		if( (error = SmbWriteByte( llHdl, xfer, smbH, sensP->smbAddr,
+								   LM63_PWM_RPM, pwmRpm )) )
+			return( error );
+	}
+
+	sensP->wordRead = llHdl->wordRead && smbH->ReadWordData &&
+		!SmbReadWord( llHdl, xfer, smbH, sensP->smbAddr,
+					  LM63_TACH_COUNT_LSB, &word );
+
+	DBGWRT_2((DBH, " sensor bus=%d addr=0x%02x: SMBus word read %s\n",
+			  sensP->busNbr, sensP->smbAddr,
+			  sensP->wordRead ? "used" : "not used"));
+	return(0);
+}
+
+/******************************** SensorRead *********************************/
+/** Read all input channels of an additional sensor
+ *
+ *  The register shadow is not used for additional sensors.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param xfer       \IN  Transaction context
+ *  \param sensP      \IN  Sensor
+ *  \param valP       \OUT Sensor values
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 SensorRead(
+   LL_HANDLE    *llHdl,
+   LM63_XFER	*xfer,
+   LM63_SENSOR	*sensP,
+   LM63_SENSOR_VAL *valP
+)
+{
+	SMB_HANDLE	*smbH = sensP->smbH;
+	u_int16		tach;
+	u_int8		temp, rmtMsb, rmtLsb, tachLsb, tachMsb;
+	int32		error;
+
+	if( (error = SmbReadByte( llHdl, xfer, smbH, sensP->smbAddr,
+							  LM63_TEMP, &temp )) ||
+		/* MSB first: LSB is latched until MSB read */
+		(error = SmbReadByte( llHdl, xfer, smbH, sensP->smbAddr,
+							  LM63_RMTTEMP_MSB, &rmtMsb )) ||
+		(error = SmbReadByte( llHdl, xfer, smbH, sensP->smbAddr,
+							  LM63_RMTTEMP_LSB, &rmtLsb )) )
+		return( error );
+
+	if( sensP->wordRead ){
+		if( (error = SmbReadWord( llHdl, xfer, smbH, sensP->smbAddr,
+								  LM63_TACH_COUNT_LSB, &tach )) )
+			return( error );
+	}
+	else {
+		/* LSB first: MSB is latched until LSB read */
+		if( (error = SmbReadByte( llHdl, xfer, smbH, sensP->smbAddr,
+								  LM63_TACH_COUNT_LSB, &tachLsb )) ||
+			(error = SmbReadByte( llHdl, xfer, smbH, sensP->smbAddr,
+								  LM63_TACH_COUNT_MSB, &tachMsb )) )
+			return( error );
+		tach = (u_int16)(((u_int16)tachMsb<<8) | tachLsb);
+	}
+
+	DecodeValue( llHdl, LM63_CH_TEMP, temp, &valP->temp );
+	DecodeValue( llHdl, LM63_CH_RMTTEMP,
+				 (u_int16)(((u_int16)rmtMsb<<8) | rmtLsb), &valP->rmtTemp );
+	DecodeValue( llHdl, LM63_CH_FANSPEED, tach, &valP->fanSpeed );
+
+	return(0);
+}
+
+/******************************** SensorSweep ********************************/
+/** Read all sensors of the aggregator
+ *
+ *  The sensors are read bus by bus, so sensors on the same bus are read
+ *  back to back. Sensor 0 is read via the register shadow (see
+ *  ReadSnapshot()) with bus access granted. The additional sensors are
+ *  read with the sensor sweep lock only, so a slow or absent sensor
+ *  (retries) doesn't block the calls of the device itself. Their
+ *  transactions are counted in an own transaction context, which is
+ *  merged into the performance counters with bus access granted. A
+ *  failing sensor does not abort the sweep, its error code is returned
+ *  in LM63_SENSOR_VAL.error and its values are 0.
+ *
+ *  Lock order: sweep lock, then bus access lock.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param bufP       \OUT Sensor values (descriptor order)
+ *  \param max        \IN  Max. number of sensors to read
+ *  \param numP       \OUT Number of sensors read
+ *
+ *  \return            \c 0 On success or error code (bus access)
+ */
+static int32 SensorSweep(
+   LL_HANDLE    *llHdl,
+   LM63_SENSOR_VAL *bufP,
+   u_int32		max,
+   u_int32		*numP
+)
+{
+	LM63_XFER	xfer;
+	int32		value[LM63_CH_FANSPEED+1];
+	u_int32		num = (max < llHdl->sensorNum) ? max : llHdl->sensorNum;
+	u_int32		i, n;
+	int32		error;
+
+	if( (error = OSS_SemWait( llHdl->osHdl, llHdl->sweepSem,
+							  OSS_SEM_WAITFOREVER )) )
+		return( error );
+
+	/* sensor 0: the device itself */
+	if( num ){
+		if( (error = BusLock( llHdl )) )
+			goto EXIT;
+
+		bufP[0].temp     = 0;
+		bufP[0].rmtTemp  = 0;
+		bufP[0].fanSpeed = 0;
+		if( (!llHdl->oneShot || !(bufP[0].error = OneShot( llHdl ))) &&
+			!(bufP[0].error = ReadSnapshot( llHdl, LM63_CH_FANSPEED+1,
+											value )) ){
+			bufP[0].temp     = value[LM63_CH_TEMP];
+			bufP[0].rmtTemp  = value[LM63_CH_RMTTEMP];
+			bufP[0].fanSpeed = value[LM63_CH_FANSPEED];
+		}
+
+		BusUnlock( llHdl );
+	}
+
+	/* additional sensors: without bus access lock */
+	OSS_MemFill( llHdl->osHdl, sizeof(xfer), (char*)&xfer, 0 );
+	xfer.locked = TRUE;
+	xfer.start  = OSS_TickGet( llHdl->osHdl );
+
+	for( i=0; i<llHdl->sensorNum; i++ ){
+		n = llHdl->sweep[i];
+		if( (n == 0) || (n >= num) )
+			continue;
+
+		/* values of a failing sensor are 0 */
+		bufP[n].temp     = 0;
+		bufP[n].rmtTemp  = 0;
+		bufP[n].fanSpeed = 0;
+		bufP[n].error = SensorRead( llHdl, &xfer, &llHdl->sensor[n],
+									&bufP[n] );
+	}
+
+	/* transaction counters */
+	if( xfer.xfers ){
+		if( (error = BusLock( llHdl )) )
+			goto EXIT;
+		XferMerge( llHdl, &xfer );
+		BusUnlock( llHdl );
+	}
+
+	*numP = num;
+
+EXIT:
+	OSS_SemSignal( llHdl->osHdl, llHdl->sweepSem );
+	return( error );
+}
+
+/********************************** HwReady **********************************/
+/** Program the hardware if not yet done
+ *
+ *  With INIT_DEFER, LM63_Init() doesn't access the device and the hardware
+ *  is programmed on the first access. Concurrent first accesses wait
+ *  until the hardware is programmed.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 HwReady(
+   LL_HANDLE    *llHdl
+)
+{
+	int32	error = 0;
+
+	if( llHdl->hwReady )
+		return(0);
+
+	if( (error = OSS_SemWait( llHdl->osHdl, llHdl->callSem,
+							  OSS_SEM_WAITFOREVER )) )
+		return( error );
+	if( !llHdl->hwReady && !(error = HwInit( llHdl )) )
+		llHdl->hwReady = TRUE;
+	OSS_SemSignal( llHdl->osHdl, llHdl->callSem );
+
+	return( error );
+}
+
+/********************************** HwInit ***********************************/
+/** Program the hardware as defined in the descriptor
+ *
+ *  With WARM_ATTACH, the PWM setup is kept if the device is still
+ *  configured by a previous session (see CtxRestore()). All other
+ *  registers are verified and written only if they differ.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 HwInit(
+   LL_HANDLE    *llHdl
+)
+{
+	u_int32	tick = OSS_TickGet( llHdl->osHdl );
+	int32	error;
+
+	if( (error = BusLock( llHdl )) )
+		return( error );
+
+	llHdl->warm = llHdl->warmAttach && CtxRestore( llHdl );
+	error = HwProgram( llHdl );
+
+	BusUnlock( llHdl );
+	if( error )
+		return( error );
+
+    /* COALESCE_WINDOW (default: conversion period) */
+    if((error = DESC_GetUInt32(llHdl->descHdl, llHdl->convPeriod,
+								&llHdl->coalesceWin, "COALESCE_WINDOW")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( error );
+
+	/*
+	 * ALERT:
+	 *   program mask and unmask ALERT output
+	 */
+	if( llHdl->initAlert && (error = AlertSetup( llHdl, TRUE )) )
+		return( error );
+
+	/*
+	 * Conversion mode:
+	 *   standby with one-shot conversions on demand
+	 */
+	if( llHdl->initOneShot && (error = ConvModeSet( llHdl, TRUE )) )
+		return( error );
+
+	llHdl->initTime = ElapsedMs( llHdl, tick );
+	DBGWRT_2((DBH, " hardware init: %dms, %d transactions saved\n",
+			  llHdl->initTime, llHdl->initSaved));
+
+	return(0);
+}
+
+/********************************* HwProgram *********************************/
+/** Program the configuration registers
+ *
+ *  With INIT_VERIFY, the configuration registers are read back first and
+ *  only the registers which differ are written. initSaved counts the net
+ *  SMBus transactions saved: skipped writes minus verify reads (negative
+ *  if most registers differ).
+ *
+ *  Attached warm (see CtxRestore()), the PWM setup, conversion period and
+ *  SMBus word read are taken from the context and all other registers are
+ *  verified as with INIT_VERIFY.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 HwProgram(
+   LL_HANDLE    *llHdl
+)
+{
+	u_int32	value, lim, n;
+	u_int32	pwmSetup = TRUE;
+	u_int8	pwmRpm = 0, spinUp, frequ, value8;
+	u_int16	value16;
+	int32	error;
+
+#if 0
+	/* just for debugging - dump all LM63 registers */
+	{
+	u_int8	regVal;
+    int32	regOff;
+
+	for( regOff=0; regOff<=0xff; regOff++ ){
+		ReadByteData( llHdl->smbH, 0, llHdl->smbAddr, (u_int8)regOff, &regVal );
+		DBGWRT_2((DBH, "LM63 regOff=0x%02x : regVal=0x%02x\n", regOff, regVal));
+	}
+	}
+#endif
+
+	/*
+	 * Verify-before-write:
+	 *   skip the PWM setup if the PWM registers are already programmed
+	 *   (then the lookup table controls the PWM value)
+	 */
+	if( llHdl->warm )
+		pwmSetup = FALSE;	/* signature checked by CtxRestore() */
+	else if( llHdl->initVerify ){
+		if( (error = ReadReg( llHdl, LM63_PWM_RPM, &pwmRpm )) ||
+			(error = ReadReg( llHdl, LM63_FAN_SPINUP_CFG, &spinUp )) ||
+			(error = ReadReg( llHdl, LM63_PWM_FREQU, &frequ )) )
+			return( error );
+		llHdl->initSaved -= 3;
+		pwmSetup = (pwmRpm != (PWM_RPM_INIT & ~PWM_RPM_PROGRAM)) ||
+				   (spinUp != PWM_SPINUP_INIT) || (frequ != PWM_FREQU_INIT);
+	}
+
+	if( pwmSetup ){
+		/*
+		 * PWM and RPM register:
+		 *   bit - value: used configuration
+		 *   5   -  1: the PWM Value (register 4C) and the Lookup Table (50 5F) are read/write enabled
+		 *   4   -  0: the PWM output pin will be 0 V for fan OFF and open for fan ON
+		 *   3   -  1: master PWM clock is 1.4 kHz
+		 *   2   -  0: unused
+		 *   1:0 - 10: most accurate readings, FFFF reading when under minimum detectable RPM
+		 */
+		pwmRpm = PWM_RPM_INIT;
+		if( (error = WriteReg( llHdl, LM63_PWM_RPM, pwmRpm )) )
+			return( error );
+
+		/*
+		 * Fan Spin-Up Config register:
+		 *   use POR value
+		 */
+		if( (error = WriteReg( llHdl, LM63_FAN_SPINUP_CFG,
+							   PWM_SPINUP_INIT )) )
+			return( error );
+
+		/*
+		 * PWM Frequency register:
+		 *   use POR value
+		 */
+		if( (error = WriteReg( llHdl, LM63_PWM_FREQU, PWM_FREQU_INIT )) )
+			return( error );
+
+		/*
+		 * PWM Value register:
+		 *   use POR value
+		 */
+		if( (error = WriteReg( llHdl, LM63_PWM_VALUE, PWM_VALUE_INIT )) )
+			return( error );
+
+		/*
+		 * PWM and RPM register:
+		 *   bit - value: used configuration
+		 *   5   -  0: the PWM Value (register 4C) and the Lookup Table (50 5F) are read-only
+		 */
+		pwmRpm &= ~PWM_RPM_PROGRAM;
+		if( (error = WriteReg( llHdl, LM63_PWM_RPM, pwmRpm )) )
+			return( error );
+	}
+	else
+		llHdl->initSaved += 5;
+
+	/* attached warm: shadows restored from context */
+	if( !llHdl->warm ){
+		llHdl->pwmRpm   = pwmRpm;
+		llHdl->pwmValue = PWM_VALUE_INIT;
+		llHdl->pwmFrequ = PWM_FREQU_INIT;
+	}
+
+	/*
+	 * Remote temp offset:
+	 */
+	if( (error = InitReg( llHdl, LM63_RMTTEMP_OFF_LSB, 0 )) )
+		return( error );
+
+	if( (error = InitReg( llHdl, LM63_RMTTEMP_OFF_MSB,
+						  (u_int8)llHdl->rmtTempOff )) )
+		return( error );
+
+	if( !llHdl->warm ){
+		/*
+		 * Conversion rate:
+		 *   determines how long the register shadow stays valid
+		 */
+		if( (error = ReadReg( llHdl, LM63_CONVRATE, &value8 )) )
+			return( error );
+		llHdl->convPeriod = ConvPeriodMs( value8 );
+
+		/*
+		 * SMBus word read:
+		 *   use it for the tach count only if the SMBus controller
+		 *   supports it
+		 */
+		if( llHdl->wordRead &&
+			( (llHdl->smbH->ReadWordData == NULL) ||
+			  ReadRegWord( llHdl, LM63_TACH_COUNT_LSB, &value16 ) ) )
+			llHdl->wordRead = FALSE;
+		llHdl->sensor[0].wordRead = llHdl->wordRead;
+	}
+	DBGWRT_2((DBH, " conversion period = %dms\n", llHdl->convPeriod));
+	DBGWRT_2((DBH, " SMBus word read %s\n",
+			  llHdl->wordRead ? "used" : "not used"));
+
+	/*
+	 * Limits:
+	 *   program only the limits specified in the descriptor
+	 */
+	for( lim=0; lim<LIMIT_NUM; lim++ ){
+		if( (error = DESC_GetUInt32( llHdl->descHdl, 0, &value,
+									 (char*)G_limit[lim].key )) ){
+			if( error == ERR_DESC_KEY_NOTFOUND )
+				continue;
+			return( error );
+		}
+		if( (error = LimitSet( llHdl, &G_limit[lim], (int32)value, TRUE )) )
+			return( error );
+	}
+
+	/*
+	 * Aggregator:
+	 *   set up additional sensors
+	 */
+	for( n=1; n<llHdl->sensorNum; n++ ){
+		if( (error = SensorSetup( llHdl, &llHdl->sensor[n] )) )
+			return( error );
+	}
+
+	return(0);
+}
+
+/********************************** InitReg **********************************/
+/** Write configuration register during hardware init
+ *
+ *  With INIT_VERIFY or attached warm, the register is only written if its
+ *  value differs.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *  \param reg        \IN  Register offset
+ *  \param val        \IN  Register value
+ *
+ *  \return            \c 0 On success or error code
+ */
+static int32 InitReg(
+   LL_HANDLE    *llHdl,
+   u_int8		reg,
+   u_int8		val
+)
+{
+	u_int8	cur;
+	int32	error;
+
+	if( llHdl->initVerify || llHdl->warm ){
+		if( (error = ReadReg( llHdl, reg, &cur )) )
+			return( error );
+		llHdl->initSaved--;
+		if( cur == val ){
+			llHdl->initSaved++;
+			return(0);
+		}
+	}
+
+	return( WriteReg( llHdl, reg, val ) );
+}
+
+/******************************** CtxRestore *********************************/
+/** Restore device context of a previous session (warm attach)
+ *
+ *  The context is only used if the PWM registers still match the saved
+ *  values, otherwise the device was reset or reprogrammed meanwhile.
+ *  The context is removed in any case (saved again by LM63_Exit()).
+ *  The signature reads count as verify reads (initSaved).
+ *
+ *  Open/close calls are serialized by the MDIS kernel, so the context
+ *  table needs no lock.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ *
+ *  \return            TRUE if context restored, otherwise FALSE
+ */
+static int32 CtxRestore(
+   LL_HANDLE    *llHdl
+)
+{
+	LM63_CTX	*ctxP = NULL;
+	u_int8		pwmRpm, pwmFrequ, pwmValue;
+	int32		i, match;
+
+	for( i=0; i<CTX_MAX; i++ ){
+		if( (G_ctx[i].smbH == llHdl->smbH) &&
+			(G_ctx[i].smbAddr == llHdl->smbAddr) ){
+			ctxP = &G_ctx[i];
+			break;
+		}
+	}
+	if( ctxP == NULL )
+		return( FALSE );
+
+	/* signature: PWM registers */
+	match = !ReadReg( llHdl, LM63_PWM_RPM, &pwmRpm ) &&
+			!ReadReg( llHdl, LM63_PWM_FREQU, &pwmFrequ ) &&
+			(pwmRpm == ctxP->pwmRpm) && (pwmFrequ == ctxP->pwmFrequ);
+	llHdl->initSaved -= 2;
+
+	if( match && (pwmRpm & PWM_RPM_PROGRAM) ){
+		match = !ReadReg( llHdl, LM63_PWM_VALUE, &pwmValue ) &&
+				(pwmValue == ctxP->pwmValue);
+		llHdl->initSaved--;
+	}
+
+	if( match ){
+		llHdl->pwmRpm     = ctxP->pwmRpm;
+		llHdl->pwmValue   = ctxP->pwmValue;
+		llHdl->pwmFrequ   = ctxP->pwmFrequ;
+		llHdl->convPeriod = ctxP->convPeriod;
+		llHdl->wordRead   = llHdl->wordRead && ctxP->wordRead;
+		llHdl->lutValid   = ctxP->lutValid;
+		llHdl->lutHys     = ctxP->lutHys;
+		for( i=0; i<LUT_NUM; i++ ){
+			llHdl->lutTemp[i] = ctxP->lutTemp[i];
+			llHdl->lutPwm[i]  = ctxP->lutPwm[i];
+		}
+		llHdl->sensor[0].wordRead = llHdl->wordRead;
+	}
+
+	DBGWRT_2((DBH, " warm attach %s\n", match ? "done" : "refused"));
+
+	ctxP->smbH = NULL;
+	return( match );
+}
+
+/********************************** CtxSave **********************************/
+/** Save device context for the next session (warm attach)
+ *
+ *  If the context table is full, the context is dropped and the next
+ *  session programs the device again.
+ *
+ *  \param llHdl      \IN  Low-level handle
+ */
+static void CtxSave(
+   LL_HANDLE    *llHdl
+)
+{
+	LM63_CTX	*ctxP = NULL;
+	int32		i;
+
+	for( i=0; i<CTX_MAX; i++ ){
+		if( G_ctx[i].smbH == NULL ){
+			ctxP = &G_ctx[i];
+			break;
+		}
+	}
+	if( ctxP == NULL )
+		return;
+
+	ctxP->smbAddr    = llHdl->smbAddr;
+	ctxP->pwmRpm     = llHdl->pwmRpm;
+	ctxP->pwmValue   = llHdl->pwmValue;
+	ctxP->pwmFrequ   = llHdl->pwmFrequ;
+	ctxP->convPeriod = llHdl->convPeriod;
+	ctxP->wordRead   = llHdl->wordRead;
+	ctxP->lutValid   = llHdl->lutValid;
+	ctxP->lutHys     = llHdl->lutHys;
+	for( i=0; i<LUT_NUM; i++ ){
+		ctxP->lutTemp[i] = llHdl->lutTemp[i];
+		ctxP->lutPwm[i]  = llHdl->lutPwm[i];
+	}
+	ctxP->smbH       = llHdl->smbH;
+}
@@ -117,6 +117,9 @@ int main(int argc, char *argv[])
 			case LM63_CH_FANSPEED:
 				printf("Fanspeed             : %drpm\n", (int)value);
 				break;
+			case LM63_CH_PWM:
+				printf("PWM duty cycle       : %d%%\n", (int)value);
+				break;
 			}
 		}
 
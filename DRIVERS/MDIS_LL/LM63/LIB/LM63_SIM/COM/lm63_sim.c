@@ -0,0 +1,1207 @@
+/*********************  P r o g r a m  -  M o d u l e ***********************/
+/*!
+ *        \file  lm63_sim.c
+ *
+ *      \author  dieter.pfeuffer@men.de
+ *
+ *       \brief  LM63 SMBus simulator library
+ *
+ *               Provides a simulated SMB_HANDLE with a register-level model
+ *               of one or more LM63 devices. A host build of the LM63 driver
+ *               uses the simulated bus instead of OSS_GetSmbHdl() to run
+ *               tests and benchmarks without hardware.
+ *
+ *               Model:
+ *               - local/remote temperature and tach count conversions at
+ *                 the programmed conversion rate (or one-shot in standby)
+ *                 from scripted, piecewise-linear waveforms
+ *               - remote temp offset, remote temp LSB latch (MSB read) and
+ *                 tach count MSB latch (LSB read)
+ *               - ALERT status latching/clear-on-read, ALERT mask and
+ *                 ALERT callback (ALERT output asserted)
+ *               - lookup table with hysteresis, PWM value and lookup table
+ *                 write lock (PWM_RPM bit 5)
+ *               - read-only registers
+ *
+ *               SMBus errors can be injected (e.g. to test retries).
+ *
+ *               Each transaction costs a configurable latency. By default,
+ *               the simulated clock is advanced by the latency (virtual
+ *               time, deterministic). With LM63SIM_REALTIME, the clock
+ *               runs with the host time and the latency is spent by busy
+ *               waiting.
+ *
+ *     Required: libraries: usr_oss
+ *     \switches LM63SIM_OSS - provide OSS_GetSmbHdl() for host builds
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*-----------------------------------------+
+|  INCLUDES                                |
++-----------------------------------------*/
+#include <stdlib.h>
+#include <string.h>
+#include <MEN/men_typs.h>
+#include <MEN/usr_oss.h>
+#include <MEN/smb2.h>
+#include <MEN/lm63.h>
+#include <MEN/lm63_drv.h>
+#include <MEN/lm63_sim.h>
+#ifdef LM63SIM_OSS
+# include <MEN/oss.h>
+#endif
+
+static const char IdentString[]=MENT_XSTR(MAK_REVISION);
+
+/*-----------------------------------------+
+|  DEFINES                                 |
++-----------------------------------------*/
+#define PWM_RPM_PROGRAM		0x20		/**< PWM_RPM: PWM value/lookup table writable */
+#define LUT_NUM				8			/**< lookup table entries */
+#define ALST_CAUSE			0x7f		/**< ALERT status: all causes */
+#define TACH_NONE			0xffff		/**< tach count below min. rpm */
+
+/* default waveform values */
+#define DEF_TEMP			35000		/**< local temp [mC] */
+#define DEF_RMTTEMP			45000		/**< remote temp [mC] */
+#define DEF_FANSPEED		3000		/**< fan speed [rpm] */
+
+/*-----------------------------------------+
+|  TYPEDEFS                                |
++-----------------------------------------*/
+/** scripted waveform */
+typedef struct {
+	LM63SIM_POINT	point[LM63SIM_POINT_MAX];	/**< points (ascending time) */
+	u_int32			num;			/**< number of points (0=default value) */
+	u_int32			loop;			/**< repeat waveform */
+	u_int32			start;			/**< waveform start time [ms] */
+} WAVE;
+
+/** simulated LM63 device */
+struct LM63SIM_DEV {
+	LM63SIM_DEV		*next;			/**< next device on bus */
+	LM63SIM_BUS		*bus;			/**< bus of device */
+	u_int16			smbAddr;		/**< SMB address */
+	u_int32			tachPuls;		/**< pulse per revolution fan tachometer */
+	u_int8			reg[256];		/**< register file */
+	u_int8			rmtLsb;			/**< remote temp LSB latched by MSB read */
+	u_int8			tachMsb;		/**< tach count MSB latched by LSB read */
+	u_int8			alertLatch;		/**< latched ALERT status */
+	u_int8			alertCond;		/**< current ALERT conditions */
+	u_int32			alertOut;		/**< ALERT output asserted */
+	u_int32			alertFire;		/**< ALERT callback pending */
+	void			(*alertCb)(void*);	/**< ALERT callback */
+	void			*alertArg;		/**< ALERT callback argument */
+	u_int32			nextConv;		/**< time of next conversion [ms] */
+	u_int32			oneShot;		/**< one-shot conversion running */
+	u_int32			oneShotEnd;		/**< end of one-shot conversion [ms] */
+	u_int32			lutLevel;		/**< active lookup table entries */
+	WAVE			wave[LM63SIM_WAVE_NUM];	/**< scripted waveforms */
+};
+
+/** simulated SMBus */
+struct LM63SIM_BUS {
+	SMB_HANDLE		smb;			/**< SMB_HANDLE (must be first) */
+	u_int32			busNbr;			/**< bus number */
+	u_int32			flags;			/**< LM63SIM_xxx flags */
+	u_int32			byteUs;			/**< latency of byte transaction [us] */
+	u_int32			wordUs;			/**< latency of word transaction [us] */
+	u_int32			nowMs;			/**< virtual clock [ms] */
+	u_int32			nowUs;			/**< virtual clock fraction [us] */
+	u_int32			startMs;		/**< host time of bus creation [ms] */
+	LM63SIM_DEV		*devP;			/**< list of devices */
+	u_int32			errEvery;		/**< fail every n-th transaction (0=never) */
+	u_int32			errBurst;		/**< consecutive failing transactions */
+	int32			errCode;		/**< injected SMB_ERR_xxx */
+	u_int32			errCnt;			/**< transaction counter for injection */
+	LM63SIM_STATS	stats;			/**< statistics */
+};
+
+/*-----------------------------------------+
+|  GLOBALS                                 |
++-----------------------------------------*/
+/** registered buses (see LM63SIM_GetSmbHdl()) */
+static LM63SIM_BUS *G_bus[LM63SIM_BUS_MAX];
+
+/*-----------------------------------------+
+|  PROTOTYPES                              |
++-----------------------------------------*/
+static int32 SmbExit( void **smbHdlP );
+static int32 SmbReadByteData( void *smbHdl, u_int32 flags, u_int16 addr,
+							  u_int8 cmdAddr, u_int8 *dataP );
+static int32 SmbReadWordData( void *smbHdl, u_int32 flags, u_int16 addr,
+							  u_int8 cmdAddr, u_int16 *dataP );
+static int32 SmbWriteByteData( void *smbHdl, u_int32 flags, u_int16 addr,
+							   u_int8 cmdAddr, u_int8 data );
+static int32 SmbAlertCbInstall( void *smbHdl, u_int16 addr,
+								void (*cbFuncP)(void*), void *cbArg );
+static int32 SmbAlertCbRemove( void *smbHdl, u_int16 addr, void **cbArgP );
+static char* SmbIdent( void );
+static u_int32 Now( LM63SIM_BUS *bus );
+static int32 XferStart( LM63SIM_BUS *bus, u_int16 addr,
+						LM63SIM_DEV **devP );
+static void XferEnd( LM63SIM_BUS *bus, u_int32 us );
+static void DevUpdate( LM63SIM_DEV *dev, u_int32 now );
+static void DevConvert( LM63SIM_DEV *dev, u_int32 now );
+static void DevPwm( LM63SIM_DEV *dev );
+static void DevAlertOut( LM63SIM_DEV *dev );
+static u_int8 DevRead( LM63SIM_DEV *dev, u_int8 reg, u_int32 now );
+static void DevWrite( LM63SIM_DEV *dev, u_int8 reg, u_int8 val, u_int32 now );
+static int32 WaveValue( LM63SIM_DEV *dev, u_int32 wave, u_int32 now );
+
+/****************************** LM63SIM_BusCreate ****************************/
+/** Create a simulated SMBus
+ *
+ *  The bus is registered under its bus number for LM63SIM_GetSmbHdl().
+ *
+ *  \param busNbr     \IN  bus number (0..LM63SIM_BUS_MAX-1)
+ *  \param flags      \IN  LM63SIM_xxx flags
+ *  \param busP       \OUT created bus
+ *
+ *  \return            \c 0 On success or SMB_ERR_xxx error code
+ */
+int32 LM63SIM_BusCreate(
+	u_int32		busNbr,
+	u_int32		flags,
+	LM63SIM_BUS	**busP
+)
+{
+	LM63SIM_BUS	*bus;
+
+	*busP = NULL;
+
+	if( (busNbr >= LM63SIM_BUS_MAX) || G_bus[busNbr] )
+		return( SMB_ERR_PARAM );
+
+	if( (flags & LM63SIM_REALTIME) && UOS_MikroDelayInit() )
+		return( SMB_ERR_GENERAL );
+
+	if( (bus = (LM63SIM_BUS*)malloc( sizeof(LM63SIM_BUS) )) == NULL )
+		return( SMB_ERR_GENERAL );
+	memset( bus, 0, sizeof(LM63SIM_BUS) );
+
+	bus->smb.Exit			= SmbExit;
+	bus->smb.ReadByteData	= SmbReadByteData;
+	bus->smb.ReadWordData	= SmbReadWordData;
+	bus->smb.WriteByteData	= SmbWriteByteData;
+	bus->smb.AlertCbInstall	= SmbAlertCbInstall;
+	bus->smb.AlertCbRemove	= SmbAlertCbRemove;
+	bus->smb.Ident			= SmbIdent;
+
+	bus->busNbr  = busNbr;
+	bus->flags   = flags;
+	bus->startMs = UOS_MsecTimerGet();
+
+	/* 100kHz SMBus: byte data ~39 bits, word data ~48 bits */
+	bus->byteUs  = 390;
+	bus->wordUs  = 480;
+
+	G_bus[busNbr] = bus;
+	*busP = bus;
+	return( 0 );
+}
+
+/***************************** LM63SIM_BusDestroy ****************************/
+/** Destroy a simulated SMBus and its devices
+ *
+ *  \param busP       \IN  bus to destroy
+ *                    \OUT NULL
+ */
+void LM63SIM_BusDestroy(
+	LM63SIM_BUS	**busP
+)
+{
+	LM63SIM_BUS	*bus = *busP;
+	LM63SIM_DEV	*dev;
+
+	if( bus == NULL )
+		return;
+
+	while( (dev = bus->devP) != NULL ){
+		bus->devP = dev->next;
+		free( dev );
+	}
+
+	G_bus[bus->busNbr] = NULL;
+	free( bus );
+	*busP = NULL;
+}
+
+/******************************* LM63SIM_SmbHdl ******************************/
+/** Get SMB_HANDLE of a simulated SMBus
+ *
+ *  \param bus        \IN  bus
+ *
+ *  \return            SMB_HANDLE to pass to the LM63 driver
+ */
+SMB_HANDLE* LM63SIM_SmbHdl(
+	LM63SIM_BUS	*bus
+)
+{
+	return( &bus->smb );
+}
+
+/***************************** LM63SIM_GetSmbHdl *****************************/
+/** Get SMB_HANDLE of a registered simulated SMBus
+ *
+ *  Same as OSS_GetSmbHdl() for simulated buses.
+ *
+ *  \param busNbr     \IN  bus number
+ *  \param smbHdlP    \OUT SMB_HANDLE
+ *
+ *  \return            \c 0 On success or SMB_ERR_xxx error code
+ */
+int32 LM63SIM_GetSmbHdl(
+	u_int32		busNbr,
+	void		**smbHdlP
+)
+{
+	if( (busNbr >= LM63SIM_BUS_MAX) || (G_bus[busNbr] == NULL) )
+		return( SMB_ERR_NO_DEVICE );
+
+	*smbHdlP = (void*)&G_bus[busNbr]->smb;
+	return( 0 );
+}
+
+#ifdef LM63SIM_OSS
+/******************************* OSS_GetSmbHdl *******************************/
+/** Host build: OSS_GetSmbHdl() served by the simulated buses
+ *
+ *  \param osHdl      \IN  OSS handle (unused)
+ *  \param busNbr     \IN  bus number
+ *  \param smbHdlP    \OUT SMB_HANDLE
+ *
+ *  \return            \c 0 On success or SMB_ERR_xxx error code
+ */
+int32 OSS_GetSmbHdl(
+	OSS_HANDLE	*osHdl,
+	u_int32		busNbr,
+	void		**smbHdlP
+)
+{
+	return( LM63SIM_GetSmbHdl( busNbr, smbHdlP ) );
+}
+#endif /* LM63SIM_OSS */
+
+/****************************** LM63SIM_Latency ******************************/
+/** Set transaction latency
+ *
+ *  \param bus        \IN  bus
+ *  \param byteUs     \IN  latency of byte transactions [us]
+ *  \param wordUs     \IN  latency of word transactions [us]
+ */
+void LM63SIM_Latency(
+	LM63SIM_BUS	*bus,
+	u_int32		byteUs,
+	u_int32		wordUs
+)
+{
+	bus->byteUs = byteUs;
+	bus->wordUs = wordUs;
+}
+
+/****************************** LM63SIM_Advance ******************************/
+/** Advance simulated time
+ *
+ *  With LM63SIM_REALTIME, the caller is delayed instead.
+ *
+ *  \param bus        \IN  bus
+ *  \param ms         \IN  time [ms]
+ */
+void LM63SIM_Advance(
+	LM63SIM_BUS	*bus,
+	u_int32		ms
+)
+{
+	LM63SIM_DEV	*dev;
+
+	if( bus->flags & LM63SIM_REALTIME ){
+		UOS_Delay( ms );
+		return;
+	}
+
+	bus->nowMs += ms;
+
+	/* conversions and ALERTs meanwhile */
+	for( dev=bus->devP; dev; dev=dev->next )
+		DevUpdate( dev, bus->nowMs );
+	XferEnd( bus, 0 );
+}
+
+/****************************** LM63SIM_TimeGet ******************************/
+/** Get simulated time
+ *
+ *  \param bus        \IN  bus
+ *
+ *  \return            time since bus creation [ms]
+ */
+u_int32 LM63SIM_TimeGet(
+	LM63SIM_BUS	*bus
+)
+{
+	return( Now( bus ) );
+}
+
+/****************************** LM63SIM_StatsGet *****************************/
+/** Get bus statistics
+ *
+ *  \param bus        \IN  bus
+ *  \param statsP     \OUT statistics
+ *  \param clear      \IN  clear statistics after read
+ */
+void LM63SIM_StatsGet(
+	LM63SIM_BUS		*bus,
+	LM63SIM_STATS	*statsP,
+	u_int32			clear
+)
+{
+	*statsP = bus->stats;
+	if( clear )
+		memset( &bus->stats, 0, sizeof(LM63SIM_STATS) );
+}
+
+/****************************** LM63SIM_ErrInject ****************************/
+/** Inject SMBus errors
+ *
+ *  Of every errEvery transactions, the last errBurst transactions fail
+ *  with the given error (e.g. errEvery=10, errBurst=2: transactions 9, 10,
+ *  19, 20, ... fail).
+ *
+ *  \param bus        \IN  bus
+ *  \param errEvery   \IN  period of failing transactions (0=no errors)
+ *  \param errBurst   \IN  failing transactions per period (1..errEvery)
+ *  \param errCode    \IN  SMB_ERR_xxx error code to return
+ */
+void LM63SIM_ErrInject(
+	LM63SIM_BUS	*bus,
+	u_int32		errEvery,
+	u_int32		errBurst,
+	int32		errCode
+)
+{
+	if( errBurst > errEvery )
+		errBurst = errEvery;
+
+	bus->errEvery = errEvery;
+	bus->errBurst = errBurst;
+	bus->errCode  = errCode;
+	bus->errCnt   = 0;
+}
+
+/******************************* LM63SIM_DevAdd ******************************/
+/** Add a simulated LM63 to a bus
+ *
+ *  The device starts with its power-on register values and constant
+ *  default waveforms (35C local, 45C remote, 3000rpm).
+ *
+ *  \param bus        \IN  bus
+ *  \param smbAddr    \IN  SMB address (8-bit, e.g. 0x98)
+ *  \param tachPuls   \IN  pulse per revolution fan tachometer (1..3)
+ *  \param devP       \OUT created device
+ *
+ *  \return            \c 0 On success or SMB_ERR_xxx error code
+ */
+int32 LM63SIM_DevAdd(
+	LM63SIM_BUS	*bus,
+	u_int16		smbAddr,
+	u_int32		tachPuls,
+	LM63SIM_DEV	**devP
+)
+{
+	LM63SIM_DEV	*dev;
+
+	*devP = NULL;
+
+	if( (tachPuls < 1) || (tachPuls > 3) )
+		return( SMB_ERR_PARAM );
+
+	for( dev=bus->devP; dev; dev=dev->next ){
+		if( dev->smbAddr == smbAddr )
+			return( SMB_ERR_ADDR );
+	}
+
+	if( (dev = (LM63SIM_DEV*)malloc( sizeof(LM63SIM_DEV) )) == NULL )
+		return( SMB_ERR_GENERAL );
+	memset( dev, 0, sizeof(LM63SIM_DEV) );
+
+	dev->bus      = bus;
+	dev->smbAddr  = smbAddr;
+	dev->tachPuls = tachPuls;
+	LM63SIM_DevReset( dev );
+
+	dev->next = bus->devP;
+	bus->devP = dev;
+	*devP = dev;
+	return( 0 );
+}
+
+/****************************** LM63SIM_DevReset *****************************/
+/** Power-on reset of a simulated LM63
+ *
+ *  Waveforms and ALERT callback are kept.
+ *
+ *  \param dev        \IN  device
+ */
+void LM63SIM_DevReset(
+	LM63SIM_DEV	*dev
+)
+{
+	u_int32	n;
+
+	memset( dev->reg, 0, sizeof(dev->reg) );
+
+	dev->reg[LM63_CONVRATE]				= 0x08;
+	dev->reg[LM63_TEMP_HIGH]			= 0x46;
+	dev->reg[LM63_RMTTEMP_HIGH_MSB]		= 0x46;
+	dev->reg[LM63_RMTTEMP_LOW_MSB]		= 0x00;
+	dev->reg[LM63_RMTTEMP_TCRIT_SET]	= 0x55;
+	dev->reg[LM63_RMTTEMP_TCRIT_HYS]	= 0x0a;
+	dev->reg[LM63_TACH_LIMIT_LSB]		= 0xff;
+	dev->reg[LM63_TACH_LIMIT_MSB]		= 0xff;
+	dev->reg[LM63_TACH_COUNT_LSB]		= 0xff;
+	dev->reg[LM63_TACH_COUNT_MSB]		= 0xff;
+	dev->reg[LM63_FAN_SPINUP_CFG]		= 0x3f;
+	dev->reg[LM63_PWM_FREQU]			= 0x17;
+	dev->reg[LM63_LOOKUP_HYS]			= 0x04;
+	dev->reg[LM63_RMTTEMP_FILTER]		= 0x00;
+	dev->reg[LM63_MANUFACTURER_ID]		= 0x01;
+	dev->reg[LM63_STEPPING_DIE_REV]		= 0x41;
+
+	for( n=0; n<LUT_NUM; n++ ){
+		dev->reg[LM63_LOOKUP_TBL_TEMP(n)] = 0x7f;
+		dev->reg[LM63_LOOKUP_TBL_PWM(n)]  = 0x3f;
+	}
+
+	dev->rmtLsb     = 0;
+	dev->tachMsb    = 0xff;
+	dev->alertLatch = 0;
+	dev->alertCond  = 0;
+	dev->alertOut   = FALSE;
+	dev->alertFire  = FALSE;
+	dev->oneShot    = FALSE;
+	dev->lutLevel   = 0;
+
+	/* first conversion after power-up */
+	dev->nextConv = Now( dev->bus ) + LM63SIM_CONV_MS;
+}
+
+/****************************** LM63SIM_WaveSet ******************************/
+/** Set scripted waveform
+ *
+ *  The waveform starts now. Values between the points are interpolated
+ *  linearly, before the first/after the last point the first/last value
+ *  is used. A looped waveform repeats with the time of the last point as
+ *  period. num=0 restores the constant default value.
+ *
+ *  \param dev        \IN  device
+ *  \param wave       \IN  LM63SIM_WAVE_xxx
+ *  \param pointP     \IN  points (ascending time)
+ *  \param num        \IN  number of points (0..LM63SIM_POINT_MAX)
+ *  \param loop       \IN  repeat waveform
+ *
+ *  \return            \c 0 On success or SMB_ERR_xxx error code
+ */
+int32 LM63SIM_WaveSet(
+	LM63SIM_DEV			*dev,
+	u_int32				wave,
+	const LM63SIM_POINT	*pointP,
+	u_int32				num,
+	u_int32				loop
+)
+{
+	WAVE	*waveP;
+	u_int32	n;
+
+	if( (wave >= LM63SIM_WAVE_NUM) || (num > LM63SIM_POINT_MAX) )
+		return( SMB_ERR_PARAM );
+
+	for( n=1; n<num; n++ ){
+		if( pointP[n].time < pointP[n-1].time )
+			return( SMB_ERR_PARAM );
+	}
+
+	waveP = &dev->wave[wave];
+	for( n=0; n<num; n++ )
+		waveP->point[n] = pointP[n];
+	waveP->num   = num;
+	waveP->loop  = loop;
+	waveP->start = Now( dev->bus );
+
+	return( 0 );
+}
+
+/******************************* LM63SIM_RegGet ******************************/
+/** Backdoor register read (no side effects, no latency)
+ *
+ *  \param dev        \IN  device
+ *  \param reg        \IN  register offset
+ *
+ *  \return            register value
+ */
+u_int8 LM63SIM_RegGet(
+	LM63SIM_DEV	*dev,
+	u_int8		reg
+)
+{
+	if( reg == LM63_ALERT_STATE )
+		return( dev->alertLatch );
+
+	return( dev->reg[reg] );
+}
+
+/******************************* LM63SIM_RegSet ******************************/
+/** Backdoor register write (ignores write lock, no latency)
+ *
+ *  E.g. to simulate a device reprogrammed by another master.
+ *
+ *  \param dev        \IN  device
+ *  \param reg        \IN  register offset
+ *  \param val        \IN  register value
+ */
+void LM63SIM_RegSet(
+	LM63SIM_DEV	*dev,
+	u_int8		reg,
+	u_int8		val
+)
+{
+	dev->reg[reg] = val;
+	DevAlertOut( dev );
+}
+
+/********************************** SmbExit **********************************/
+/** SMB_HANDLE Exit: the bus is released by LM63SIM_BusDestroy()
+ *
+ *  \param smbHdlP    \IN  SMB_HANDLE
+ *
+ *  \return            \c 0
+ */
+static int32 SmbExit(
+	void		**smbHdlP
+)
+{
+	return( 0 );
+}
+
+/****************************** SmbReadByteData ******************************/
+/** SMB_HANDLE ReadByteData
+ *
+ *  \param smbHdl     \IN  SMB_HANDLE
+ *  \param flags      \IN  flags (unused)
+ *  \param addr       \IN  SMB address
+ *  \param cmdAddr    \IN  register offset
+ *  \param dataP      \OUT register value
+ *
+ *  \return            \c 0 On success or SMB_ERR_xxx error code
+ */
+static int32 SmbReadByteData(
+	void		*smbHdl,
+	u_int32		flags,
+	u_int16		addr,
+	u_int8		cmdAddr,
+	u_int8		*dataP
+)
+{
+	LM63SIM_BUS	*bus = (LM63SIM_BUS*)smbHdl;
+	LM63SIM_DEV	*dev;
+	int32		error;
+
+	if( (error = XferStart( bus, addr, &dev )) ){
+		XferEnd( bus, bus->byteUs );
+		return( error );
+	}
+
+	bus->stats.readByte++;
+	*dataP = DevRead( dev, cmdAddr, Now( bus ) );
+
+	XferEnd( bus, bus->byteUs );
+	return( 0 );
+}
+
+/****************************** SmbReadWordData ******************************/
+/** SMB_HANDLE ReadWordData
+ *
+ *  Reads register cmdAddr (low byte) and cmdAddr+1 (high byte), with the
+ *  same side effects as two byte reads.
+ *
+ *  \param smbHdl     \IN  SMB_HANDLE
+ *  \param flags      \IN  flags (unused)
+ *  \param addr       \IN  SMB address
+ *  \param cmdAddr    \IN  register offset
+ *  \param dataP      \OUT register values
+ *
+ *  \return            \c 0 On success or SMB_ERR_xxx error code
+ */
+static int32 SmbReadWordData(
+	void		*smbHdl,
+	u_int32		flags,
+	u_int16		addr,
+	u_int8		cmdAddr,
+	u_int16		*dataP
+)
+{
+	LM63SIM_BUS	*bus = (LM63SIM_BUS*)smbHdl;
+	LM63SIM_DEV	*dev;
+	u_int32		now;
+	u_int8		lo, hi;
+	int32		error;
+
+	if( (error = XferStart( bus, addr, &dev )) ){
+		XferEnd( bus, bus->wordUs );
+		return( error );
+	}
+
+	bus->stats.readWord++;
+	now = Now( bus );
+	lo  = DevRead( dev, cmdAddr, now );
+	hi  = DevRead( dev, (u_int8)(cmdAddr + 1), now );
+	*dataP = (u_int16)((hi << 8) | lo);
+
+	XferEnd( bus, bus->wordUs );
+	return( 0 );
+}
+
+/****************************** SmbWriteByteData *****************************/
+/** SMB_HANDLE WriteByteData
+ *
+ *  \param smbHdl     \IN  SMB_HANDLE
+ *  \param flags      \IN  flags (unused)
+ *  \param addr       \IN  SMB address
+ *  \param cmdAddr    \IN  register offset
+ *  \param data       \IN  register value
+ *
+ *  \return            \c 0 On success or SMB_ERR_xxx error code
+ */
+static int32 SmbWriteByteData(
+	void		*smbHdl,
+	u_int32		flags,
+	u_int16		addr,
+	u_int8		cmdAddr,
+	u_int8		data
+)
+{
+	LM63SIM_BUS	*bus = (LM63SIM_BUS*)smbHdl;
+	LM63SIM_DEV	*dev;
+	int32		error;
+
+	if( (error = XferStart( bus, addr, &dev )) ){
+		XferEnd( bus, bus->byteUs );
+		return( error );
+	}
+
+	bus->stats.writeByte++;
+	DevWrite( dev, cmdAddr, data, Now( bus ) );
+
+	XferEnd( bus, bus->byteUs );
+	return( 0 );
+}
+
+/***************************** SmbAlertCbInstall *****************************/
+/** SMB_HANDLE AlertCbInstall
+ *
+ *  \param smbHdl     \IN  SMB_HANDLE
+ *  \param addr       \IN  SMB address
+ *  \param cbFuncP    \IN  callback, called when ALERT output is asserted
+ *  \param cbArg      \IN  callback argument
+ *
+ *  \return            \c 0 On success or SMB_ERR_xxx error code
+ */
+static int32 SmbAlertCbInstall(
+	void		*smbHdl,
+	u_int16		addr,
+	void		(*cbFuncP)(void*),
+	void		*cbArg
+)
+{
+	LM63SIM_BUS	*bus = (LM63SIM_BUS*)smbHdl;
+	LM63SIM_DEV	*dev;
+
+	for( dev=bus->devP; dev; dev=dev->next ){
+		if( dev->smbAddr == addr ){
+			if( dev->alertCb )
+				return( SMB_ERR_BUSY );
+			dev->alertArg = cbArg;
+			dev->alertCb  = cbFuncP;
+			return( 0 );
+		}
+	}
+
+	return( SMB_ERR_NO_DEVICE );
+}
+
+/****************************** SmbAlertCbRemove *****************************/
+/** SMB_HANDLE AlertCbRemove
+ *
+ *  \param smbHdl     \IN  SMB_HANDLE
+ *  \param addr       \IN  SMB address
+ *  \param cbArgP     \OUT callback argument
+ *
+ *  \return            \c 0 On success or SMB_ERR_xxx error code
+ */
+static int32 SmbAlertCbRemove(
+	void		*smbHdl,
+	u_int16		addr,
+	void		**cbArgP
+)
+{
+	LM63SIM_BUS	*bus = (LM63SIM_BUS*)smbHdl;
+	LM63SIM_DEV	*dev;
+
+	for( dev=bus->devP; dev; dev=dev->next ){
+		if( dev->smbAddr == addr ){
+			*cbArgP = dev->alertArg;
+			dev->alertCb  = NULL;
+			dev->alertArg = NULL;
+			return( 0 );
+		}
+	}
+
+	return( SMB_ERR_NO_DEVICE );
+}
+
+/********************************** SmbIdent *********************************/
+/** SMB_HANDLE Ident
+ *
+ *  \return            ident string
+ */
+static char* SmbIdent( void )
+{
+	return( (char*)IdentString );
+}
+
+/************************************ Now ************************************/
+/** Get simulated time
+ *
+ *  \param bus        \IN  bus
+ *
+ *  \return            time since bus creation [ms]
+ */
+static u_int32 Now(
+	LM63SIM_BUS	*bus
+)
+{
+	if( bus->flags & LM63SIM_REALTIME )
+		return( UOS_MsecTimerGet() - bus->startMs );
+
+	return( bus->nowMs );
+}
+
+/********************************* XferStart *********************************/
+/** Start transaction: bring all devices up to date, find addressed device
+ *
+ *  \param bus        \IN  bus
+ *  \param addr       \IN  SMB address
+ *  \param devP       \OUT addressed device
+ *
+ *  \return            \c 0 On success or SMB_ERR_xxx error code
+ */
+static int32 XferStart(
+	LM63SIM_BUS	*bus,
+	u_int16		addr,
+	LM63SIM_DEV	**devP
+)
+{
+	LM63SIM_DEV	*dev, *found = NULL;
+	u_int32		now = Now( bus );
+
+	for( dev=bus->devP; dev; dev=dev->next ){
+		DevUpdate( dev, now );
+		if( dev->smbAddr == addr )
+			found = dev;
+	}
+
+	/* injected error: errBurst transactions of every errEvery */
+	if( bus->errEvery &&
+		((bus->errCnt++ % bus->errEvery) >= bus->errEvery - bus->errBurst) ){
+		bus->stats.injected++;
+		return( bus->errCode );
+	}
+
+	if( found == NULL ){
+		bus->stats.nack++;
+		return( SMB_ERR_NO_DEVICE );
+	}
+
+	*devP = found;
+	return( 0 );
+}
+
+/********************************** XferEnd **********************************/
+/** End transaction: spend latency, call pending ALERT callbacks
+ *
+ *  The callbacks are called outside of the register access, like an
+ *  SMBus controller calls them from its ALERT interrupt.
+ *
+ *  \param bus        \IN  bus
+ *  \param us         \IN  latency [us]
+ */
+static void XferEnd(
+	LM63SIM_BUS	*bus,
+	u_int32		us
+)
+{
+	LM63SIM_DEV	*dev;
+
+	bus->stats.busUs += us;
+
+	if( bus->flags & LM63SIM_REALTIME ){
+		if( us )
+			UOS_MikroDelay( us );
+	}
+	else {
+		bus->nowUs += us;
+		bus->nowMs += bus->nowUs / 1000;
+		bus->nowUs %= 1000;
+	}
+
+	for( dev=bus->devP; dev; dev=dev->next ){
+		if( dev->alertFire ){
+			dev->alertFire = FALSE;
+			if( dev->alertCb ){
+				bus->stats.alerts++;
+				dev->alertCb( dev->alertArg );
+			}
+		}
+	}
+}
+
+/********************************* DevUpdate *********************************/
+/** Run conversions up to now
+ *
+ *  Missed conversions (e.g. long idle time) are collapsed into the latest
+ *  one.
+ *
+ *  \param dev        \IN  device
+ *  \param now        \IN  time [ms]
+ */
+static void DevUpdate(
+	LM63SIM_DEV	*dev,
+	u_int32		now
+)
+{
+	u_int8	rate = dev->reg[LM63_CONVRATE];
+	u_int32	period = (rate >= 0x09) ? 31 : (16000 >> rate);
+
+	if( dev->reg[LM63_CFG] & LM63_CFG_STANDBY ){
+		if( dev->oneShot && ((int32)(now - dev->oneShotEnd) >= 0) ){
+			dev->oneShot = FALSE;
+			DevConvert( dev, dev->oneShotEnd );
+		}
+		/* continuous conversions start when leaving standby */
+		dev->nextConv = now + LM63SIM_CONV_MS;
+		return;
+	}
+
+	if( (int32)(now - dev->nextConv) >= 0 ){
+		dev->nextConv += ((now - dev->nextConv) / period) * period;
+		DevConvert( dev, dev->nextConv );
+		dev->nextConv += period;
+	}
+}
+
+/********************************* DevConvert ********************************/
+/** Conversion: update measurement registers, PWM and ALERT status
+ *
+ *  \param dev        \IN  device
+ *  \param now        \IN  time of conversion [ms]
+ */
+static void DevConvert(
+	LM63SIM_DEV	*dev,
+	u_int32		now
+)
+{
+	u_int8	*reg = dev->reg;
+	int32	val, rmt, high, low, count, limit;
+	u_int8	cond = 0;
+
+	dev->bus->stats.conversions++;
+
+	/* local temp [C] */
+	val = WaveValue( dev, LM63SIM_WAVE_TEMP, now );
+	val = (val >= 0) ? (val + 500) / 1000 : (val - 500) / 1000;
+	if( val > 127 )
+		val = 127;
+	if( val < -128 )
+		val = -128;
+	reg[LM63_TEMP] = (u_int8)val;
+
+	/* remote temp + offset [1/256 C], 0.125C resolution */
+	val = WaveValue( dev, LM63SIM_WAVE_RMTTEMP, now ) +
+		(int32)(int8)reg[LM63_RMTTEMP_OFF_MSB] * 1000 +
+		(reg[LM63_RMTTEMP_OFF_LSB] >> 5) * 125;
+	val = (val * 32) / 125;
+	if( val > 0x7fff )
+		val = 0x7fff;
+	if( val < -0x8000 )
+		val = -0x8000;
+	reg[LM63_RMTTEMP_MSB] = (u_int8)((val >> 8) & 0xff);
+	reg[LM63_RMTTEMP_LSB] = (u_int8)(val & 0xe0);
+
+	/* tach count */
+	val = WaveValue( dev, LM63SIM_WAVE_FANSPEED, now );
+	count = (val > 0) ? (2 * 5400000) / (int32)(dev->tachPuls * val) :
+		TACH_NONE;
+	if( count >= TACH_NONE )
+		count = TACH_NONE;
+	if( count < 1 )
+		count = 1;
+	reg[LM63_TACH_COUNT_LSB] = (u_int8)(count & 0xff);
+	reg[LM63_TACH_COUNT_MSB] = (u_int8)(count >> 8);
+
+	/* ALERT conditions */
+	rmt   = (int16)((reg[LM63_RMTTEMP_MSB] << 8) | reg[LM63_RMTTEMP_LSB]);
+	high  = (int16)((reg[LM63_RMTTEMP_HIGH_MSB] << 8) |
+					reg[LM63_RMTTEMP_HIGH_LSB]);
+	low   = (int16)((reg[LM63_RMTTEMP_LOW_MSB] << 8) |
+					reg[LM63_RMTTEMP_LOW_LSB]);
+	limit = (reg[LM63_TACH_LIMIT_MSB] << 8) | reg[LM63_TACH_LIMIT_LSB];
+
+	if( (int8)reg[LM63_TEMP] > (int8)reg[LM63_TEMP_HIGH] )
+		cond |= LM63_ALERT_LHIGH;
+	if( rmt > high )
+		cond |= LM63_ALERT_RHIGH;
+	if( rmt < low )
+		cond |= LM63_ALERT_RLOW;
+
+	/* TCRIT with hysteresis */
+	val = (int8)reg[LM63_RMTTEMP_MSB];
+	if( (val > (int8)reg[LM63_RMTTEMP_TCRIT_SET]) ||
+		((dev->alertCond & LM63_ALERT_RCRIT) &&
+		 (val > (int8)reg[LM63_RMTTEMP_TCRIT_SET] -
+		  (int32)reg[LM63_RMTTEMP_TCRIT_HYS])) )
+		cond |= LM63_ALERT_RCRIT;
+
+	if( count > limit )
+		cond |= LM63_ALERT_TACH;
+
+	dev->alertCond   = cond;
+	dev->alertLatch |= cond;
+
+	DevPwm( dev );
+	DevAlertOut( dev );
+}
+
+/*********************************** DevPwm **********************************/
+/** Lookup table: PWM value from remote temp
+ *
+ *  The active entry is the highest entry whose temp is reached. An entry
+ *  is left downwards when the temp drops below its temp minus the lookup
+ *  table hysteresis. With PWM_RPM bit 5 set, the PWM value is programmed
+ *  directly.
+ *
+ *  \param dev        \IN  device
+ */
+static void DevPwm(
+	LM63SIM_DEV	*dev
+)
+{
+	u_int8	*reg = dev->reg;
+	int32	rmt = (int8)reg[LM63_RMTTEMP_MSB];
+	int32	hys = reg[LM63_LOOKUP_HYS] & 0x1f;
+	u_int32	level = 0;
+
+	if( reg[LM63_PWM_RPM] & PWM_RPM_PROGRAM )
+		return;
+
+	while( (level < LUT_NUM) &&
+		   (rmt >= (int32)reg[LM63_LOOKUP_TBL_TEMP(level)]) )
+		level++;
+
+	if( level > dev->lutLevel )
+		dev->lutLevel = level;
+
+	while( (dev->lutLevel > level) &&
+		   (rmt < (int32)reg[LM63_LOOKUP_TBL_TEMP(dev->lutLevel-1)] - hys) )
+		dev->lutLevel--;
+
+	reg[LM63_PWM_VALUE] = dev->lutLevel ?
+		reg[LM63_LOOKUP_TBL_PWM(dev->lutLevel-1)] : 0x00;
+}
+
+/********************************* DevAlertOut ******************************/
+/** Evaluate ALERT output, request callback on assertion
+ *
+ *  \param dev        \IN  device
+ */
+static void DevAlertOut(
+	LM63SIM_DEV	*dev
+)
+{
+	u_int32	out;
+
+	out = !(dev->reg[LM63_CFG] & LM63_CFG_ALERT_MASK) &&
+		(dev->alertLatch & ~dev->reg[LM63_ALERT_MASK] & ALST_CAUSE);
+
+	if( out && !dev->alertOut )
+		dev->alertFire = TRUE;
+
+	dev->alertOut = out;
+}
+
+/********************************** DevRead **********************************/
+/** Register read with side effects
+ *
+ *  \param dev        \IN  device
+ *  \param reg        \IN  register offset
+ *  \param now        \IN  time [ms]
+ *
+ *  \return            register value
+ */
+static u_int8 DevRead(
+	LM63SIM_DEV	*dev,
+	u_int8		reg,
+	u_int32		now
+)
+{
+	u_int8	val;
+	u_int32	busy;
+
+	switch( reg ){
+	case LM63_ALERT_STATE:
+		if( dev->reg[LM63_CFG] & LM63_CFG_STANDBY )
+			busy = dev->oneShot;
+		else
+			busy = (dev->nextConv - now) <= LM63SIM_CONV_MS;
+
+		/* clear-on-read of inactive causes */
+		val = (u_int8)(dev->alertLatch | (busy ? LM63_ALST_BUSY : 0));
+		dev->alertLatch = dev->alertCond;
+		DevAlertOut( dev );
+		return( val );
+
+	case LM63_RMTTEMP_MSB:
+		dev->rmtLsb = dev->reg[LM63_RMTTEMP_LSB];
+		return( dev->reg[LM63_RMTTEMP_MSB] );
+
+	case LM63_RMTTEMP_LSB:
+		return( dev->rmtLsb );
+
+	case LM63_TACH_COUNT_LSB:
+		dev->tachMsb = dev->reg[LM63_TACH_COUNT_MSB];
+		return( dev->reg[LM63_TACH_COUNT_LSB] );
+
+	case LM63_TACH_COUNT_MSB:
+		return( dev->tachMsb );
+
+	case LM63_ONESHOT:
+		return( 0x00 );
+
+	default:
+		return( dev->reg[reg] );
+	}
+}
+
+/********************************* DevWrite **********************************/
+/** Register write with write lock
+ *
+ *  \param dev        \IN  device
+ *  \param reg        \IN  register offset
+ *  \param val        \IN  register value
+ *  \param now        \IN  time [ms]
+ */
+static void DevWrite(
+	LM63SIM_DEV	*dev,
+	u_int8		reg,
+	u_int8		val,
+	u_int32		now
+)
+{
+	switch( reg ){
+	/* read-only */
+	case LM63_TEMP:
+	case LM63_RMTTEMP_MSB:
+	case LM63_RMTTEMP_LSB:
+	case LM63_ALERT_STATE:
+	case LM63_TACH_COUNT_LSB:
+	case LM63_TACH_COUNT_MSB:
+	case LM63_MANUFACTURER_ID:
+	case LM63_STEPPING_DIE_REV:
+		dev->bus->stats.lockedWrites++;
+		return;
+
+	/* one-shot conversion in standby */
+	case LM63_ONESHOT:
+		if( (dev->reg[LM63_CFG] & LM63_CFG_STANDBY) && !dev->oneShot ){
+			dev->oneShot    = TRUE;
+			dev->oneShotEnd = now + LM63SIM_CONV_MS;
+		}
+		return;
+
+	default:
+		break;
+	}
+
+	/* PWM value and lookup table: writable only with PWM_RPM bit 5 */
+	if( ((reg == LM63_PWM_VALUE) ||
+		 ((reg >= LM63_LOOKUP_TBL_TEMP(0)) &&
+		  (reg <= LM63_LOOKUP_TBL_PWM(LUT_NUM-1)))) &&
+		!(dev->reg[LM63_PWM_RPM] & PWM_RPM_PROGRAM) ){
+		dev->bus->stats.lockedWrites++;
+		return;
+	}
+
+	dev->reg[reg] = val;
+
+	if( (reg == LM63_CFG) || (reg == LM63_ALERT_MASK) )
+		DevAlertOut( dev );
+}
+
+/********************************* WaveValue *********************************/
+/** Waveform value at a time
+ *
+ *  \param dev        \IN  device
+ *  \param wave       \IN  LM63SIM_WAVE_xxx
+ *  \param now        \IN  time [ms]
+ *
+ *  \return            interpolated value
+ */
+static int32 WaveValue(
+	LM63SIM_DEV	*dev,
+	u_int32		wave,
+	u_int32		now
+)
+{
+	static const int32 dflt[LM63SIM_WAVE_NUM] =
+		{ DEF_TEMP, DEF_RMTTEMP, DEF_FANSPEED };
+	WAVE			*waveP = &dev->wave[wave];
+	LM63SIM_POINT	*p0, *p1;
+	u_int32			t, n;
+
+	if( waveP->num == 0 )
+		return( dflt[wave] );
+
+	t  = now - waveP->start;
+	p0 = &waveP->point[0];
+	p1 = &waveP->point[waveP->num-1];
+
+	if( waveP->loop && p1->time )
+		t %= p1->time;
+
+	if( t <= p0->time )
+		return( p0->value );
+	if( t >= p1->time )
+		return( p1->value );
+
+	for( n=1; waveP->point[n].time <= t; n++ )
+		;
+	p0 = &waveP->point[n-1];
+	p1 = &waveP->point[n];
+
+	return( p0->value + (int32)((double)(p1->value - p0->value) *
+								(t - p0->time) / (p1->time - p0->time)) );
+}
@@ -0,0 +1,650 @@
+/*********************  P r o g r a m  -  M o d u l e ***********************/
+/*!
+ *        \file  lm63_trc.c
+ *
+ *      \author  dieter.pfeuffer@men.de
+ *
+ *       \brief  LM63 binary trace library
+ *
+ *               Encoder and streaming decoder of the compact binary trace
+ *               format (see lm63_trc.h). Records are delta and varint
+ *               encoded: a 1 Hz three-channel recording takes 2..5 bytes
+ *               per record instead of about 60 bytes of text.
+ *
+ *               The encoder collects the records of a block in its state
+ *               and passes complete blocks to a write function. The decoder
+ *               is fed with arbitrary chunks of the stream and returns one
+ *               header or record at a time, so it needs no file access.
+ *
+ *     Required: -
+ *     \switches (none)
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*-----------------------------------------+
+|  INCLUDES                                |
++-----------------------------------------*/
+#include <string.h>
+#include <MEN/men_typs.h>
+#include <MEN/lm63_trc.h>
+
+/*-----------------------------------------+
+|  DEFINES                                 |
++-----------------------------------------*/
+#define VARINT_MAX		5			/**< max. bytes of a 32-bit varint */
+#define BLK_PREFIX_MAX	(1 + 3*VARINT_MAX)	/**< max. bytes before payload */
+#define DT_MAX			0x7fffffff	/**< max. record time difference [ms] */
+
+/* varint parse results */
+#define PARSE_OK		0			/**< value parsed */
+#define PARSE_MORE		1			/**< more data required */
+#define PARSE_BAD		2			/**< no valid varint */
+
+/*-----------------------------------------+
+|  PROTOTYPES                              |
++-----------------------------------------*/
+static u_int32 PutVarint( u_int8 *p, u_int32 val );
+static int32 GetVarint( const u_int8 *buf, u_int32 *posP, u_int32 end,
+						u_int32 *valP );
+static u_int32 ZigZag( int32 val );
+static int32 UnZigZag( u_int32 val );
+static u_int16 Fletcher16( const u_int8 *p, u_int32 len );
+static void TimeAdd( u_int32 *secP, u_int32 *msP, u_int32 dt );
+static int32 DecHdr( LM63TRC_DEC *dec );
+static int32 DecBlk( LM63TRC_DEC *dec );
+static int32 DecRec( LM63TRC_DEC *dec, LM63TRC_REC *recP );
+static void DecSkip( LM63TRC_DEC *dec );
+
+/********************************* PutVarint *********************************/
+/** Encode unsigned varint (LEB128)
+ *
+ *  \param p          \OUT buffer (VARINT_MAX bytes)
+ *  \param val        \IN  value
+ *
+ *  \return            number of bytes
+ */
+static u_int32 PutVarint(
+	u_int8	*p,
+	u_int32	val
+)
+{
+	u_int32	n = 0;
+
+	while( val >= 0x80 ){
+		p[n++] = (u_int8)(val | 0x80);
+		val >>= 7;
+	}
+	p[n++] = (u_int8)val;
+
+	return( n );
+}
+
+/********************************* GetVarint *********************************/
+/** Decode unsigned varint (LEB128)
+ *
+ *  \param buf        \IN  buffer
+ *  \param posP       \INOUT read position (advanced if PARSE_OK)
+ *  \param end        \IN  end of valid data
+ *  \param valP       \OUT value
+ *
+ *  \return            PARSE_xxx
+ */
+static int32 GetVarint(
+	const u_int8	*buf,
+	u_int32			*posP,
+	u_int32			end,
+	u_int32			*valP
+)
+{
+	u_int32	pos = *posP, val = 0, shift = 0;
+	u_int8	b;
+
+	do {
+		if( shift >= 7*VARINT_MAX )
+			return( PARSE_BAD );
+		if( pos >= end )
+			return( PARSE_MORE );
+		b = buf[pos++];
+		val |= (u_int32)(b & 0x7f) << shift;
+		shift += 7;
+	} while( b & 0x80 );
+
+	*valP = val;
+	*posP = pos;
+	return( PARSE_OK );
+}
+
+/********************************** ZigZag ***********************************/
+/** Map signed to unsigned value (0,-1,1,-2,... -> 0,1,2,3,...)
+ *
+ *  \param val        \IN  signed value
+ *
+ *  \return            unsigned value
+ */
+static u_int32 ZigZag(
+	int32	val
+)
+{
+	if( val < 0 )
+		return( ((u_int32)(-(val + 1)) << 1) | 1 );
+
+	return( (u_int32)val << 1 );
+}
+
+/********************************* UnZigZag **********************************/
+/** Map unsigned to signed value (inverse of ZigZag())
+ *
+ *  \param val        \IN  unsigned value
+ *
+ *  \return            signed value
+ */
+static int32 UnZigZag(
+	u_int32	val
+)
+{
+	if( val & 1 )
+		return( -(int32)(val >> 1) - 1 );
+
+	return( (int32)(val >> 1) );
+}
+
+/******************************** Fletcher16 *********************************/
+/** Compute Fletcher-16 checksum
+ *
+ *  \param p          \IN  data
+ *  \param len        \IN  length [bytes]
+ *
+ *  \return            checksum
+ */
+static u_int16 Fletcher16(
+	const u_int8	*p,
+	u_int32			len
+)
+{
+	u_int32	sum1 = 0, sum2 = 0;
+
+	while( len-- ){
+		sum1 = (sum1 + *p++) % 255;
+		sum2 = (sum2 + sum1) % 255;
+	}
+
+	return( (u_int16)((sum2 << 8) | sum1) );
+}
+
+/********************************** TimeAdd **********************************/
+/** Advance time
+ *
+ *  \param secP       \INOUT time [s]
+ *  \param msP        \INOUT time, fraction [ms]
+ *  \param dt         \IN  time difference [ms]
+ */
+static void TimeAdd(
+	u_int32	*secP,
+	u_int32	*msP,
+	u_int32	dt
+)
+{
+	*secP += dt / 1000;
+	*msP  += dt % 1000;
+	if( *msP >= 1000 ){
+		*msP -= 1000;
+		(*secP)++;
+	}
+}
+
+/****************************** LM63TRC_EncInit ******************************/
+/** Initialize encoder and write stream header
+ *
+ *  \param enc        \OUT encoder state
+ *  \param hdrP       \IN  stream header
+ *  \param blkRecs    \IN  max. records per block (0=limited by size only),
+ *                         a smaller value loses less data on a crash
+ *  \param writeFn    \IN  write function
+ *  \param arg        \IN  argument of write function
+ *
+ *  \return            \c 0 On success or LM63TRC_ERR_xxx error code
+ */
+int32 LM63TRC_EncInit(
+	LM63TRC_ENC			*enc,
+	const LM63TRC_HDR	*hdrP,
+	u_int32				blkRecs,
+	LM63TRC_WRITE		*writeFn,
+	void				*arg
+)
+{
+	u_int8	buf[LM63TRC_HDR_MAX];
+	u_int32	n = 0, identLen;
+
+	if( !hdrP->chMask || (hdrP->chMask >> LM63TRC_CH_MAX) )
+		return( LM63TRC_ERR_PARAM );
+
+	memset( enc, 0, sizeof(*enc) );
+	enc->writeFn = writeFn;
+	enc->arg     = arg;
+	enc->chMask  = hdrP->chMask;
+	enc->blkRecs = blkRecs;
+
+	identLen = (u_int32)strlen( hdrP->ident );
+	if( identLen > LM63TRC_IDENT_MAX-1 )
+		identLen = LM63TRC_IDENT_MAX-1;
+
+	buf[n++] = 'L';
+	buf[n++] = '6';
+	buf[n++] = '3';
+	buf[n++] = 'T';
+	buf[n++] = LM63TRC_VERSION;
+	n += PutVarint( &buf[n], hdrP->smbAddr );
+	n += PutVarint( &buf[n], hdrP->tempUnit );
+	n += PutVarint( &buf[n], hdrP->chMask );
+	n += PutVarint( &buf[n], hdrP->startSec );
+	n += PutVarint( &buf[n], identLen );
+	memcpy( &buf[n], hdrP->ident, identLen );
+	n += identLen;
+
+	if( enc->writeFn( enc->arg, buf, n ) )
+		return( LM63TRC_ERR_WRITE );
+
+	return( 0 );
+}
+
+/****************************** LM63TRC_EncPut *******************************/
+/** Encode record
+ *
+ *  The record is added to the current block. The block is written when it
+ *  is full, see also LM63TRC_EncFlush().
+ *
+ *  \param enc        \INOUT encoder state
+ *  \param timeMs     \IN  time [ms] (any free running ms counter, wraps)
+ *  \param valP       \IN  values (index: channel, LM63TRC_CH_MAX entries,
+ *                         only recorded channels are used)
+ *
+ *  \return            \c 0 On success or LM63TRC_ERR_xxx error code
+ */
+int32 LM63TRC_EncPut(
+	LM63TRC_ENC	*enc,
+	u_int32		timeMs,
+	const int32	*valP
+)
+{
+	u_int32	dt = 0, ch, same;
+	u_int8	*p;
+	int32	error;
+
+	if( enc->started ){
+		dt = timeMs - enc->time;
+		TimeAdd( &enc->sec, &enc->ms, dt );
+	}
+	enc->started = TRUE;
+	enc->time    = timeMs;
+
+	/* start new block if full or time difference not encodable */
+	if( (enc->len + LM63TRC_REC_MAX > LM63TRC_BLK_MAX) ||
+		(enc->blkRecs && (enc->recs >= enc->blkRecs)) ||
+		(dt > DT_MAX) ){
+		if( (error = LM63TRC_EncFlush( enc )) )
+			return( error );
+	}
+
+	if( enc->recs == 0 ){
+		enc->blkSec = enc->sec;
+		enc->blkMs  = enc->ms;
+		memset( enc->prev, 0, sizeof(enc->prev) );
+		dt = 0;
+	}
+
+	same = (enc->recs > 0);
+	for( ch=0; ch<LM63TRC_CH_MAX; ch++ ){
+		if( (enc->chMask & (1 << ch)) && (valP[ch] != enc->prev[ch]) )
+			same = FALSE;
+	}
+
+	p = &enc->blk[enc->len];
+	p += PutVarint( p, (dt << 1) | same );
+	if( !same ){
+		for( ch=0; ch<LM63TRC_CH_MAX; ch++ ){
+			if( !(enc->chMask & (1 << ch)) )
+				continue;
+			p += PutVarint( p, ZigZag( valP[ch] - enc->prev[ch] ) );
+			enc->prev[ch] = valP[ch];
+		}
+	}
+
+	enc->len = (u_int32)(p - enc->blk);
+	enc->recs++;
+
+	return( 0 );
+}
+
+/***************************** LM63TRC_EncFlush ******************************/
+/** Write current block
+ *
+ *  Call before closing the stream and whenever the recorded data must be
+ *  written (e.g. periodically).
+ *
+ *  \param enc        \INOUT encoder state
+ *
+ *  \return            \c 0 On success or LM63TRC_ERR_xxx error code
+ */
+int32 LM63TRC_EncFlush(
+	LM63TRC_ENC	*enc
+)
+{
+	u_int8	pre[BLK_PREFIX_MAX], chk[2];
+	u_int32	n = 0;
+	u_int16	sum;
+	int32	error;
+
+	if( enc->recs == 0 )
+		return( 0 );
+
+	pre[n++] = LM63TRC_SYNC;
+	n += PutVarint( &pre[n], enc->len );
+	n += PutVarint( &pre[n], enc->blkSec );
+	n += PutVarint( &pre[n], enc->blkMs );
+
+	sum = Fletcher16( enc->blk, enc->len );
+	chk[0] = (u_int8)(sum & 0xff);
+	chk[1] = (u_int8)(sum >> 8);
+
+	error = enc->writeFn( enc->arg, pre, n ) ||
+			enc->writeFn( enc->arg, enc->blk, enc->len ) ||
+			enc->writeFn( enc->arg, chk, 2 );
+
+	/* block is dropped on write error */
+	enc->recs = 0;
+	enc->len  = 0;
+
+	return( error ? LM63TRC_ERR_WRITE : 0 );
+}
+
+/****************************** LM63TRC_DecInit ******************************/
+/** Initialize decoder
+ *
+ *  \param dec        \OUT decoder state
+ */
+void LM63TRC_DecInit(
+	LM63TRC_DEC	*dec
+)
+{
+	memset( dec, 0, sizeof(*dec) );
+}
+
+/****************************** LM63TRC_DecPut *******************************/
+/** Feed stream data into decoder
+ *
+ *  Takes as much data as fits into the decoder buffer. Call LM63TRC_DecGet()
+ *  until it returns LM63TRC_EV_NONE before feeding the rest.
+ *
+ *  \param dec        \INOUT decoder state
+ *  \param buf        \IN  stream data
+ *  \param len        \IN  length [bytes]
+ *
+ *  \return            number of bytes taken
+ */
+u_int32 LM63TRC_DecPut(
+	LM63TRC_DEC		*dec,
+	const u_int8	*buf,
+	u_int32			len
+)
+{
+	/* discard consumed data */
+	if( dec->rd ){
+		memmove( dec->buf, &dec->buf[dec->rd], dec->wr - dec->rd );
+		dec->wr -= dec->rd;
+		if( dec->inBlk ){
+			dec->pos -= dec->rd;
+			dec->end -= dec->rd;
+		}
+		dec->rd = 0;
+	}
+
+	if( len > LM63TRC_DEC_BUF - dec->wr )
+		len = LM63TRC_DEC_BUF - dec->wr;
+
+	memcpy( &dec->buf[dec->wr], buf, len );
+	dec->wr += len;
+
+	return( len );
+}
+
+/****************************** LM63TRC_DecGet *******************************/
+/** Decode next header or record
+ *
+ *  Damaged data (bad checksum, illegal header, blocks without preceding
+ *  header) is skipped up to the next possible block or header start and
+ *  counted in the errors field. Data left in the buffer at the end of the
+ *  stream (wr != rd) is an incomplete block, e.g. of an interrupted
+ *  recording.
+ *
+ *  \param dec        \INOUT decoder state
+ *  \param recP       \OUT record (if LM63TRC_EV_REC)
+ *
+ *  \return            LM63TRC_EV_xxx event or LM63TRC_ERR_FORMAT
+ */
+int32 LM63TRC_DecGet(
+	LM63TRC_DEC	*dec,
+	LM63TRC_REC	*recP
+)
+{
+	int32	ev;
+
+	for(;;){
+		/* records of current block */
+		if( dec->inBlk ){
+			if( dec->pos < dec->end )
+				return( DecRec( dec, recP ) );
+
+			/* skip checksum */
+			dec->inBlk = FALSE;
+			dec->rd = dec->end + 2;
+		}
+
+		if( dec->rd == dec->wr )
+			return( LM63TRC_EV_NONE );
+
+		if( dec->buf[dec->rd] == LM63TRC_SYNC )
+			ev = DecBlk( dec );
+		else
+			ev = DecHdr( dec );
+
+		/* block started: decode its records */
+		if( ev == LM63TRC_EV_NONE && dec->inBlk )
+			continue;
+
+		return( ev );
+	}
+}
+
+/********************************** DecHdr ***********************************/
+/** Decode stream header at read position
+ *
+ *  \param dec        \INOUT decoder state
+ *
+ *  \return            LM63TRC_EV_HDR, LM63TRC_EV_NONE or LM63TRC_ERR_FORMAT
+ */
+static int32 DecHdr(
+	LM63TRC_DEC	*dec
+)
+{
+	static const u_int8 magic[4] = { 'L', '6', '3', 'T' };
+	LM63TRC_HDR	hdr;
+	u_int32		pos = dec->rd, identLen, ch, n;
+	u_int32		*fieldP[4];
+	int32		rv = PARSE_OK;
+
+	/* magic and version */
+	for( n=0; n<5; n++ ){
+		if( pos + n >= dec->wr )
+			return( LM63TRC_EV_NONE );
+		if( (n < 4) ? (dec->buf[pos+n] != magic[n]) :
+			(dec->buf[pos+n] != LM63TRC_VERSION) )
+			goto bad;
+	}
+	pos += 5;
+
+	memset( &hdr, 0, sizeof(hdr) );
+	fieldP[0] = &hdr.smbAddr;
+	fieldP[1] = &hdr.tempUnit;
+	fieldP[2] = &hdr.chMask;
+	fieldP[3] = &hdr.startSec;
+
+	for( n=0; n<4 && rv==PARSE_OK; n++ )
+		rv = GetVarint( dec->buf, &pos, dec->wr, fieldP[n] );
+	if( rv == PARSE_OK )
+		rv = GetVarint( dec->buf, &pos, dec->wr, &identLen );
+
+	if( rv == PARSE_MORE )
+		return( LM63TRC_EV_NONE );
+	if( (rv == PARSE_BAD) || (identLen > LM63TRC_IDENT_MAX-1) ||
+		!hdr.chMask || (hdr.chMask >> LM63TRC_CH_MAX) )
+		goto bad;
+
+	if( pos + identLen > dec->wr )
+		return( LM63TRC_EV_NONE );
+	memcpy( hdr.ident, &dec->buf[pos], identLen );
+	pos += identLen;
+
+	dec->hdr      = hdr;
+	dec->hdrValid = TRUE;
+	dec->chNum    = 0;
+	for( ch=0; ch<LM63TRC_CH_MAX; ch++ ){
+		if( hdr.chMask & (1 << ch) )
+			dec->chNum++;
+	}
+	dec->rd = pos;
+
+	return( LM63TRC_EV_HDR );
+
+bad:
+	DecSkip( dec );
+	return( LM63TRC_ERR_FORMAT );
+}
+
+/********************************** DecBlk ***********************************/
+/** Start decoding of block at read position
+ *
+ *  The block is decoded when it is completely in the buffer and its
+ *  checksum is correct.
+ *
+ *  \param dec        \INOUT decoder state
+ *
+ *  \return            LM63TRC_EV_NONE (inBlk set if started) or
+ *                     LM63TRC_ERR_FORMAT
+ */
+static int32 DecBlk(
+	LM63TRC_DEC	*dec
+)
+{
+	u_int32	pos = dec->rd + 1, len, sec, ms, chk;
+	int32	rv;
+
+	rv = GetVarint( dec->buf, &pos, dec->wr, &len );
+	if( rv == PARSE_OK )
+		rv = GetVarint( dec->buf, &pos, dec->wr, &sec );
+	if( rv == PARSE_OK )
+		rv = GetVarint( dec->buf, &pos, dec->wr, &ms );
+
+	if( rv == PARSE_MORE )
+		return( LM63TRC_EV_NONE );
+	if( (rv == PARSE_BAD) || (len == 0) || (len > LM63TRC_BLK_MAX) ||
+		(ms >= 1000) )
+		goto bad;
+
+	if( pos + len + 2 > dec->wr )
+		return( LM63TRC_EV_NONE );
+
+	chk = dec->buf[pos+len] | ((u_int32)dec->buf[pos+len+1] << 8);
+	if( chk != Fletcher16( &dec->buf[pos], len ) || !dec->hdrValid )
+		goto bad;
+
+	dec->inBlk = TRUE;
+	dec->pos   = pos;
+	dec->end   = pos + len;
+	dec->sec   = sec;
+	dec->ms    = ms;
+	memset( dec->prev, 0, sizeof(dec->prev) );
+
+	return( LM63TRC_EV_NONE );
+
+bad:
+	DecSkip( dec );
+	return( LM63TRC_ERR_FORMAT );
+}
+
+/********************************** DecRec ***********************************/
+/** Decode record at read position of current block
+ *
+ *  \param dec        \INOUT decoder state
+ *  \param recP       \OUT record
+ *
+ *  \return            LM63TRC_EV_REC or LM63TRC_ERR_FORMAT
+ */
+static int32 DecRec(
+	LM63TRC_DEC	*dec,
+	LM63TRC_REC	*recP
+)
+{
+	u_int32	head, delta, ch;
+
+	if( GetVarint( dec->buf, &dec->pos, dec->end, &head ) != PARSE_OK )
+		goto bad;
+
+	if( !(head & 1) ){
+		for( ch=0; ch<LM63TRC_CH_MAX; ch++ ){
+			if( !(dec->hdr.chMask & (1 << ch)) )
+				continue;
+			if( GetVarint( dec->buf, &dec->pos, dec->end, &delta ) != PARSE_OK )
+				goto bad;
+			dec->prev[ch] += UnZigZag( delta );
+		}
+	}
+
+	TimeAdd( &dec->sec, &dec->ms, head >> 1 );
+
+	recP->sec = dec->sec;
+	recP->ms  = dec->ms;
+	for( ch=0; ch<LM63TRC_CH_MAX; ch++ )
+		recP->value[ch] = dec->prev[ch];
+
+	return( LM63TRC_EV_REC );
+
+bad:
+	/* checksum was correct: encoder fault, drop rest of block */
+	dec->errors++;
+	dec->pos = dec->end;
+	return( LM63TRC_ERR_FORMAT );
+}
+
+/********************************** DecSkip **********************************/
+/** Skip damaged data up to the next possible block or header start
+ *
+ *  \param dec        \INOUT decoder state
+ */
+static void DecSkip(
+	LM63TRC_DEC	*dec
+)
+{
+	dec->errors++;
+
+	for( dec->rd++; dec->rd < dec->wr; dec->rd++ ){
+		if( (dec->buf[dec->rd] == LM63TRC_SYNC) ||
+			(dec->buf[dec->rd] == 'L') )
+			break;
+	}
+}
@@ -0,0 +1,463 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                   LM63_BENCH                       ************
+ ************                                                    ************
+ ****************************************************************************/
+/*!
+ *         \file lm63_bench.c
+ *       \author dieter.pfeuffer@men.de
+ *
+ *        \brief Benchmark program for the LM63 driver.
+ *
+ *               Measures the cost of M_read() per channel,
+ *               M_setstat(M_MK_CH_CURRENT)+M_read() pairs and M_getblock():
+ *               throughput, latency percentiles, jitter and SMBus
+ *               transactions per sample.
+ *
+ *     Required: libraries: mdis_api, usr_oss, usr_utl
+ *     \switches LINUX - microsecond timer (otherwise millisecond timer)
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*-------------------------------------+
+|   DEFINES                            |
++-------------------------------------*/
+#define DEFAULT_SAMPLES	1000
+#define DEFAULT_WARMUP	10
+#define MAX_CH			8
+
+/* tests */
+#define TEST_READ		0	/* M_read of one channel */
+#define TEST_PAIR		1	/* M_setstat(M_MK_CH_CURRENT) + M_read */
+#define TEST_BLOCK		2	/* M_getblock of all channels */
+
+/*-------------------------------------+
+|   INCLUDES                           |
++-------------------------------------*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef LINUX
+# include <time.h>
+#endif
+#include <MEN/men_typs.h>
+#include <MEN/mdis_api.h>
+#include <MEN/usr_oss.h>
+#include <MEN/usr_utl.h>
+#include <MEN/lm63_drv.h>
+
+static const char IdentString[]=MENT_XSTR(MAK_REVISION);
+
+/*-------------------------------------+
+|   TYPEDEFS                           |
++-------------------------------------*/
+/** benchmark result */
+typedef struct {
+	u_int32	samples;		/* measured samples */
+	double	rate;			/* samples per second */
+	u_int32	min;			/* latency [us] */
+	u_int32	p50;
+	u_int32	p90;
+	u_int32	p99;
+	u_int32	max;
+	double	mean;
+	double	jitter;			/* mean latency change sample to sample [us] */
+	double	xfers;			/* SMBus transactions per sample */
+} RESULT;
+
+/*-------------------------------------+
+|   GLOBALS                            |
++-------------------------------------*/
+static const char *G_testName[] = { "read", "pair", "block" };
+
+/*-------------------------------------+
+|   PROTOTYPES                         |
++-------------------------------------*/
+static void PrintError( char* );
+static u_int32 TimeUs( void );
+static int CmpU32( const void *a, const void *b );
+static int32 Bench( MDIS_PATH path, int32 test, int32 ch, int32 nbrOfCh,
+					u_int32 samples, u_int32 warmup, u_int32 period,
+					u_int32 *latP, RESULT *resP );
+static void PrintResult( int32 test, int32 ch, RESULT *resP, int32 csv );
+
+/********************************* header **********************************/
+/**  Prints the headline
+ */
+static void header(void)
+{
+	printf("\n======================="
+		   "\n===    LM63_BENCH   ==="
+		   "\n======================="
+		   "\nCopyright 2026, MEN Mikro Elektronik GmbH\n%s\n\n", IdentString);
+}
+
+/********************************* usage ***********************************/
+/**  Prints the program usage
+ */
+static void usage(void)
+{
+	printf(
+		"\nUsage:     lm63_bench <device> [<opts>] \n"
+		"\nFunction:  LM63 benchmark of M_read, channel switch + M_read"
+		"\n           and M_getblock"
+		"\nOptions: \n"
+		"    device    device name e.g. lm63_1 \n"
+		"    [-n=dec]  samples per test - default: %d \n"
+		"    [-w=dec]  warm-up samples per test (not measured) - default: %d \n"
+		"    [-p=dec]  sample period [ms] - default: 0 (back-to-back) \n"
+		"    [-b]      bypass the register shadow (LM63_CACHE_BYPASS) \n"
+		"    [-c]      machine-readable output (CSV) \n"
+		"\nOutput (per test and channel):\n"
+		"    rate      samples per second \n"
+		"    min..max  latency percentiles [us] \n"
+		"    jitter    mean latency change from sample to sample [us] \n"
+		"    xfer      SMBus transactions per sample (LM63_XFER_COUNT) \n"
+		"\nCalling examples:\n"
+		"\n - benchmark with default values: \n"
+		"     lm63_bench lm63_1 \n"
+		"\n - 10Hz polling without register shadow, CSV output: \n"
+		"     lm63_bench lm63_1 -n=100 -p=100 -b -c \n"
+		"\nCopyright 2026, MEN Mikro Elektronik GmbH\n%s\n\n",
+		DEFAULT_SAMPLES, DEFAULT_WARMUP, IdentString
+		);
+}
+
+/***************************************************************************/
+/** Program main function
+ *
+ *  \param argc       \IN  argument counter
+ *  \param argv       \IN  argument vector
+ *
+ *  \return	          success (0) or error (1)
+ */
+int main(int argc, char *argv[])
+{
+	MDIS_PATH path;
+	char      *deviceP=NULL;
+	char      *optp=NULL, *errstr=NULL, ebuf[100];
+	int32     ch, nbrOfCh, bypass, csv, oldBypass = 0, ret = 1;
+	u_int32   samples, warmup, period, *latP = NULL;
+	RESULT    res;
+
+	/*--------------------+
+    |  check arguments    |
+    +--------------------*/
+    errstr = UTL_ILLIOPT( "?n=w=p=bc", ebuf );
+	if( errstr ) {
+		printf( "*** %s\n", errstr );
+		usage();
+		return(1);
+	}
+	if( UTL_TSTOPT("?") ) {
+		usage();
+		return(0);
+	}
+
+	/*--------------------+
+	|  get arguments      |
+	+--------------------*/
+	deviceP = argv[1];
+
+	if( !deviceP || *deviceP == '-' ) {
+		printf( "\n***ERROR: missing LM63 device name!\n" );
+		usage();
+		return(1);
+	}
+
+	samples = ( (optp = UTL_TSTOPT("n=")) ? atoi(optp) : DEFAULT_SAMPLES );
+	warmup  = ( (optp = UTL_TSTOPT("w=")) ? atoi(optp) : DEFAULT_WARMUP );
+	period  = ( (optp = UTL_TSTOPT("p=")) ? atoi(optp) : 0 );
+	bypass  = ( UTL_TSTOPT("b") ? 1 : 0 );
+	csv     = ( UTL_TSTOPT("c") ? 1 : 0 );
+
+	if( samples < 1 ) {
+		printf( "\n***ERROR: samples must be >= 1!\n" );
+		return(1);
+	}
+
+	if( (latP = (u_int32*)malloc( samples * sizeof(u_int32) )) == NULL ) {
+		printf( "\n***ERROR: can't alloc %u samples!\n", (unsigned)samples );
+		return(1);
+	}
+
+	/*--------------------+
+    |  open path          |
+    +--------------------*/
+	if ((path = M_open(deviceP)) < 0) {
+		PrintError("open");
+		free( latP );
+		return(1);
+	}
+
+	if( !csv )
+		header();
+
+	/* get number of channels */
+	if ((M_getstat(path, M_LL_CH_NUMBER, &nbrOfCh)) < 0) {
+		PrintError("getstat M_LL_CH_NUMBER");
+		goto abort;
+	}
+	if( nbrOfCh > MAX_CH )
+		nbrOfCh = MAX_CH;
+
+	/* read the current channel only */
+	if ((M_setstat(path, M_MK_IO_MODE, M_IO_EXEC)) < 0) {
+		PrintError("setstat M_MK_IO_MODE");
+		goto abort;
+	}
+
+	/* register shadow */
+	if ((M_getstat(path, LM63_CACHE_BYPASS, &oldBypass)) < 0 ||
+		(M_setstat(path, LM63_CACHE_BYPASS, bypass)) < 0) {
+		PrintError("get/setstat LM63_CACHE_BYPASS");
+		goto abort;
+	}
+
+	/*--------------------+
+    |  benchmark          |
+    +--------------------*/
+	if( csv )
+		printf( "test,ch,samples,rate,min_us,p50_us,p90_us,p99_us,max_us,"
+				"mean_us,jitter_us,xfer_per_sample\n" );
+	else
+		printf( "test   ch  samples     rate[1/s]  min[us]  p50[us]  p90[us]"
+				"  p99[us]  max[us]  mean[us]  jitter[us]  xfer\n" );
+
+	for( ch=0; ch<nbrOfCh; ch++ ) {
+		if( Bench( path, TEST_READ, ch, nbrOfCh, samples, warmup, period,
+				   latP, &res ) )
+			goto restore;
+		PrintResult( TEST_READ, ch, &res, csv );
+	}
+
+	if( Bench( path, TEST_PAIR, -1, nbrOfCh, samples, warmup, period,
+			   latP, &res ) )
+		goto restore;
+	PrintResult( TEST_PAIR, -1, &res, csv );
+
+	if( Bench( path, TEST_BLOCK, -1, nbrOfCh, samples, warmup, period,
+			   latP, &res ) )
+		goto restore;
+	PrintResult( TEST_BLOCK, -1, &res, csv );
+
+	ret = 0;
+
+	/*--------------------+
+    |  cleanup            |
+    +--------------------*/
+	restore:
+	M_setstat(path, LM63_CACHE_BYPASS, oldBypass);
+
+	abort:
+	free( latP );
+	if (M_close(path) < 0) {
+		PrintError("close");
+		return(1);
+	}
+
+	return(ret);
+}
+
+/*********************************** Bench *********************************/
+/** Run one benchmark
+ *
+ *  \param path       \IN  MDIS path
+ *  \param test       \IN  TEST_xxx
+ *  \param ch         \IN  channel (TEST_READ)
+ *  \param nbrOfCh    \IN  number of channels
+ *  \param samples    \IN  samples to measure
+ *  \param warmup     \IN  samples before measurement
+ *  \param period     \IN  sample period [ms] (0=back-to-back)
+ *  \param latP       \IN  latency buffer (samples entries)
+ *  \param resP       \OUT result
+ *
+ *  \return	          success (0) or error (1)
+ */
+static int32 Bench(
+	MDIS_PATH	path,
+	int32		test,
+	int32		ch,
+	int32		nbrOfCh,
+	u_int32		samples,
+	u_int32		warmup,
+	u_int32		period,
+	u_int32		*latP,
+	RESULT		*resP
+)
+{
+	int32	blk[MAX_CH], value, xferStart = 0, xferEnd, cur = 0;
+	u_int32	n, t0, t1, tStart = 0, tEnd;
+	double	sum = 0.0, diff = 0.0;
+
+	if( (test == TEST_READ) &&
+		(M_setstat(path, M_MK_CH_CURRENT, ch)) < 0 ) {
+		PrintError("setstat M_MK_CH_CURRENT");
+		return(1);
+	}
+
+	for( n=0; n<warmup+samples; n++ ) {
+		if( n == warmup ) {
+			if( (M_getstat(path, LM63_XFER_COUNT, &xferStart)) < 0 ) {
+				PrintError("getstat LM63_XFER_COUNT");
+				return(1);
+			}
+			tStart = TimeUs();
+		}
+
+		t0 = TimeUs();
+		switch( test ) {
+		case TEST_READ:
+			if ((M_read(path, &value)) < 0) {
+				PrintError("read");
+				return(1);
+			}
+			break;
+		case TEST_PAIR:
+			if ((M_setstat(path, M_MK_CH_CURRENT, cur)) < 0) {
+				PrintError("setstat M_MK_CH_CURRENT");
+				return(1);
+			}
+			if ((M_read(path, &value)) < 0) {
+				PrintError("read");
+				return(1);
+			}
+			cur = (cur + 1) % nbrOfCh;
+			break;
+		case TEST_BLOCK:
+			if ((M_getblock(path, (u_int8*)blk, nbrOfCh * 4)) < 0) {
+				PrintError("getblock");
+				return(1);
+			}
+			break;
+		}
+		t1 = TimeUs();
+
+		if( n >= warmup )
+			latP[n - warmup] = t1 - t0;
+
+		if( period )
+			UOS_Delay( period );
+	}
+
+	tEnd = TimeUs();
+	if( (M_getstat(path, LM63_XFER_COUNT, &xferEnd)) < 0 ) {
+		PrintError("getstat LM63_XFER_COUNT");
+		return(1);
+	}
+
+	/* jitter: in sample order */
+	for( n=0; n<samples; n++ ) {
+		sum += latP[n];
+		if( n )
+			diff += (latP[n] > latP[n-1]) ? latP[n] - latP[n-1] :
+				latP[n-1] - latP[n];
+	}
+
+	qsort( latP, samples, sizeof(u_int32), CmpU32 );
+
+	resP->samples = samples;
+	resP->rate    = (tEnd != tStart) ?
+		(double)samples * 1000000.0 / (double)(tEnd - tStart) : 0.0;
+	resP->min     = latP[0];
+	resP->p50     = latP[(samples - 1) * 50 / 100];
+	resP->p90     = latP[(samples - 1) * 90 / 100];
+	resP->p99     = latP[(samples - 1) * 99 / 100];
+	resP->max     = latP[samples - 1];
+	resP->mean    = sum / samples;
+	resP->jitter  = (samples > 1) ? diff / (samples - 1) : 0.0;
+	resP->xfers   = (double)(u_int32)(xferEnd - xferStart) / samples;
+
+	return(0);
+}
+
+/******************************** PrintResult ******************************/
+/** Print benchmark result
+ *
+ *  \param test       \IN  TEST_xxx
+ *  \param ch         \IN  channel or -1 (all)
+ *  \param resP       \IN  result
+ *  \param csv        \IN  CSV output
+ */
+static void PrintResult(
+	int32	test,
+	int32	ch,
+	RESULT	*resP,
+	int32	csv
+)
+{
+	char	chStr[8];
+
+	if( ch < 0 )
+		strcpy( chStr, csv ? "" : "all" );
+	else
+		sprintf( chStr, "%d", (int)ch );
+
+	if( csv )
+		printf( "%s,%s,%u,%.1f,%u,%u,%u,%u,%u,%.1f,%.1f,%.2f\n",
+				G_testName[test], chStr, (unsigned)resP->samples, resP->rate,
+				(unsigned)resP->min, (unsigned)resP->p50, (unsigned)resP->p90,
+				(unsigned)resP->p99, (unsigned)resP->max, resP->mean,
+				resP->jitter, resP->xfers );
+	else
+		printf( "%-5s  %-3s %7u  %12.1f  %7u  %7u  %7u  %7u  %7u  %8.1f"
+				"  %10.1f  %4.2f\n",
+				G_testName[test], chStr, (unsigned)resP->samples, resP->rate,
+				(unsigned)resP->min, (unsigned)resP->p50, (unsigned)resP->p90,
+				(unsigned)resP->p99, (unsigned)resP->max, resP->mean,
+				resP->jitter, resP->xfers );
+}
+
+/*********************************** TimeUs ********************************/
+/** Get time stamp
+ *
+ *  \return	          time [us]
+ */
+static u_int32 TimeUs( void )
+{
+#ifdef LINUX
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return( (u_int32)ts.tv_sec * 1000000 + (u_int32)(ts.tv_nsec / 1000) );
+#else
+	return( UOS_MsecTimerGet() * 1000 );
+#endif
+}
+
+/*********************************** CmpU32 ********************************/
+/** qsort compare function
+ */
+static int CmpU32( const void *a, const void *b )
+{
+	u_int32 x = *(const u_int32*)a, y = *(const u_int32*)b;
+
+	return( (x > y) - (x < y) );
+}
+
+/********************************* PrintError ******************************/
+/** Print MDIS error message
+ *
+ *  \param info       \IN  info string
+*/
+static void PrintError(char *info)
+{
+	printf("*** can't %s: %s\n", info, M_errstring(UOS_ErrnoGet()));
+}
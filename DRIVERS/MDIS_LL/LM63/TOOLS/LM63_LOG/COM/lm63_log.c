@@ -0,0 +1,571 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                   LM63_LOG                         ************
+ ************                                                    ************
+ ****************************************************************************/
+/*!
+ *         \file lm63_log.c
+ *       \author dieter.pfeuffer@men.de
+ *
+ *        \brief Ring file logger for the LM63 driver.
+ *
+ *               Samples all channels (M_getblock) with a fixed period into
+ *               a memory-mapped ring file of fixed size (see lm63_log.h).
+ *               The logger does not allocate memory or call write() per
+ *               sample. Other processes (or lm63_log -r) read the ring file
+ *               while the logger is running.
+ *
+ *     Required: libraries: mdis_api, usr_oss, usr_utl
+ *     \switches LINUX - POSIX implementation (mmap, clock_nanosleep),
+ *                       not supported otherwise
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*-------------------------------------+
+|   DEFINES                            |
++-------------------------------------*/
+#define DEFAULT_PERIOD	1000
+#define DEFAULT_RECS	131072		/* 36h at 1Hz */
+#define MAX_RECS		0x1000000
+#define READ_POLL_MIN	100			/* min. poll period of -r -f [ms] */
+
+/* order of ring file accesses (other processes) */
+#if defined(__GNUC__)
+# define MEM_BARRIER()	__sync_synchronize()
+#else
+# define MEM_BARRIER()
+#endif
+
+/*-------------------------------------+
+|   INCLUDES                           |
++-------------------------------------*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef LINUX
+# include <errno.h>
+# include <fcntl.h>
+# include <signal.h>
+# include <time.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <sys/time.h>
+#endif
+#include <MEN/men_typs.h>
+#include <MEN/mdis_api.h>
+#include <MEN/usr_oss.h>
+#include <MEN/usr_utl.h>
+#include <MEN/lm63_drv.h>
+#include <MEN/lm63_log.h>
+
+static const char IdentString[]=MENT_XSTR(MAK_REVISION);
+
+#ifdef LINUX
+
+/** CSV column names (index: channel) */
+static const char *G_chName[LM63LOG_CH_MAX] = {
+	"temp", "rmt_temp", "fan_speed", "pwm"
+};
+
+/** stop request (SIGINT, SIGTERM) */
+static volatile sig_atomic_t G_stop;
+
+/*-------------------------------------+
+|   PROTOTYPES                         |
++-------------------------------------*/
+static void PrintError( char* );
+static int32 Log( char *deviceP, char *fileP, u_int32 period, u_int32 recNum );
+static int32 Dump( char *fileP, int32 follow );
+static LM63LOG_REC* Slot( LM63LOG_HDR *hdr, u_int32 n );
+static void SigHandler( int sig );
+
+/********************************* header **********************************/
+/**  Prints the headline
+ */
+static void header(void)
+{
+	printf("\n======================="
+		   "\n===    LM63_LOG     ==="
+		   "\n======================="
+		   "\nCopyright 2026, MEN Mikro Elektronik GmbH\n%s\n\n", IdentString);
+}
+
+/********************************* usage ***********************************/
+/**  Prints the program usage
+ */
+static void usage(void)
+{
+	printf(
+		"\nUsage:     lm63_log <device> -o=<file> [<opts>] \n"
+		"           lm63_log -r=<file> [-f] \n"
+		"\nFunction:  LM63 ring file logger"
+		"\nOptions: \n"
+		"    device    device name e.g. lm63_1 \n"
+		"    -o=file   log into ring file (continued if compatible) \n"
+		"    [-p=dec]  sample period [ms] - default: %d \n"
+		"    [-n=dec]  ring size [records], rounded up to a power of two \n"
+		"              - default: %d \n"
+		"    -r=file   print ring file as CSV (oldest record first) \n"
+		"    [-f]      follow: print new records until stopped \n"
+		"\nThe logger runs until SIGINT/SIGTERM (e.g. Ctrl-C).\n"
+		"\nCalling examples:\n"
+		"\n - log at 1Hz: \n"
+		"     lm63_log lm63_1 -o=/var/log/lm63_1.ring \n"
+		"\n - read while logging: \n"
+		"     lm63_log -r=/var/log/lm63_1.ring -f \n"
+		"\nCopyright 2026, MEN Mikro Elektronik GmbH\n%s\n\n",
+		DEFAULT_PERIOD, DEFAULT_RECS, IdentString
+		);
+}
+
+/***************************************************************************/
+/** Program main function
+ *
+ *  \param argc       \IN  argument counter
+ *  \param argv       \IN  argument vector
+ *
+ *  \return	          success (0) or error (1)
+ */
+int main(int argc, char *argv[])
+{
+	char      *deviceP=NULL, *fileP;
+	char      *optp=NULL, *errstr=NULL, ebuf[100];
+	u_int32   period, recNum;
+
+	/*--------------------+
+    |  check arguments    |
+    +--------------------*/
+    errstr = UTL_ILLIOPT( "?o=p=n=r=f", ebuf );
+	if( errstr ) {
+		printf( "*** %s\n", errstr );
+		usage();
+		return(1);
+	}
+	if( UTL_TSTOPT("?") ) {
+		usage();
+		return(0);
+	}
+
+	signal( SIGINT, SigHandler );
+	signal( SIGTERM, SigHandler );
+
+	/*--------------------+
+	|  read               |
+	+--------------------*/
+	if( (fileP = UTL_TSTOPT("r=")) )
+		return( Dump( fileP, UTL_TSTOPT("f") ? 1 : 0 ) ? 1 : 0 );
+
+	/*--------------------+
+	|  log                |
+	+--------------------*/
+	deviceP = argv[1];
+
+	if( !deviceP || *deviceP == '-' ) {
+		printf( "\n***ERROR: missing LM63 device name!\n" );
+		usage();
+		return(1);
+	}
+	if( !(fileP = UTL_TSTOPT("o=")) ) {
+		printf( "\n***ERROR: missing ring file name!\n" );
+		usage();
+		return(1);
+	}
+
+	period = ( (optp = UTL_TSTOPT("p=")) ? atoi(optp) : DEFAULT_PERIOD );
+	recNum = ( (optp = UTL_TSTOPT("n=")) ? atoi(optp) : DEFAULT_RECS );
+
+	if( period < 1 || recNum < 1 || recNum > MAX_RECS ) {
+		printf( "\n***ERROR: illegal period or ring size!\n" );
+		return(1);
+	}
+
+	header();
+
+	return( Log( deviceP, fileP, period, recNum ) ? 1 : 0 );
+}
+
+/************************************ Log **********************************/
+/** Sample device into ring file
+ *
+ *  A ring file of the same geometry (record size, number of records and
+ *  channels) is continued, any other file is initialized. The samples are
+ *  taken at absolute times (no drift). Missed periods are skipped.
+ *
+ *  \param deviceP    \IN  device name
+ *  \param fileP      \IN  ring file name
+ *  \param period     \IN  sample period [ms]
+ *  \param recNum     \IN  ring size [records]
+ *
+ *  \return	          success (0) or error (1)
+ */
+static int32 Log(
+	char		*deviceP,
+	char		*fileP,
+	u_int32		period,
+	u_int32		recNum
+)
+{
+	MDIS_PATH		path;
+	LM63LOG_HDR		*hdr = NULL;
+	LM63LOG_REC		*rec;
+	M_SG_BLOCK		blk;
+	struct stat		st;
+	struct timeval	tv;
+	struct timespec	next, now;
+	char			ident[LM63LOG_IDENT_MAX];
+	char			magic[sizeof(LM63LOG_MAGIC)];
+	int32			nbrOfCh, smbAddr, tempUnit, ret = 1;
+	u_int32			n, r, size = 0;
+	int				fd = -1;
+
+	/* power of two (continuous slot index on wrap) */
+	for( r=1; r<recNum; r<<=1 )
+		;
+	recNum = r;
+	size = LM63LOG_HDR_SIZE + recNum * sizeof(LM63LOG_REC);
+
+	/*--------------------+
+    |  open path          |
+    +--------------------*/
+	if ((path = M_open(deviceP)) < 0) {
+		PrintError("open");
+		return(1);
+	}
+
+	if ((M_getstat(path, M_LL_CH_NUMBER, &nbrOfCh)) < 0) {
+		PrintError("getstat M_LL_CH_NUMBER");
+		goto abort;
+	}
+	if( nbrOfCh > LM63LOG_CH_MAX )
+		nbrOfCh = LM63LOG_CH_MAX;
+
+	if ((M_getstat(path, LM63_SMB_DEVADDR, &smbAddr)) < 0) {
+		PrintError("getstat LM63_SMB_DEVADDR");
+		goto abort;
+	}
+	if ((M_getstat(path, LM63_TEMP_UNIT, &tempUnit)) < 0) {
+		PrintError("getstat LM63_TEMP_UNIT");
+		goto abort;
+	}
+
+	memset( ident, 0, sizeof(ident) );
+	blk.size = LM63LOG_IDENT_MAX - 1;
+	blk.data = (void*)ident;
+	if ((M_getstat(path, M_MK_BLK_REV_ID, (int32*)&blk)) < 0) {
+		PrintError("getstat M_MK_BLK_REV_ID");
+		goto abort;
+	}
+
+	/*--------------------+
+    |  map ring file      |
+    +--------------------*/
+	if( (fd = open( fileP, O_RDWR | O_CREAT, 0644 )) < 0 ||
+		fstat( fd, &st ) ) {
+		printf( "\n***ERROR: can't open %s: %s\n", fileP, strerror(errno) );
+		goto abort;
+	}
+
+	/* never overwrite a file that is not an lm63_log ring file */
+	if( st.st_size != 0 &&
+		(pread( fd, magic, sizeof(magic), 0 ) != sizeof(magic) ||
+		 memcmp( magic, LM63LOG_MAGIC, sizeof(magic) )) ) {
+		printf( "\n***ERROR: %s exists and is no lm63_log ring file\n",
+				fileP );
+		goto abort;
+	}
+
+	/* new file: all slots zero, head 0 */
+	if( (u_int32)st.st_size != size &&
+		(ftruncate( fd, 0 ) || ftruncate( fd, size )) ) {
+		printf( "\n***ERROR: can't size %s: %s\n", fileP, strerror(errno) );
+		goto abort;
+	}
+
+	hdr = (LM63LOG_HDR*)mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+							  fd, 0 );
+	if( hdr == (LM63LOG_HDR*)MAP_FAILED ) {
+		hdr = NULL;
+		printf( "\n***ERROR: can't map %s: %s\n", fileP, strerror(errno) );
+		goto abort;
+	}
+
+	if( strcmp( hdr->magic, LM63LOG_MAGIC ) ||
+		hdr->version != LM63LOG_VERSION ||
+		hdr->hdrSize != LM63LOG_HDR_SIZE ||
+		hdr->recSize != sizeof(LM63LOG_REC) ||
+		hdr->recNum  != recNum ||
+		hdr->chNum   != (u_int32)nbrOfCh ) {
+		/* initialize, magic last */
+		memset( (void*)hdr, 0, size );
+		hdr->version = LM63LOG_VERSION;
+		hdr->hdrSize = LM63LOG_HDR_SIZE;
+		hdr->recSize = sizeof(LM63LOG_REC);
+		hdr->recNum  = recNum;
+		hdr->chNum   = nbrOfCh;
+		MEM_BARRIER();
+		strcpy( hdr->magic, LM63LOG_MAGIC );
+	}
+	else if( hdr->pid && (hdr->pid != (u_int32)getpid()) &&
+			 kill( (pid_t)hdr->pid, 0 ) == 0 ) {
+		printf( "\n***ERROR: %s in use by process %u!\n", fileP,
+				(unsigned)hdr->pid );
+		goto abort;
+	}
+
+	hdr->period   = period;
+	hdr->smbAddr  = smbAddr;
+	hdr->tempUnit = tempUnit;
+	hdr->pid      = getpid();
+	strcpy( hdr->ident, ident );
+
+	printf( "logging %d channels every %u ms into %s (%u records, "
+			"%u records so far)\n", (int)nbrOfCh, (unsigned)period, fileP,
+			(unsigned)recNum, (unsigned)hdr->head );
+
+	/*--------------------+
+    |  log                |
+    +--------------------*/
+	clock_gettime( CLOCK_MONOTONIC, &next );
+
+	for( n = hdr->head; !G_stop; n++ ) {
+		/* record number reserved for "being written" */
+		if( n == LM63LOG_NBR_INVALID )
+			continue;
+
+		rec = Slot( hdr, n );
+
+		rec->nbr = LM63LOG_NBR_INVALID;
+		MEM_BARRIER();
+
+		gettimeofday( &tv, NULL );
+		rec->sec = (u_int32)tv.tv_sec;
+		rec->ms  = (u_int32)(tv.tv_usec / 1000);
+		if ((M_getblock(path, (u_int8*)rec->value, nbrOfCh * 4)) < 0)
+			rec->error = UOS_ErrnoGet();
+		else
+			rec->error = 0;
+
+		MEM_BARRIER();
+		rec->nbr = n;
+		MEM_BARRIER();
+		hdr->head = n + 1;
+
+		/* next absolute sample time */
+		next.tv_sec  += period / 1000;
+		next.tv_nsec += (period % 1000) * 1000000;
+		if( next.tv_nsec >= 1000000000 ) {
+			next.tv_nsec -= 1000000000;
+			next.tv_sec++;
+		}
+
+		/* late: skip missed periods */
+		clock_gettime( CLOCK_MONOTONIC, &now );
+		if( now.tv_sec > next.tv_sec ||
+			(now.tv_sec == next.tv_sec && now.tv_nsec > next.tv_nsec) )
+			next = now;
+
+		while( !G_stop &&
+			   clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &next,
+								NULL ) == EINTR )
+			;
+	}
+
+	printf( "%u records logged\n", (unsigned)hdr->head );
+	hdr->pid = 0;
+	ret = 0;
+
+	/*--------------------+
+    |  cleanup            |
+    +--------------------*/
+	abort:
+	if( hdr )
+		munmap( (void*)hdr, size );
+	if( fd >= 0 )
+		close( fd );
+	if (M_close(path) < 0) {
+		PrintError("close");
+		return(1);
+	}
+
+	return(ret);
+}
+
+/*********************************** Dump **********************************/
+/** Print records of ring file as CSV
+ *
+ *  Maps the ring file read-only, so it can be read while the logger is
+ *  running (see lm63_log.h).
+ *
+ *  \param fileP      \IN  ring file name
+ *  \param follow     \IN  print new records until stopped
+ *
+ *  \return	          success (0) or error (1)
+ */
+static int32 Dump(
+	char		*fileP,
+	int32		follow
+)
+{
+	LM63LOG_HDR		*hdr = NULL;
+	LM63LOG_REC		*rec, copy;
+	struct stat		st;
+	u_int32			n, h, ch, poll, lost = 0;
+	int32			ret = 1;
+	int				fd;
+
+	if( (fd = open( fileP, O_RDONLY )) < 0 || fstat( fd, &st ) ) {
+		printf( "\n***ERROR: can't open %s: %s\n", fileP, strerror(errno) );
+		return(1);
+	}
+
+	if( (u_int32)st.st_size < LM63LOG_HDR_SIZE ||
+		(hdr = (LM63LOG_HDR*)mmap( NULL, st.st_size, PROT_READ, MAP_SHARED,
+								   fd, 0 )) == (LM63LOG_HDR*)MAP_FAILED ) {
+		hdr = NULL;
+		printf( "\n***ERROR: can't map %s\n", fileP );
+		goto abort;
+	}
+
+	if( strcmp( hdr->magic, LM63LOG_MAGIC ) ||
+		hdr->version != LM63LOG_VERSION ||
+		hdr->recSize < sizeof(LM63LOG_REC) ||
+		hdr->chNum > LM63LOG_CH_MAX ||
+		(hdr->recNum & (hdr->recNum - 1)) ||
+		hdr->hdrSize + (double)hdr->recNum * hdr->recSize > st.st_size ) {
+		printf( "\n***ERROR: %s is no lm63_log ring file\n", fileP );
+		goto abort;
+	}
+
+	printf( "# ident: %s\n", hdr->ident );
+	printf( "# smb_addr: 0x%02x\n", (unsigned)hdr->smbAddr );
+	printf( "# temp_unit: %s\n", hdr->tempUnit == LM63_UNIT_MILLIDEG ?
+			"milli-degrees Celsius" : "degrees Celsius" );
+	printf( "# period: %u ms\n", (unsigned)hdr->period );
+	printf( "time,error" );
+	for( ch=0; ch<hdr->chNum; ch++ )
+		printf( ",%s", G_chName[ch] );
+	printf( "\n" );
+
+	poll = hdr->period > READ_POLL_MIN ? hdr->period : READ_POLL_MIN;
+	h = hdr->head;
+	n = (h > hdr->recNum) ? h - hdr->recNum : 0;
+
+	do {
+		MEM_BARRIER();
+		h = hdr->head;
+
+		/* overtaken by the logger */
+		if( h - n > hdr->recNum ) {
+			lost += h - hdr->recNum - n;
+			n = h - hdr->recNum;
+		}
+
+		for( ; n != h; n++ ) {
+			rec = Slot( hdr, n );
+			if( n == LM63LOG_NBR_INVALID || rec->nbr != n )
+				continue;
+			MEM_BARRIER();
+			copy = *rec;
+			MEM_BARRIER();
+			if( rec->nbr != n )
+				continue;
+
+			printf( "%u.%03u,%d", (unsigned)copy.sec, (unsigned)copy.ms,
+					(int)copy.error );
+			for( ch=0; ch<hdr->chNum; ch++ )
+				printf( ",%d", (int)copy.value[ch] );
+			printf( "\n" );
+		}
+
+		if( follow ) {
+			fflush( stdout );
+			UOS_Delay( poll );
+		}
+	} while( follow && !G_stop );
+
+	if( lost )
+		fprintf( stderr, "*** %u records overwritten before read\n",
+				 (unsigned)lost );
+	ret = 0;
+
+	abort:
+	if( hdr )
+		munmap( (void*)hdr, st.st_size );
+	close( fd );
+	return( ret );
+}
+
+/*********************************** Slot **********************************/
+/** Get record slot of record number
+ *
+ *  \param hdr        \IN  ring file header
+ *  \param n          \IN  record number
+ *
+ *  \return	          record slot
+ */
+static LM63LOG_REC* Slot(
+	LM63LOG_HDR	*hdr,
+	u_int32		n
+)
+{
+	return( (LM63LOG_REC*)((char*)hdr + hdr->hdrSize +
+						   (n & (hdr->recNum - 1)) * hdr->recSize) );
+}
+
+/******************************** SigHandler *******************************/
+/** Request stop (SIGINT, SIGTERM)
+ *
+ *  \param sig        \IN  signal number
+ */
+static void SigHandler(
+	int		sig
+)
+{
+	G_stop = 1;
+}
+
+/********************************* PrintError ******************************/
+/** Print MDIS error message
+ *
+ *  \param info       \IN  info string
+*/
+static void PrintError(char *info)
+{
+	printf("*** can't %s: %s\n", info, M_errstring(UOS_ErrnoGet()));
+}
+
+#else /* LINUX */
+
+/***************************************************************************/
+/** Program main function (not supported)
+ *
+ *  \param argc       \IN  argument counter
+ *  \param argv       \IN  argument vector
+ *
+ *  \return	          error (1)
+ */
+int main(int argc, char *argv[])
+{
+	printf( "*** lm63_log: not supported on this OS\n%s\n", IdentString );
+	return(1);
+}
+
+#endif /* LINUX */
@@ -0,0 +1,1477 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                   LM63_SIMTEST                     ************
+ ************                                                    ************
+ ****************************************************************************/
+/*!
+ *         \file lm63_simtest.c
+ *       \author dieter.pfeuffer@men.de
+ *
+ *        \brief Host test of the LM63 driver on the LM63 simulator.
+ *
+ *               The driver source is compiled into this program and runs
+ *               on host stubs of the OSS and DESC functions. Time is the
+ *               virtual clock of the simulated SMBus: OSS_Delay() and
+ *               waiting for a semaphore advance the clock in 1ms steps
+ *               and run the due OSS alarms.
+ *
+ *               Tests:
+ *               - round trip of the getstat/setstat codes and rejection
+ *                 of invalid values
+ *               - register shadow (device reads saved)
+ *               - periodic sampler and sample FIFO (incl. LM63_FIFO_WAIT,
+ *                 samples taken by a waiting reader, missed periods)
+ *               - deadband and max. silence
+ *               - one-shot conversions
+ *               - lookup table update and write-lock restore
+ *               - retry of transient SMBus errors and deadline
+ *               - warm attach (PWM kept, limits restored)
+ *               - limits (resolution, unit) and ALERT status
+ *               - sensor sweep of the aggregator (bus lock free during
+ *                 retries on another bus)
+ *               - INIT_VERIFY (saved writes)
+ *               - channel statistics (copy, reset, unit change)
+ *
+ *               After each test the bus lock must be free and no wait
+ *               for a semaphore may have timed out.
+ *
+ *     Required: libraries: lm63_sim, usr_oss
+ *     \switches _LL_DRV_, _ONE_NAMESPACE_PER_DRIVER_ (driver source)
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*-------------------------------------+
+|   INCLUDES                           |
++-------------------------------------*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+/* driver under test (static functions and LL_HANDLE visible) */
+#include "../../../DRIVER/COM/lm63_drv.c"
+
+#include <MEN/usr_oss.h>
+#include <MEN/lm63_sim.h>
+
+/*-------------------------------------+
+|   DEFINES                            |
++-------------------------------------*/
+#define BUS_NBR			0
+#define BUS_NBR2		1		/* second bus (sweep test) */
+#define DEV_ADDR		0x98
+#define DEV_ADDR2		0x9a	/* second device on BUS_NBR (sweep test) */
+#define TACH_PULS		2
+#define ALARM_MAX		4
+#define SEM_FOREVER_MS	10000	/* OSS_SEM_WAITFOREVER: report deadlock after */
+
+#define CHECK(expr)		Check( (expr) ? TRUE : FALSE, #expr, __LINE__ )
+
+/*-------------------------------------+
+|   TYPEDEFS                           |
++-------------------------------------*/
+/** descriptor key (host DESC stub) */
+typedef struct {
+	const char	*key;
+	u_int32		value;
+} DESC_KEY;
+
+/** host semaphore */
+typedef struct {
+	int32		type;		/* OSS_SEM_BIN/OSS_SEM_COUNT */
+	int32		count;
+} HOST_SEM;
+
+/** host alarm */
+typedef struct {
+	void		(*funct)(void*);
+	void		*arg;
+	u_int32		active;
+	u_int32		cyclic;
+	u_int32		period;		/* [ms] */
+	u_int32		next;		/* sim. time of next expiry [ms] */
+} HOST_ALARM;
+
+/** host signal */
+typedef struct {
+	int32		sigNo;
+	u_int32		sent;
+} HOST_SIG;
+
+/** test */
+typedef struct {
+	const char	*name;
+	const DESC_KEY *desc;
+	void		(*funct)(LL_HANDLE *llHdl);
+} TEST;
+
+/*-------------------------------------+
+|   GLOBALS                            |
++-------------------------------------*/
+static LM63SIM_BUS	*G_bus;
+static LM63SIM_DEV	*G_dev;
+static HOST_ALARM	*G_alarm[ALARM_MAX];
+static u_int32		G_inAlarm;
+static u_int32		G_semTimeout;	/* OSS_SEM_WAITFOREVER timed out */
+static u_int32		G_sigSent;
+static u_int32		G_fail;			/* failed checks of current test */
+static LL_HANDLE	*G_lockHdl;		/* OSS_Delay: check bus lock of handle */
+static u_int32		G_lockDelay;	/* delays with bus lock held */
+
+/** default descriptor */
+static const DESC_KEY G_descDef[] = {
+	{ "SMB_BUSNBR",		BUS_NBR },
+	{ "SMB_DEVADDR",	DEV_ADDR },
+	{ "TACH_PULSE",		TACH_PULS },
+	{ NULL, 0 }
+};
+
+/** descriptor with retry delays (retry test) */
+static const DESC_KEY G_descRetry[] = {
+	{ "SMB_BUSNBR",		BUS_NBR },
+	{ "SMB_DEVADDR",	DEV_ADDR },
+	{ "TACH_PULSE",		TACH_PULS },
+	{ "SMB_RETRY",		3 },
+	{ "SMB_RETRY_DELAY",	2 },
+	{ "SMB_DEADLINE",	12 },
+	{ NULL, 0 }
+};
+
+/** descriptor with warm attach and a limit (warm test) */
+static const DESC_KEY G_descWarm[] = {
+	{ "SMB_BUSNBR",		BUS_NBR },
+	{ "SMB_DEVADDR",	DEV_ADDR },
+	{ "TACH_PULSE",		TACH_PULS },
+	{ "WARM_ATTACH",	1 },
+	{ "LIM_RMT_HIGH",	60 },
+	{ NULL, 0 }
+};
+
+/** descriptor with init verify (initverify test) */
+static const DESC_KEY G_descVerify[] = {
+	{ "SMB_BUSNBR",		BUS_NBR },
+	{ "SMB_DEVADDR",	DEV_ADDR },
+	{ "TACH_PULSE",		TACH_PULS },
+	{ "INIT_VERIFY",	1 },
+	{ NULL, 0 }
+};
+
+/** descriptor of an aggregator with three sensors (sweep test) */
+static const DESC_KEY G_descSweep[] = {
+	{ "SMB_BUSNBR",		BUS_NBR },
+	{ "SMB_DEVADDR",	DEV_ADDR },
+	{ "TACH_PULSE",		TACH_PULS },
+	{ "SMB_RETRY",		3 },
+	{ "SMB_RETRY_DELAY",	2 },
+	{ "SMB_DEADLINE",	12 },
+	{ "SENSOR_NUM",		3 },
+	{ "SENSOR_1/SMB_BUSNBR",	BUS_NBR2 },
+	{ "SENSOR_1/SMB_DEVADDR",	DEV_ADDR },
+	{ "SENSOR_2/SMB_BUSNBR",	BUS_NBR },
+	{ "SENSOR_2/SMB_DEVADDR",	DEV_ADDR2 },
+	{ NULL, 0 }
+};
+
+/*-------------------------------------+
+|   PROTOTYPES                         |
++-------------------------------------*/
+static void AlarmRun( void );
+static void Check( int32 ok, const char *expr, int line );
+static void Wait( u_int32 ms );
+static int32 SetBlk( LL_HANDLE *llHdl, int32 code, void *data, int32 size );
+static int32 GetBlk( LL_HANDLE *llHdl, int32 code, void *data, int32 *sizeP );
+static int32 Get( LL_HANDLE *llHdl, int32 code, int32 ch, int32 *valueP );
+static void TestRoundTrip( LL_HANDLE *llHdl );
+static void TestShadow( LL_HANDLE *llHdl );
+static void TestFifo( LL_HANDLE *llHdl );
+static void TestDeadband( LL_HANDLE *llHdl );
+static void TestOneShot( LL_HANDLE *llHdl );
+static void TestLut( LL_HANDLE *llHdl );
+static void TestRetry( LL_HANDLE *llHdl );
+static void TestWarm( LL_HANDLE *llHdl );
+static void TestLimit( LL_HANDLE *llHdl );
+static void TestSweep( LL_HANDLE *llHdl );
+static void TestInitVerify( LL_HANDLE *llHdl );
+static void TestStats( LL_HANDLE *llHdl );
+
+/** tests */
+static const TEST G_test[] = {
+	{ "roundtrip",	G_descDef,		TestRoundTrip },
+	{ "shadow",		G_descDef,		TestShadow },
+	{ "fifo",		G_descDef,		TestFifo },
+	{ "deadband",	G_descDef,		TestDeadband },
+	{ "oneshot",	G_descDef,		TestOneShot },
+	{ "lut",		G_descDef,		TestLut },
+	{ "retry",		G_descRetry,	TestRetry },
+	{ "warm",		G_descDef,		TestWarm },
+	{ "limit",		G_descDef,		TestLimit },
+	{ "sweep",		G_descDef,		TestSweep },
+	{ "initverify",	G_descDef,		TestInitVerify },
+	{ "stats",		G_descDef,		TestStats },
+	{ NULL, NULL, NULL }
+};
+
+/********************************* header **********************************/
+/**  Prints the headline
+ */
+static void header(void)
+{
+	printf("\n======================="
+		   "\n===   LM63_SIMTEST  ==="
+		   "\n======================="
+		   "\nCopyright 2026, MEN Mikro Elektronik GmbH\n%s\n\n", IdentString);
+}
+
+/********************************* usage ***********************************/
+/**  Prints the program usage
+ */
+static void usage(void)
+{
+	printf(
+		"\nUsage:     lm63_simtest [<test>...]\n"
+		"\nFunction:  LM63 driver test on the LM63 simulator\n"
+		"\nOptions:\n"
+		"    test       test to run (default: all)\n"
+		"               roundtrip, shadow, fifo, deadband, oneshot,\n"
+		"               lut, retry, warm, limit, sweep, initverify,\n"
+		"               stats\n"
+		"\nExit code: number of failed tests\n\n");
+}
+
+/********************************* main ************************************/
+/** Program main function
+ *
+ *  \param argc       \IN  argument counter
+ *  \param argv       \IN  argument vector
+ *
+ *  \return	          number of failed tests
+ */
+int main( int argc, char *argv[] )
+{
+	const TEST	*testP;
+	LL_ENTRY	entry;
+	LL_HANDLE	*llHdl;
+	int32		n, run, error, failed = 0;
+
+	header();
+
+	for( n=1; n<argc; n++ ){
+		if( *argv[n] == '-' ){
+			usage();
+			return(1);
+		}
+	}
+
+	LL_GetEntry( &entry );
+
+	for( testP=G_test; testP->name; testP++ ){
+		/* selected? */
+		run = (argc < 2);
+		for( n=1; n<argc; n++ )
+			if( !strcmp( argv[n], testP->name ) )
+				run = TRUE;
+		if( !run )
+			continue;
+
+		G_fail = G_semTimeout = G_sigSent = 0;
+
+		if( (error = LM63SIM_BusCreate( BUS_NBR, 0, &G_bus )) ||
+			(error = LM63SIM_DevAdd( G_bus, DEV_ADDR, TACH_PULS, &G_dev )) ){
+			printf("*** can't create simulator: 0x%x\n", (int)error);
+			return(1);
+		}
+
+		error = entry.init( (DESC_SPEC*)testP->desc, NULL, NULL, NULL, NULL,
+							&llHdl );
+		CHECK( error == 0 );
+
+		if( !error ){
+			/* first conversion done */
+			Wait( llHdl->convPeriod );
+
+			testP->funct( llHdl );
+
+			/* bus lock free, no deadlock */
+			CHECK( ((HOST_SEM*)llHdl->busSem)->count == 1 );
+			CHECK( ((HOST_SEM*)llHdl->callSem)->count == 1 );
+
+			CHECK( entry.exit( &llHdl ) == 0 );
+		}
+		CHECK( G_semTimeout == 0 );
+
+		LM63SIM_BusDestroy( &G_bus );
+
+		printf("%-12s %s\n", testP->name, G_fail ? "FAIL" : "PASS");
+		if( G_fail )
+			failed++;
+	}
+
+	printf("\n%d test(s) failed\n", (int)failed);
+	return( failed );
+}
+
+/********************************* Check ***********************************/
+/** Count and report a failed check
+ *
+ *  \param ok         \IN  check passed
+ *  \param expr       \IN  checked expression
+ *  \param line       \IN  source line
+ */
+static void Check( int32 ok, const char *expr, int line )
+{
+	if( ok )
+		return;
+
+	printf("  line %d: check failed: %s\n", line, expr);
+	G_fail++;
+}
+
+/********************************* Wait ************************************/
+/** Let simulated time pass (alarms run)
+ *
+ *  \param ms         \IN  time [ms]
+ */
+static void Wait( u_int32 ms )
+{
+	OSS_Delay( NULL, ms );
+}
+
+/********************************* Get *************************************/
+/** Getstat of a 32-bit value
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param code       \IN  status code
+ *  \param ch         \IN  channel
+ *  \param valueP     \OUT value
+ *
+ *  \return           error code
+ */
+static int32 Get( LL_HANDLE *llHdl, int32 code, int32 ch, int32 *valueP )
+{
+	INT32_OR_64	value64 = 0;
+	int32		error;
+
+	error = LM63_GetStat( llHdl, code, ch, &value64 );
+	*valueP = (int32)value64;
+	return( error );
+}
+
+/********************************* SetBlk **********************************/
+/** Block setstat
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param code       \IN  block status code
+ *  \param data       \IN  block data
+ *  \param size       \IN  block size [bytes]
+ *
+ *  \return           error code
+ */
+static int32 SetBlk( LL_HANDLE *llHdl, int32 code, void *data, int32 size )
+{
+	M_SG_BLOCK	blk;
+
+	blk.size = size;
+	blk.data = data;
+	return( LM63_SetStat( llHdl, code, 0, (INT32_OR_64)&blk ) );
+}
+
+/********************************* GetBlk **********************************/
+/** Block getstat
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param code       \IN  block status code
+ *  \param data       \OUT block data
+ *  \param sizeP      \IN  buffer size [bytes]
+ *                    \OUT block size [bytes]
+ *
+ *  \return           error code
+ */
+static int32 GetBlk( LL_HANDLE *llHdl, int32 code, void *data, int32 *sizeP )
+{
+	M_SG_BLOCK	blk;
+	int32		error;
+
+	blk.size = *sizeP;
+	blk.data = data;
+	error = LM63_GetStat( llHdl, code, 0, (INT32_OR_64*)&blk );
+	*sizeP = blk.size;
+	return( error );
+}
+
+/****************************** TestRoundTrip ******************************/
+/** Round trip of the getstat/setstat codes
+ *
+ *  \param llHdl      \IN  low-level handle
+ */
+static void TestRoundTrip( LL_HANDLE *llHdl )
+{
+	static const struct {
+		int32	code;
+		int32	ch;
+		int32	value;		/* value to set */
+		int32	tol;		/* tolerance of getstat value */
+	} rt[] = {
+		{ LM63_CACHE_BYPASS,		0,	1,		0 },
+		{ LM63_CACHE_BYPASS,		0,	0,		0 },
+		{ LM63_COALESCE_WIN,		0,	5,		0 },
+		{ LM63_COALESCED,			0,	0,		0 },
+		{ LM63_XFER_COUNT,			0,	1000,	0 },
+		{ LM63_EWMA_TAU,			0,	500,	0 },
+		{ LM63_SMPL_PERIOD,			0,	100,	0 },
+		{ LM63_SMPL_PERIOD,			2,	250,	0 },
+		{ LM63_TEMP_UNIT,			0,	LM63_UNIT_MILLIDEG,	0 },
+		{ LM63_TEMP_UNIT,			0,	LM63_UNIT_DEG,	0 },
+		{ LM63_FIFO_HWM,			0,	FIFO_SIZE,	0 },
+		{ LM63_FIFO_HWM,			0,	0,		0 },
+		{ LM63_FIFO_WAIT,			0,	-1,		0 },
+		{ LM63_FIFO_WAIT,			0,	10,		0 },
+		{ LM63_SMPL_MISSED,			0,	0,		0 },
+		{ LM63_DEADBAND,			1,	3,		0 },
+		{ LM63_SILENCE_MAX,			1,	1000,	0 },
+		{ LM63_DEADBAND_CNT,		0,	7,		0 },
+		{ LM63_ALERT_MASKED,		0,	LM63_ALERT_RHIGH,	0 },
+		{ LM63_LIM_TEMP_HIGH,		0,	70,		0 },
+		{ LM63_LIM_RMT_HIGH,		0,	80,		0 },
+		{ LM63_LIM_RMT_LOW,			0,	-10,	0 },
+		{ LM63_LIM_RMT_TCRIT,		0,	100,	0 },
+		{ LM63_LIM_RMT_TCRIT_HYS,	0,	5,		0 },
+		{ LM63_LIM_FANSPEED,		0,	1000,	5 },
+		{ LM63_LIM_FANSPEED,		0,	0,		0 },
+		{ LM63_PWM_MANUAL,			0,	1,		0 },
+		{ LM63_PWM_MANUAL,			0,	0,		0 },
+		{ LM63_CONV_MODE,			0,	1,		0 },
+		{ LM63_CONV_MODE,			0,	0,		0 },
+	};
+	static const struct {
+		int32	code;
+		int32	ch;
+		int32	value;
+		int32	error;
+	} bad[] = {
+		{ LM63_COALESCE_WIN,	0,	-1,			ERR_LL_ILL_PARAM },
+		{ LM63_EWMA_TAU,		0,	0,			ERR_LL_ILL_PARAM },
+		{ LM63_EWMA_TAU,		0,	EWMA_TAU_MAX+1,	ERR_LL_ILL_PARAM },
+		{ LM63_SMPL_PERIOD,		LM63_CH_PWM, 100, ERR_LL_ILL_CHAN },
+		{ LM63_SMPL_PERIOD,		0,	-1,			ERR_LL_ILL_PARAM },
+		{ LM63_TEMP_UNIT,		0,	2,			ERR_LL_ILL_PARAM },
+		{ LM63_FIFO_HWM,		0,	FIFO_SIZE+1, ERR_LL_ILL_PARAM },
+		{ LM63_FIFO_WAIT,		0,	-2,			ERR_LL_ILL_PARAM },
+		{ LM63_DEADBAND,		LM63_CH_PWM, 1,	ERR_LL_ILL_CHAN },
+		{ LM63_SILENCE_MAX,		0,	-1,			ERR_LL_ILL_PARAM },
+		{ LM63_ALERT_MASKED,	0,	0x80,		ERR_LL_ILL_PARAM },
+		{ LM63_LIM_TEMP_HIGH,	0,	128,		ERR_LL_ILL_PARAM },
+		{ LM63_LIM_RMT_LOW,		0,	-129,		ERR_LL_ILL_PARAM },
+		{ LM63_LIM_RMT_TCRIT_HYS, 0, 256,		ERR_LL_ILL_PARAM },
+		{ LM63_LIM_FANSPEED,	0,	-1,			ERR_LL_ILL_PARAM },
+		{ LM63_LIM_FANSPEED,	0,	(2*5400000)/TACH_PULS+1, ERR_LL_ILL_PARAM },
+	};
+	LM63_PERF	perf;
+	int32		n, value, before = 0, size;
+
+	for( n=0; n<(int32)(sizeof(rt)/sizeof(rt[0])); n++ ){
+		value = -12345;
+		CHECK( LM63_SetStat( llHdl, rt[n].code, rt[n].ch, rt[n].value ) == 0 );
+		CHECK( Get( llHdl, rt[n].code, rt[n].ch, &value ) == 0 );
+		if( (value < rt[n].value - rt[n].tol) ||
+			(value > rt[n].value + rt[n].tol) ){
+			printf("  code 0x%04x ch %d: set %d, got %d\n", (int)rt[n].code,
+				   (int)rt[n].ch, (int)rt[n].value, (int)value);
+			G_fail++;
+		}
+	}
+
+	/* invalid values rejected, previous value kept */
+	for( n=0; n<(int32)(sizeof(bad)/sizeof(bad[0])); n++ ){
+		if( bad[n].ch != LM63_CH_PWM )
+			CHECK( Get( llHdl, bad[n].code, bad[n].ch, &before ) == 0 );
+		if( LM63_SetStat( llHdl, bad[n].code, bad[n].ch, bad[n].value ) !=
+			bad[n].error ){
+			printf("  code 0x%04x ch %d: value %d accepted\n",
+				   (int)bad[n].code, (int)bad[n].ch, (int)bad[n].value);
+			G_fail++;
+		}
+		if( bad[n].ch != LM63_CH_PWM ){
+			CHECK( Get( llHdl, bad[n].code, bad[n].ch, &value ) == 0 );
+			CHECK( value == before );
+		}
+	}
+
+	/* setstat-only resets */
+	CHECK( LM63_SetStat( llHdl, LM63_FIFO_OVERFLOW, 0, 0 ) == 0 );
+	CHECK( Get( llHdl, LM63_FIFO_OVERFLOW, 0, &value ) == 0 && value == 0 );
+	CHECK( LM63_SetStat( llHdl, LM63_FIFO_COUNT, 0, 0 ) == 0 );
+	CHECK( Get( llHdl, LM63_FIFO_COUNT, 0, &value ) == 0 && value == 0 );
+	CHECK( LM63_SetStat( llHdl, LM63_PERF_RESET, 0, 0 ) == 0 );
+	size = sizeof(perf);
+	CHECK( GetBlk( llHdl, LM63_BLK_PERF, &perf, &size ) == 0 );
+	CHECK( size == sizeof(perf) && perf.xfers == 0 );
+
+	/* read-only codes */
+	CHECK( Get( llHdl, LM63_SMB_DEVADDR, 0, &value ) == 0 && value == DEV_ADDR );
+	CHECK( Get( llHdl, LM63_SMB_BUSNBR, 0, &value ) == 0 && value == BUS_NBR );
+	CHECK( Get( llHdl, LM63_SENSOR_NUM, 0, &value ) == 0 && value == 1 );
+	CHECK( Get( llHdl, LM63_CONV_PERIOD, 0, &value ) == 0 && value > 0 );
+	CHECK( Get( llHdl, M_LL_CH_NUMBER, 0, &value ) == 0 && value == CH_NUMBER );
+}
+
+/******************************* TestShadow ********************************/
+/** Register shadow: reads of the same conversion period are coalesced
+ *
+ *  \param llHdl      \IN  low-level handle
+ */
+static void TestShadow( LL_HANDLE *llHdl )
+{
+	LM63SIM_STATS	st;
+	int32			n, value, period, coalesced;
+
+	period = llHdl->convPeriod;
+
+	/* first read from device */
+	LM63SIM_StatsGet( G_bus, &st, TRUE );
+	CHECK( LM63_Read( llHdl, LM63_CH_TEMP, &value ) == 0 && value == 35 );
+	LM63SIM_StatsGet( G_bus, &st, TRUE );
+	CHECK( st.readByte + st.readWord > 0 );
+
+	/* same conversion period: from shadow */
+	CHECK( LM63_SetStat( llHdl, LM63_COALESCED, 0, 0 ) == 0 );
+	for( n=0; n<10; n++ )
+		CHECK( LM63_Read( llHdl, LM63_CH_TEMP, &value ) == 0 && value == 35 );
+	LM63SIM_StatsGet( G_bus, &st, TRUE );
+	CHECK( st.readByte + st.readWord == 0 );
+	CHECK( Get( llHdl, LM63_COALESCED, 0, &coalesced ) == 0 &&
+		   coalesced == 10 );
+
+	/* next conversion period: from device */
+	Wait( period + 1 );
+	CHECK( LM63_Read( llHdl, LM63_CH_TEMP, &value ) == 0 && value == 35 );
+	LM63SIM_StatsGet( G_bus, &st, TRUE );
+	CHECK( st.readByte + st.readWord > 0 );
+
+	/* bypass: always from device */
+	CHECK( LM63_SetStat( llHdl, LM63_CACHE_BYPASS, 0, 1 ) == 0 );
+	for( n=0; n<10; n++ )
+		CHECK( LM63_Read( llHdl, LM63_CH_TEMP, &value ) == 0 && value == 35 );
+	LM63SIM_StatsGet( G_bus, &st, TRUE );
+	CHECK( st.readByte + st.readWord >= 10 );
+	CHECK( LM63_SetStat( llHdl, LM63_CACHE_BYPASS, 0, 0 ) == 0 );
+
+	/* other channels */
+	CHECK( LM63_Read( llHdl, LM63_CH_RMTTEMP, &value ) == 0 && value == 45 );
+	CHECK( LM63_Read( llHdl, LM63_CH_FANSPEED, &value ) == 0 &&
+		   value > 2900 && value < 3100 );
+}
+
+/******************************** TestFifo *********************************/
+/** Periodic sampler and sample FIFO
+ *
+ *  \param llHdl      \IN  low-level handle
+ */
+static void TestFifo( LL_HANDLE *llHdl )
+{
+	LM63_SAMPLE	smpl[16];
+	u_int32		t0, nbr[CH_NUMBER], lastTime = 0;
+	int32		n, i, size, value;
+
+	/* no sampler: FIFO_WAIT times out */
+	CHECK( LM63_SetStat( llHdl, LM63_FIFO_WAIT, 0, 50 ) == 0 );
+	t0 = LM63SIM_TimeGet( G_bus );
+	size = sizeof(smpl);
+	CHECK( GetBlk( llHdl, LM63_BLK_FIFO, smpl, &size ) == 0 && size == 0 );
+	CHECK( LM63SIM_TimeGet( G_bus ) - t0 >= 50 );
+
+	/* sample temperature every 20ms, fan speed every 40ms */
+	CHECK( LM63_SetStat( llHdl, LM63_SMPL_PERIOD, LM63_CH_TEMP, 20 ) == 0 );
+	CHECK( LM63_SetStat( llHdl, LM63_SMPL_PERIOD, LM63_CH_FANSPEED, 40 ) == 0 );
+	CHECK( LM63_SetStat( llHdl, LM63_SMPL_START, 0, 1 ) == 0 );
+	CHECK( Get( llHdl, LM63_SMPL_START, 0, &value ) == 0 && value == 1 );
+
+	memset( nbr, 0, sizeof(nbr) );
+	t0 = LM63SIM_TimeGet( G_bus );
+	while( LM63SIM_TimeGet( G_bus ) - t0 < 400 ){
+		size = sizeof(smpl);
+		if( GetBlk( llHdl, LM63_BLK_FIFO, smpl, &size ) ){
+			CHECK( FALSE );
+			break;
+		}
+		/* woken up by a sample */
+		CHECK( size > 0 );
+
+		for( i=0; i<size/(int32)sizeof(LM63_SAMPLE); i++ ){
+			CHECK( smpl[i].time >= lastTime );
+			lastTime = smpl[i].time;
+			if( smpl[i].ch == LM63_CH_TEMP )
+				CHECK( smpl[i].value == 35 );
+			else if( smpl[i].ch == LM63_CH_FANSPEED )
+				CHECK( smpl[i].value > 2900 && smpl[i].value < 3100 );
+			else
+				CHECK( FALSE );
+			if( (u_int32)smpl[i].ch < CH_NUMBER )
+				nbr[smpl[i].ch]++;
+		}
+	}
+	CHECK( nbr[LM63_CH_TEMP] >= 18 && nbr[LM63_CH_TEMP] <= 21 );
+	CHECK( nbr[LM63_CH_FANSPEED] >= 9 && nbr[LM63_CH_FANSPEED] <= 11 );
+	CHECK( Get( llHdl, LM63_FIFO_OVERFLOW, 0, &value ) == 0 && value == 0 );
+
+	/* high-watermark signal */
+	CHECK( LM63_SetStat( llHdl, LM63_FIFO_HWM, 0, 4 ) == 0 );
+	CHECK( LM63_SetStat( llHdl, LM63_FIFO_SIG_SET, 0, UOS_SIG_USR1 ) == 0 );
+	for( n=0; n<10 && !G_sigSent; n++ ){
+		Wait( 20 );
+		/* samples are taken with the next bus access */
+		CHECK( LM63_Read( llHdl, LM63_CH_PWM, &value ) == 0 );
+	}
+	CHECK( G_sigSent == 1 );
+	CHECK( Get( llHdl, LM63_FIFO_COUNT, 0, &value ) == 0 && value >= 4 );
+	CHECK( LM63_SetStat( llHdl, LM63_FIFO_SIG_CLR, 0, 0 ) == 0 );
+
+	/* waiting reader takes the samples itself: HWM samples returned */
+	CHECK( LM63_SetStat( llHdl, LM63_FIFO_COUNT, 0, 0 ) == 0 );
+	CHECK( LM63_SetStat( llHdl, LM63_FIFO_WAIT, 0, 200 ) == 0 );
+	size = sizeof(smpl);
+	CHECK( GetBlk( llHdl, LM63_BLK_FIFO, smpl, &size ) == 0 &&
+		   size >= 4 * (int32)sizeof(LM63_SAMPLE) );
+
+	/* no bus access: sample periods missed */
+	CHECK( LM63_SetStat( llHdl, LM63_SMPL_MISSED, 0, 0 ) == 0 );
+	Wait( 100 );
+	CHECK( Get( llHdl, LM63_SMPL_MISSED, 0, &value ) == 0 && value > 0 );
+
+	/* discard */
+	CHECK( LM63_SetStat( llHdl, LM63_SMPL_START, 0, 0 ) == 0 );
+	CHECK( LM63_SetStat( llHdl, LM63_FIFO_COUNT, 0, 0 ) == 0 );
+	CHECK( Get( llHdl, LM63_FIFO_COUNT, 0, &value ) == 0 && value == 0 );
+}
+
+/****************************** TestDeadband *******************************/
+/** Deadband and max. silence of the sample FIFO
+ *
+ *  \param llHdl      \IN  low-level handle
+ */
+static void TestDeadband( LL_HANDLE *llHdl )
+{
+	/* 35 degrees, step to 40 degrees after 200ms */
+	static const LM63SIM_POINT step[] = {
+		{ 0, 35000 }, { 200, 35000 }, { 201, 40000 }, { 100000, 40000 }
+	};
+	LM63_SAMPLE	smpl[16];
+	u_int32		t0, nbr = 0;
+	int32		i, size, value, last = 0;
+
+	CHECK( LM63SIM_WaveSet( G_dev, LM63SIM_WAVE_TEMP, step, 4, FALSE ) == 0 );
+
+	CHECK( LM63_SetStat( llHdl, LM63_SMPL_PERIOD, LM63_CH_TEMP, 10 ) == 0 );
+	CHECK( LM63_SetStat( llHdl, LM63_DEADBAND, LM63_CH_TEMP, 2 ) == 0 );
+	CHECK( LM63_SetStat( llHdl, LM63_DEADBAND_CNT, 0, 0 ) == 0 );
+	CHECK( LM63_SetStat( llHdl, LM63_FIFO_WAIT, 0, 20 ) == 0 );
+	CHECK( LM63_SetStat( llHdl, LM63_SMPL_START, 0, 1 ) == 0 );
+
+	/* first sample and the step reported only */
+	t0 = LM63SIM_TimeGet( G_bus );
+	while( LM63SIM_TimeGet( G_bus ) - t0 < 400 ){
+		size = sizeof(smpl);
+		CHECK( GetBlk( llHdl, LM63_BLK_FIFO, smpl, &size ) == 0 );
+		for( i=0; i<size/(int32)sizeof(LM63_SAMPLE); i++ ){
+			last = smpl[i].value;
+			nbr++;
+		}
+	}
+	CHECK( nbr == 2 );
+	CHECK( last == 40 );
+	CHECK( Get( llHdl, LM63_DEADBAND_CNT, 0, &value ) == 0 && value >= 30 );
+
+	/* max. silence: a sample every 100ms at least */
+	CHECK( LM63_SetStat( llHdl, LM63_SILENCE_MAX, LM63_CH_TEMP, 100 ) == 0 );
+	nbr = 0;
+	t0 = LM63SIM_TimeGet( G_bus );
+	while( LM63SIM_TimeGet( G_bus ) - t0 < 400 ){
+		size = sizeof(smpl);
+		CHECK( GetBlk( llHdl, LM63_BLK_FIFO, smpl, &size ) == 0 );
+		nbr += size / sizeof(LM63_SAMPLE);
+	}
+	CHECK( nbr >= 3 && nbr <= 5 );
+
+	/* deadband off: all samples */
+	CHECK( LM63_SetStat( llHdl, LM63_DEADBAND, LM63_CH_TEMP, 0 ) == 0 );
+	nbr = 0;
+	t0 = LM63SIM_TimeGet( G_bus );
+	while( LM63SIM_TimeGet( G_bus ) - t0 < 200 ){
+		size = sizeof(smpl);
+		CHECK( GetBlk( llHdl, LM63_BLK_FIFO, smpl, &size ) == 0 );
+		nbr += size / sizeof(LM63_SAMPLE);
+	}
+	CHECK( nbr >= 18 && nbr <= 21 );
+
+	CHECK( LM63_SetStat( llHdl, LM63_SMPL_START, 0, 0 ) == 0 );
+}
+
+/****************************** TestOneShot ********************************/
+/** One-shot conversions
+ *
+ *  \param llHdl      \IN  low-level handle
+ */
+static void TestOneShot( LL_HANDLE *llHdl )
+{
+	/* 35 degrees, 50 degrees after 1s */
+	static const LM63SIM_POINT step[] = {
+		{ 0, 35000 }, { 1000, 35000 }, { 1001, 50000 }, { 100000, 50000 }
+	};
+	LM63SIM_STATS	st;
+	u_int32			t0;
+	int32			value, period;
+
+	CHECK( LM63SIM_WaveSet( G_dev, LM63SIM_WAVE_TEMP, step, 4, FALSE ) == 0 );
+	period = llHdl->convPeriod;
+
+	CHECK( LM63_SetStat( llHdl, LM63_CONV_MODE, 0, 1 ) == 0 );
+	CHECK( (LM63SIM_RegGet( G_dev, LM63_CFG ) & LM63_CFG_STANDBY) != 0 );
+
+	/* no conversions in standby */
+	LM63SIM_StatsGet( G_bus, &st, TRUE );
+	Wait( 10 * period );
+	LM63SIM_StatsGet( G_bus, &st, TRUE );
+	CHECK( st.conversions == 0 );
+
+	/* read converts on demand */
+	t0 = LM63SIM_TimeGet( G_bus );
+	CHECK( LM63_Read( llHdl, LM63_CH_TEMP, &value ) == 0 && value == 35 );
+	CHECK( LM63SIM_TimeGet( G_bus ) - t0 >= LM63SIM_CONV_MS );
+	LM63SIM_StatsGet( G_bus, &st, TRUE );
+	CHECK( st.conversions >= 1 );
+
+	/* the value is not taken from the shadow */
+	Wait( 1000 );
+	CHECK( LM63_Read( llHdl, LM63_CH_TEMP, &value ) == 0 && value == 50 );
+
+	/* no sampler in one-shot mode */
+	CHECK( LM63_SetStat( llHdl, LM63_SMPL_PERIOD, LM63_CH_TEMP, 10 ) == 0 );
+	CHECK( LM63_SetStat( llHdl, LM63_SMPL_START, 0, 1 ) == ERR_LL_DEV_BUSY );
+
+	CHECK( LM63_SetStat( llHdl, LM63_CONV_MODE, 0, 0 ) == 0 );
+	CHECK( (LM63SIM_RegGet( G_dev, LM63_CFG ) & LM63_CFG_STANDBY) == 0 );
+	Wait( 10 * period );
+	LM63SIM_StatsGet( G_bus, &st, TRUE );
+	CHECK( st.conversions > 0 );
+}
+
+/********************************* TestLut *********************************/
+/** Lookup table update restores the write lock
+ *
+ *  \param llHdl      \IN  low-level handle
+ */
+static void TestLut( LL_HANDLE *llHdl )
+{
+	LM63SIM_STATS	st;
+	LM63_LUT		lut, lut2;
+	int32			n, size;
+
+	lut.hys = 4;
+	for( n=0; n<LM63_LUT_NUM; n++ ){
+		lut.entry[n].temp = 30 + 10 * n;
+		lut.entry[n].pwm  = (n * 100) / (LM63_LUT_NUM - 1);
+	}
+
+	/* lookup table controls PWM: write-locked again */
+	CHECK( SetBlk( llHdl, LM63_BLK_LUT, &lut, sizeof(lut) ) == 0 );
+	CHECK( (LM63SIM_RegGet( G_dev, LM63_PWM_RPM ) & PWM_RPM_PROGRAM) == 0 );
+	CHECK( LM63SIM_RegGet( G_dev, LM63_LOOKUP_HYS ) == 4 );
+	for( n=0; n<LM63_LUT_NUM; n++ )
+		CHECK( LM63SIM_RegGet( G_dev, (u_int8)LM63_LOOKUP_TBL_TEMP(n) ) ==
+			   lut.entry[n].temp );
+
+	size = sizeof(lut2);
+	CHECK( GetBlk( llHdl, LM63_BLK_LUT, &lut2, &size ) == 0 &&
+		   size == sizeof(lut2) );
+	CHECK( lut2.hys == lut.hys );
+	for( n=0; n<LM63_LUT_NUM; n++ ){
+		CHECK( lut2.entry[n].temp == lut.entry[n].temp );
+		CHECK( lut2.entry[n].pwm >= lut.entry[n].pwm - 2 &&
+			   lut2.entry[n].pwm <= lut.entry[n].pwm + 2 );
+	}
+
+	/* unchanged table: no entry written */
+	LM63SIM_StatsGet( G_bus, &st, TRUE );
+	CHECK( SetBlk( llHdl, LM63_BLK_LUT, &lut, sizeof(lut) ) == 0 );
+	LM63SIM_StatsGet( G_bus, &st, TRUE );
+	CHECK( st.lockedWrites == 0 );
+	CHECK( st.writeByte <= 2 );		/* unlock + lock */
+
+	/* invalid table: nothing written */
+	lut.entry[3].temp = 0;
+	CHECK( SetBlk( llHdl, LM63_BLK_LUT, &lut, sizeof(lut) ) ==
+		   ERR_LL_ILL_PARAM );
+	LM63SIM_StatsGet( G_bus, &st, TRUE );
+	CHECK( st.writeByte == 0 );
+	lut.entry[3].temp = 60;
+	CHECK( SetBlk( llHdl, LM63_BLK_LUT, &lut, sizeof(lut) - 1 ) ==
+		   ERR_LL_USERBUF );
+
+	/* PWM channel controls PWM: stays unlocked */
+	CHECK( LM63_SetStat( llHdl, LM63_PWM_MANUAL, 0, 1 ) == 0 );
+	lut.hys = 6;
+	CHECK( SetBlk( llHdl, LM63_BLK_LUT, &lut, sizeof(lut) ) == 0 );
+	CHECK( (LM63SIM_RegGet( G_dev, LM63_PWM_RPM ) & PWM_RPM_PROGRAM) != 0 );
+	CHECK( LM63SIM_RegGet( G_dev, LM63_LOOKUP_HYS ) == 6 );
+	CHECK( LM63_Write( llHdl, LM63_CH_PWM, 50 ) == 0 );
+	CHECK( LM63_Read( llHdl, LM63_CH_PWM, &n ) == 0 && n >= 48 && n <= 52 );
+
+	CHECK( LM63_SetStat( llHdl, LM63_PWM_MANUAL, 0, 0 ) == 0 );
+	CHECK( (LM63SIM_RegGet( G_dev, LM63_PWM_RPM ) & PWM_RPM_PROGRAM) == 0 );
+	LM63SIM_StatsGet( G_bus, &st, TRUE );
+	CHECK( st.lockedWrites == 0 );
+}
+
+/******************************** TestRetry ********************************/
+/** Retry of transient SMBus errors
+ *
+ *  Descriptor: SMB_RETRY=3, SMB_RETRY_DELAY=2, SMB_DEADLINE=12
+ *
+ *  \param llHdl      \IN  low-level handle
+ */
+static void TestRetry( LL_HANDLE *llHdl )
+{
+	LM63_PERF	perf;
+	u_int32		t0;
+	int32		n, value, size;
+
+	CHECK( LM63_SetStat( llHdl, LM63_CACHE_BYPASS, 0, 1 ) == 0 );
+	CHECK( LM63_SetStat( llHdl, LM63_PERF_RESET, 0, 0 ) == 0 );
+
+	/* every 4th transaction fails: all reads succeed */
+	LM63SIM_ErrInject( G_bus, 4, 1, SMB_ERR_BUSY );
+	for( n=0; n<20; n++ )
+		CHECK( LM63_Read( llHdl, LM63_CH_TEMP, &value ) == 0 && value == 35 );
+
+	size = sizeof(perf);
+	CHECK( GetBlk( llHdl, LM63_BLK_PERF, &perf, &size ) == 0 );
+	CHECK( perf.xferRetries > 0 );
+	CHECK( perf.xferErrors == perf.xferRetries );
+	CHECK( perf.xferDeadline == 0 );
+
+	/* non-transient error: no retry */
+	CHECK( LM63_SetStat( llHdl, LM63_PERF_RESET, 0, 0 ) == 0 );
+	LM63SIM_ErrInject( G_bus, 1, 1, SMB_ERR_ADDR );
+	CHECK( LM63_Read( llHdl, LM63_CH_TEMP, &value ) == SMB_ERR_ADDR );
+	size = sizeof(perf);
+	CHECK( GetBlk( llHdl, LM63_BLK_PERF, &perf, &size ) == 0 );
+	CHECK( perf.xferErrors == 1 && perf.xferRetries == 0 );
+
+	/* NACK (absent device): permanent, no retry */
+	CHECK( LM63_SetStat( llHdl, LM63_PERF_RESET, 0, 0 ) == 0 );
+	LM63SIM_ErrInject( G_bus, 1, 1, SMB_ERR_NO_DEVICE );
+	t0 = LM63SIM_TimeGet( G_bus );
+	CHECK( LM63_Read( llHdl, LM63_CH_TEMP, &value ) == SMB_ERR_NO_DEVICE );
+	CHECK( LM63SIM_TimeGet( G_bus ) - t0 < 2 );
+	size = sizeof(perf);
+	CHECK( GetBlk( llHdl, LM63_BLK_PERF, &perf, &size ) == 0 );
+	CHECK( perf.xferErrors == 1 && perf.xferRetries == 0 );
+
+	/* permanent transient error: retries after 2 and 4ms, the third
+	   retry (after 8ms) would exceed the deadline (12ms) */
+	CHECK( LM63_SetStat( llHdl, LM63_PERF_RESET, 0, 0 ) == 0 );
+	LM63SIM_ErrInject( G_bus, 1, 1, SMB_ERR_BUSY );
+	t0 = LM63SIM_TimeGet( G_bus );
+	CHECK( LM63_Read( llHdl, LM63_CH_TEMP, &value ) == SMB_ERR_BUSY );
+	CHECK( LM63SIM_TimeGet( G_bus ) - t0 < 12 );
+	size = sizeof(perf);
+	CHECK( GetBlk( llHdl, LM63_BLK_PERF, &perf, &size ) == 0 );
+	CHECK( perf.xferRetries == 2 );
+	CHECK( perf.xferDeadline == 1 );
+	CHECK( perf.xferErrors == 3 );
+
+	/* recovered */
+	LM63SIM_ErrInject( G_bus, 0, 0, 0 );
+	CHECK( LM63_Read( llHdl, LM63_CH_TEMP, &value ) == 0 && value == 35 );
+}
+
+/******************************** TestWarm *********************************/
+/** Warm attach: PWM setup kept, limits programmed again
+ *
+ *  Sessions with WARM_ATTACH=1 and LIM_RMT_HIGH=60 on the device of the
+ *  test handle.
+ *
+ *  \param llHdl      \IN  low-level handle (not used)
+ */
+static void TestWarm( LL_HANDLE *llHdl )
+{
+	LM63SIM_STATS	st;
+	LL_HANDLE		*h;
+	u_int8			pwmValue;
+	int32			value;
+
+	/* first session: no context */
+	CHECK( LM63_Init( (DESC_SPEC*)G_descWarm, NULL, NULL, NULL, NULL,
+					  &h ) == 0 );
+	CHECK( Get( h, LM63_WARM, 0, &value ) == 0 && value == 0 );
+	CHECK( LM63_SetStat( h, LM63_PWM_MANUAL, 0, 1 ) == 0 );
+	CHECK( LM63_Write( h, LM63_CH_PWM, 50 ) == 0 );
+	CHECK( LM63_Exit( &h ) == 0 );
+	pwmValue = LM63SIM_RegGet( G_dev, LM63_PWM_VALUE );
+
+	/* second session: PWM untouched, lost limit restored */
+	LM63SIM_RegSet( G_dev, LM63_RMTTEMP_HIGH_MSB, 0x7f );
+	LM63SIM_StatsGet( G_bus, &st, TRUE );
+	CHECK( LM63_Init( (DESC_SPEC*)G_descWarm, NULL, NULL, NULL, NULL,
+					  &h ) == 0 );
+	LM63SIM_StatsGet( G_bus, &st, TRUE );
+	CHECK( st.lockedWrites == 0 );
+	CHECK( Get( h, LM63_WARM, 0, &value ) == 0 && value == 1 );
+	CHECK( Get( h, LM63_INIT_SAVED, 0, &value ) == 0 && value > 0 );
+	CHECK( LM63SIM_RegGet( G_dev, LM63_RMTTEMP_HIGH_MSB ) == 60 );
+	CHECK( LM63SIM_RegGet( G_dev, LM63_PWM_VALUE ) == pwmValue );
+	CHECK( (LM63SIM_RegGet( G_dev, LM63_PWM_RPM ) & PWM_RPM_PROGRAM) != 0 );
+	CHECK( LM63_Read( h, LM63_CH_PWM, &value ) == 0 &&
+		   value >= 48 && value <= 52 );
+	CHECK( LM63_Exit( &h ) == 0 );
+
+	/* device reconfigured meanwhile: programmed again */
+	LM63SIM_RegSet( G_dev, LM63_PWM_FREQU,
+					(u_int8)(LM63SIM_RegGet( G_dev, LM63_PWM_FREQU ) ^ 1) );
+	CHECK( LM63_Init( (DESC_SPEC*)G_descWarm, NULL, NULL, NULL, NULL,
+					  &h ) == 0 );
+	CHECK( Get( h, LM63_WARM, 0, &value ) == 0 && value == 0 );
+	CHECK( LM63_Exit( &h ) == 0 );
+}
+
+/******************************** TestLimit ********************************/
+/** Limits (resolution, unit) and ALERT status
+ *
+ *  \param llHdl      \IN  low-level handle
+ */
+static void TestLimit( LL_HANDLE *llHdl )
+{
+	int32	value, period;
+
+	period = llHdl->convPeriod;
+
+	/* remote limits: 0.125 degrees resolution */
+	CHECK( LM63_SetStat( llHdl, LM63_TEMP_UNIT, 0, LM63_UNIT_MILLIDEG ) == 0 );
+	CHECK( LM63_SetStat( llHdl, LM63_LIM_RMT_HIGH, 0, 40125 ) == 0 );
+	CHECK( LM63SIM_RegGet( G_dev, LM63_RMTTEMP_HIGH_MSB ) == 40 );
+	CHECK( LM63SIM_RegGet( G_dev, LM63_RMTTEMP_HIGH_LSB ) == 0x20 );
+	CHECK( Get( llHdl, LM63_LIM_RMT_HIGH, 0, &value ) == 0 &&
+		   value == 40125 );
+	CHECK( LM63_SetStat( llHdl, LM63_LIM_RMT_LOW, 0, -10060 ) == 0 );
+	CHECK( LM63SIM_RegGet( G_dev, LM63_RMTTEMP_LOW_MSB ) == 0xf6 );
+	CHECK( Get( llHdl, LM63_LIM_RMT_LOW, 0, &value ) == 0 &&
+		   value == -10000 );
+	CHECK( LM63_SetStat( llHdl, LM63_LIM_RMT_HIGH, 0, 127875 ) == 0 );
+	CHECK( LM63_SetStat( llHdl, LM63_LIM_RMT_HIGH, 0, 127938 ) ==
+		   ERR_LL_ILL_PARAM );
+
+	/* local limits: whole degrees */
+	CHECK( LM63_SetStat( llHdl, LM63_LIM_TEMP_HIGH, 0, 70400 ) == 0 );
+	CHECK( LM63SIM_RegGet( G_dev, LM63_TEMP_HIGH ) == 70 );
+	CHECK( Get( llHdl, LM63_LIM_TEMP_HIGH, 0, &value ) == 0 &&
+		   value == 70000 );
+	CHECK( LM63_SetStat( llHdl, LM63_LIM_TEMP_HIGH, 0, 127500 ) ==
+		   ERR_LL_ILL_PARAM );
+
+	/* degrees: remote limit rounded */
+	CHECK( LM63_SetStat( llHdl, LM63_LIM_RMT_HIGH, 0, 40125 ) == 0 );
+	CHECK( LM63_SetStat( llHdl, LM63_TEMP_UNIT, 0, LM63_UNIT_DEG ) == 0 );
+	CHECK( Get( llHdl, LM63_LIM_RMT_HIGH, 0, &value ) == 0 && value == 40 );
+
+	/* ALERT status from device, even within the coalesce window */
+	CHECK( LM63_SetStat( llHdl, LM63_LIM_RMT_HIGH, 0, 70 ) == 0 );
+	Wait( period + LM63SIM_CONV_MS );
+	CHECK( Get( llHdl, LM63_ALERT_STATUS, 0, &value ) == 0 );
+	CHECK( LM63_SetStat( llHdl, LM63_COALESCE_WIN, 0, 10 * period ) == 0 );
+	CHECK( Get( llHdl, LM63_ALERT_STATUS, 0, &value ) == 0 &&
+		   !(value & LM63_ALERT_RHIGH) );
+	CHECK( LM63_SetStat( llHdl, LM63_LIM_RMT_HIGH, 0, 41 ) == 0 );
+	Wait( period + LM63SIM_CONV_MS );
+	CHECK( Get( llHdl, LM63_ALERT_STATUS, 0, &value ) == 0 &&
+		   (value & LM63_ALERT_RHIGH) );
+
+	CHECK( LM63_SetStat( llHdl, LM63_LIM_RMT_HIGH, 0, 70 ) == 0 );
+	CHECK( LM63_SetStat( llHdl, LM63_COALESCE_WIN, 0, 0 ) == 0 );
+}
+
+/******************************** TestSweep ********************************/
+/** Sensor sweep of the aggregator
+ *
+ *  Sensor 1 on a second bus, sensor 2 on the bus of the device.
+ *  Retries on the second bus must not hold the bus lock of the device.
+ *
+ *  \param llHdl      \IN  low-level handle (not used)
+ */
+static void TestSweep( LL_HANDLE *llHdl )
+{
+	LM63SIM_BUS		*bus2 = NULL;
+	LM63SIM_DEV		*dev;
+	LM63_SENSOR_VAL	val[4];
+	LM63_PERF		perf;
+	LL_HANDLE		*h = NULL;
+	u_int32			t0;
+	int32			n, size;
+
+	if( LM63SIM_BusCreate( BUS_NBR2, 0, &bus2 ) ||
+		LM63SIM_DevAdd( bus2, DEV_ADDR, TACH_PULS, &dev ) ||
+		LM63SIM_DevAdd( G_bus, DEV_ADDR2, TACH_PULS, &dev ) ){
+		CHECK( FALSE );
+		LM63SIM_BusDestroy( &bus2 );
+		return;
+	}
+	/* first conversion (second bus not advanced by OSS_Delay) */
+	LM63SIM_Advance( bus2, 100 );
+
+	CHECK( LM63_Init( (DESC_SPEC*)G_descSweep, NULL, NULL, NULL, NULL,
+					  &h ) == 0 );
+	if( h == NULL ){
+		LM63SIM_BusDestroy( &bus2 );
+		return;
+	}
+	Wait( 100 );
+
+	/* all sensors read, transactions counted */
+	CHECK( LM63_SetStat( h, LM63_PERF_RESET, 0, 0 ) == 0 );
+	size = sizeof(val);
+	CHECK( GetBlk( h, LM63_BLK_SENSORS, val, &size ) == 0 &&
+		   size == 3 * sizeof(LM63_SENSOR_VAL) );
+	for( n=0; n<3; n++ )
+		CHECK( val[n].error == 0 && val[n].temp == 35 &&
+			   val[n].rmtTemp == 45 );
+	size = sizeof(perf);
+	CHECK( GetBlk( h, LM63_BLK_PERF, &perf, &size ) == 0 );
+	CHECK( perf.xfers >= 8 && perf.xferErrors == 0 );
+
+	/* second bus busy: sensor 1 fails after the retries, bus lock of the
+	   device free meanwhile */
+	LM63SIM_ErrInject( bus2, 1, 1, SMB_ERR_BUSY );
+	CHECK( LM63_SetStat( h, LM63_PERF_RESET, 0, 0 ) == 0 );
+	G_lockHdl   = h;
+	G_lockDelay = 0;
+	t0 = LM63SIM_TimeGet( G_bus );
+	size = sizeof(val);
+	CHECK( GetBlk( h, LM63_BLK_SENSORS, val, &size ) == 0 &&
+		   size == 3 * sizeof(LM63_SENSOR_VAL) );
+	G_lockHdl = NULL;
+	CHECK( LM63SIM_TimeGet( G_bus ) - t0 >= 6 );
+	CHECK( G_lockDelay == 0 );
+	CHECK( val[0].error == 0 && val[0].temp == 35 );
+	CHECK( val[1].error == SMB_ERR_BUSY && val[1].temp == 0 );
+	CHECK( val[2].error == 0 && val[2].temp == 35 );
+	size = sizeof(perf);
+	CHECK( GetBlk( h, LM63_BLK_PERF, &perf, &size ) == 0 );
+	CHECK( perf.xferRetries == 2 && perf.xferDeadline == 1 );
+
+	/* sensor 1 absent: fails without retry */
+	LM63SIM_ErrInject( bus2, 1, 1, SMB_ERR_NO_DEVICE );
+	CHECK( LM63_SetStat( h, LM63_PERF_RESET, 0, 0 ) == 0 );
+	size = sizeof(val);
+	CHECK( GetBlk( h, LM63_BLK_SENSORS, val, &size ) == 0 );
+	CHECK( val[1].error == SMB_ERR_NO_DEVICE );
+	CHECK( val[0].error == 0 && val[2].error == 0 );
+	size = sizeof(perf);
+	CHECK( GetBlk( h, LM63_BLK_PERF, &perf, &size ) == 0 );
+	CHECK( perf.xferErrors == 1 && perf.xferRetries == 0 );
+
+	/* recovered, buffer for sensor 0 only */
+	LM63SIM_ErrInject( bus2, 0, 0, 0 );
+	size = sizeof(val);
+	CHECK( GetBlk( h, LM63_BLK_SENSORS, val, &size ) == 0 );
+	CHECK( val[1].error == 0 && val[1].temp == 35 );
+	size = sizeof(LM63_SENSOR_VAL);
+	CHECK( GetBlk( h, LM63_BLK_SENSORS, val, &size ) == 0 &&
+		   size == sizeof(LM63_SENSOR_VAL) );
+
+	CHECK( ((HOST_SEM*)h->busSem)->count == 1 );
+	CHECK( ((HOST_SEM*)h->sweepSem)->count == 1 );
+	CHECK( LM63_Exit( &h ) == 0 );
+	LM63SIM_BusDestroy( &bus2 );
+}
+
+/****************************** TestInitVerify *****************************/
+/** INIT_VERIFY: registers already programmed are not written
+ *
+ *  Sessions with INIT_VERIFY=1 on the device of the test handle.
+ *
+ *  \param llHdl      \IN  low-level handle (not used)
+ */
+static void TestInitVerify( LL_HANDLE *llHdl )
+{
+	LM63SIM_STATS	st;
+	LL_HANDLE		*h;
+	u_int32			cold;
+	int32			saved;
+
+	/* after power-on reset */
+	LM63SIM_DevReset( G_dev );
+	LM63SIM_StatsGet( G_bus, &st, TRUE );
+	CHECK( LM63_Init( (DESC_SPEC*)G_descVerify, NULL, NULL, NULL, NULL,
+					  &h ) == 0 );
+	LM63SIM_StatsGet( G_bus, &st, TRUE );
+	cold = st.writeByte;
+	CHECK( LM63_Exit( &h ) == 0 );
+
+	/* device programmed by previous session: writes saved */
+	LM63SIM_StatsGet( G_bus, &st, TRUE );
+	CHECK( LM63_Init( (DESC_SPEC*)G_descVerify, NULL, NULL, NULL, NULL,
+					  &h ) == 0 );
+	LM63SIM_StatsGet( G_bus, &st, TRUE );
+	CHECK( st.writeByte < cold );
+	CHECK( Get( h, LM63_INIT_SAVED, 0, &saved ) == 0 && saved > 0 );
+	CHECK( LM63_Exit( &h ) == 0 );
+}
+
+/******************************** TestStats ********************************/
+/** Channel statistics of the device reads
+ *
+ *  \param llHdl      \IN  low-level handle
+ */
+static void TestStats( LL_HANDLE *llHdl )
+{
+	/* 30 degrees, 40 degrees after 500ms */
+	static const LM63SIM_POINT step[] = {
+		{ 0, 30000 }, { 500, 30000 }, { 501, 40000 }, { 100000, 40000 }
+	};
+	LM63_STATS		st;
+	LM63_CH_STATS	*chP = &st.ch[LM63_CH_TEMP];
+	int32			n, value, size, period;
+
+	CHECK( LM63SIM_WaveSet( G_dev, LM63SIM_WAVE_TEMP, step, 4, FALSE ) == 0 );
+	period = llHdl->convPeriod;
+	Wait( period + LM63SIM_CONV_MS );
+
+	/* every read from device: 4 reads of 30, 4 reads of 40 degrees */
+	CHECK( LM63_SetStat( llHdl, LM63_CACHE_BYPASS, 0, 1 ) == 0 );
+	size = sizeof(st);
+	CHECK( GetBlk( llHdl, LM63_BLK_STATS_RST, &st, &size ) == 0 );
+	for( n=0; n<4; n++ )
+		CHECK( LM63_Read( llHdl, LM63_CH_TEMP, &value ) == 0 && value == 30 );
+	Wait( 600 );
+	for( n=0; n<4; n++ )
+		CHECK( LM63_Read( llHdl, LM63_CH_TEMP, &value ) == 0 && value == 40 );
+
+	size = sizeof(st);
+	CHECK( GetBlk( llHdl, LM63_BLK_STATS, &st, &size ) == 0 &&
+		   size == sizeof(st) );
+	CHECK( st.intervalMs >= 600 );
+	CHECK( chP->count == 8 );
+	CHECK( chP->min == 30 && chP->max == 40 && chP->mean == 35 );
+	CHECK( chP->last == 40 );
+	CHECK( chP->ewma > 30 && chP->ewma <= 40 );
+
+	/* copy and reset: EWMA and latest value kept */
+	size = sizeof(st);
+	CHECK( GetBlk( llHdl, LM63_BLK_STATS_RST, &st, &size ) == 0 &&
+		   chP->count == 8 );
+	size = sizeof(st);
+	CHECK( GetBlk( llHdl, LM63_BLK_STATS, &st, &size ) == 0 );
+	CHECK( chP->count == 0 && chP->min == 0 && chP->max == 0 &&
+		   chP->mean == 0 );
+	CHECK( chP->last == 40 && chP->ewma > 30 );
+
+	/* unit changed: restarted incl. EWMA */
+	CHECK( LM63_SetStat( llHdl, LM63_TEMP_UNIT, 0, LM63_UNIT_MILLIDEG ) == 0 );
+	CHECK( LM63_Read( llHdl, LM63_CH_TEMP, &value ) == 0 && value == 40000 );
+	size = sizeof(st);
+	CHECK( GetBlk( llHdl, LM63_BLK_STATS, &st, &size ) == 0 );
+	CHECK( chP->count == 1 && chP->ewma == 40000 && chP->last == 40000 );
+	CHECK( LM63_SetStat( llHdl, LM63_TEMP_UNIT, 0, LM63_UNIT_DEG ) == 0 );
+
+	/* buffer too small */
+	size = sizeof(st) - 1;
+	CHECK( GetBlk( llHdl, LM63_BLK_STATS, &st, &size ) == ERR_LL_USERBUF );
+
+	CHECK( LM63_SetStat( llHdl, LM63_CACHE_BYPASS, 0, 0 ) == 0 );
+	CHECK( LM63SIM_WaveSet( G_dev, LM63SIM_WAVE_TEMP, NULL, 0, FALSE ) == 0 );
+}
+
+/*--------------------------------------------------------------------------+
+|   HOST OSS FUNCTIONS (time: simulated SMBus clock)                        |
++--------------------------------------------------------------------------*/
+
+/******************************** AlarmRun *********************************/
+/** Run the due alarms
+ */
+static void AlarmRun( void )
+{
+	u_int32	now, n;
+
+	if( G_inAlarm || !G_bus )
+		return;
+
+	G_inAlarm = TRUE;
+	now = LM63SIM_TimeGet( G_bus );
+
+	for( n=0; n<ALARM_MAX; n++ ){
+		HOST_ALARM *alm = G_alarm[n];
+
+		if( !alm || !alm->active || (int32)(now - alm->next) < 0 )
+			continue;
+
+		if( alm->cyclic ){
+			/* missed expiries are lost */
+			while( (int32)(now - alm->next) >= 0 )
+				alm->next += alm->period;
+		}
+		else
+			alm->active = FALSE;
+
+		alm->funct( alm->arg );
+	}
+
+	G_inAlarm = FALSE;
+}
+
+u_int32 OSS_TickGet( OSS_HANDLE *osHdl )
+{
+	AlarmRun();
+	return( LM63SIM_TimeGet( G_bus ) );
+}
+
+u_int32 OSS_TickRateGet( OSS_HANDLE *osHdl )
+{
+	return( 1000 );
+}
+
+int32 OSS_Delay( OSS_HANDLE *osHdl, int32 msec )
+{
+	int32 n;
+
+	if( G_lockHdl && ((HOST_SEM*)G_lockHdl->busSem)->count == 0 )
+		G_lockDelay++;
+
+	for( n=0; n<msec; n++ ){
+		LM63SIM_Advance( G_bus, 1 );
+		AlarmRun();
+	}
+	return( msec );
+}
+
+char* OSS_Ident( void )
+{
+	return( "OSS host stub (lm63_simtest)" );
+}
+
+int32 OSS_GetSmbHdl( OSS_HANDLE *osHdl, u_int32 busNbr, void **smbHdlP )
+{
+	return( LM63SIM_GetSmbHdl( busNbr, smbHdlP ) );
+}
+
+void* OSS_MemGet( OSS_HANDLE *osHdl, u_int32 size, u_int32 *gotSizeP )
+{
+	*gotSizeP = size;
+	return( malloc( size ) );
+}
+
+int32 OSS_MemFree( OSS_HANDLE *osHdl, void *addr, u_int32 size )
+{
+	free( addr );
+	return( 0 );
+}
+
+void OSS_MemFill( OSS_HANDLE *osHdl, u_int32 size, char *adr, int8 value )
+{
+	memset( adr, value, size );
+}
+
+void OSS_MemCopy( OSS_HANDLE *osHdl, u_int32 size, char *src, char *dest )
+{
+	memcpy( dest, src, size );
+}
+
+int32 OSS_SemCreate( OSS_HANDLE *osHdl, int32 semType, int32 initVal,
+					 OSS_SEM_HANDLE **semHandleP )
+{
+	HOST_SEM *sem = (HOST_SEM*)malloc( sizeof(HOST_SEM) );
+
+	sem->type  = semType;
+	sem->count = initVal;
+	*semHandleP = (OSS_SEM_HANDLE*)sem;
+	return( 0 );
+}
+
+int32 OSS_SemRemove( OSS_HANDLE *osHdl, OSS_SEM_HANDLE **semHandleP )
+{
+	free( *semHandleP );
+	*semHandleP = NULL;
+	return( 0 );
+}
+
+int32 OSS_SemWait( OSS_HANDLE *osHdl, OSS_SEM_HANDLE *semHandle,
+				   int32 msec )
+{
+	HOST_SEM	*sem = (HOST_SEM*)semHandle;
+	int32		n, max;
+
+	max = (msec == OSS_SEM_WAITFOREVER) ? SEM_FOREVER_MS : msec;
+
+	/* single thread: only alarms can signal while waiting */
+	for( n=0; sem->count == 0; n++ ){
+		if( n >= max ){
+			if( msec == OSS_SEM_WAITFOREVER ){
+				printf("  OSS_SemWait: deadlock\n");
+				G_semTimeout++;
+			}
+			return( ERR_OSS_TIMEOUT );
+		}
+		OSS_Delay( osHdl, 1 );
+	}
+
+	sem->count--;
+	return( 0 );
+}
+
+int32 OSS_SemSignal( OSS_HANDLE *osHdl, OSS_SEM_HANDLE *semHandle )
+{
+	HOST_SEM *sem = (HOST_SEM*)semHandle;
+
+	if( sem->type == OSS_SEM_BIN )
+		sem->count = 1;
+	else
+		sem->count++;
+	return( 0 );
+}
+
+int32 OSS_SigCreate( OSS_HANDLE *osHdl, int32 value,
+					 OSS_SIG_HANDLE **sigHandleP )
+{
+	HOST_SIG *sig = (HOST_SIG*)malloc( sizeof(HOST_SIG) );
+
+	sig->sigNo = value;
+	sig->sent  = 0;
+	*sigHandleP = (OSS_SIG_HANDLE*)sig;
+	return( 0 );
+}
+
+int32 OSS_SigRemove( OSS_HANDLE *osHdl, OSS_SIG_HANDLE **sigHandleP )
+{
+	free( *sigHandleP );
+	*sigHandleP = NULL;
+	return( 0 );
+}
+
+int32 OSS_SigSend( OSS_HANDLE *osHdl, OSS_SIG_HANDLE *sigHandle )
+{
+	((HOST_SIG*)sigHandle)->sent++;
+	G_sigSent++;
+	return( 0 );
+}
+
+int32 OSS_AlarmCreate( OSS_HANDLE *osHdl, void (*funct)(void *arg),
+					   void *arg, OSS_ALARM_HANDLE **alarmP )
+{
+	HOST_ALARM	*alm;
+	u_int32		n;
+
+	for( n=0; n<ALARM_MAX && G_alarm[n]; n++ )
+		;
+	if( n == ALARM_MAX )
+		return( ERR_OSS_ALARM_CREATE );
+
+	alm = (HOST_ALARM*)malloc( sizeof(HOST_ALARM) );
+	memset( alm, 0, sizeof(HOST_ALARM) );
+	alm->funct = funct;
+	alm->arg   = arg;
+	G_alarm[n] = alm;
+	*alarmP = (OSS_ALARM_HANDLE*)alm;
+	return( 0 );
+}
+
+int32 OSS_AlarmRemove( OSS_HANDLE *osHdl, OSS_ALARM_HANDLE **alarmP )
+{
+	u_int32 n;
+
+	for( n=0; n<ALARM_MAX; n++ )
+		if( G_alarm[n] == (HOST_ALARM*)*alarmP )
+			G_alarm[n] = NULL;
+
+	free( *alarmP );
+	*alarmP = NULL;
+	return( 0 );
+}
+
+int32 OSS_AlarmSet( OSS_HANDLE *osHdl, OSS_ALARM_HANDLE *alarm,
+					u_int32 msec, u_int32 cyclic, u_int32 *realMsecP )
+{
+	HOST_ALARM *alm = (HOST_ALARM*)alarm;
+
+	if( alm->active )
+		return( ERR_OSS_ALARM_SET );
+
+	alm->period = msec;
+	alm->cyclic = cyclic;
+	alm->next   = LM63SIM_TimeGet( G_bus ) + msec;
+	alm->active = TRUE;
+	*realMsecP  = msec;
+	return( 0 );
+}
+
+int32 OSS_AlarmClear( OSS_HANDLE *osHdl, OSS_ALARM_HANDLE *alarm )
+{
+	HOST_ALARM *alm = (HOST_ALARM*)alarm;
+
+	if( !alm->active )
+		return( ERR_OSS_ALARM_CLR );
+
+	alm->active = FALSE;
+	return( 0 );
+}
+
+/*--------------------------------------------------------------------------+
+|   HOST DESC FUNCTIONS (descriptor: DESC_KEY table)                        |
++--------------------------------------------------------------------------*/
+
+int32 DESC_Init( DESC_SPEC *descSpec, OSS_HANDLE *osHdl,
+				 DESC_HANDLE **descHandleP )
+{
+	*descHandleP = (DESC_HANDLE*)descSpec;
+	return( 0 );
+}
+
+int32 DESC_Exit( DESC_HANDLE **descHandleP )
+{
+	*descHandleP = NULL;
+	return( 0 );
+}
+
+void DESC_DbgLevelSet( DESC_HANDLE *descHandle, u_int32 dbgLevel )
+{
+}
+
+char* DESC_Ident( void )
+{
+	return( "DESC host stub (lm63_simtest)" );
+}
+
+int32 DESC_GetUInt32( DESC_HANDLE *descHandle, u_int32 defVal,
+					  u_int32 *valueP, char *keyFmt, ... )
+{
+	const DESC_KEY	*keyP = (const DESC_KEY*)descHandle;
+	char			key[64];
+	va_list			argptr;
+
+	va_start( argptr, keyFmt );
+	vsprintf( key, keyFmt, argptr );
+	va_end( argptr );
+
+	*valueP = defVal;
+
+	for( ; keyP->key; keyP++ ){
+		if( !strcmp( keyP->key, key ) ){
+			*valueP = keyP->value;
+			return( 0 );
+		}
+	}
+
+	return( ERR_DESC_KEY_NOTFOUND );
+}
@@ -11,8 +11,12 @@
  *
  *               Reads from all channels and compares the values
  *
- *     Required: libraries: mdis_api, usr_oss, usr_utl
- *     \switches (none)
+ *               Fleet mode (-l): checks a list of devices at once with one
+ *               worker thread per SMBus bus and prints a summary with a
+ *               result code per device.
+ *
+ *     Required: libraries: mdis_api, usr_oss, usr_utl (LINUX: pthread)
+ *     \switches LINUX - worker threads in fleet mode (otherwise sequential)
  *
  *---------------------------------------------------------------------------
  * Copyright 2009-2019, MEN Mikro Elektronik GmbH
@@ -38,6 +42,15 @@
 +-------------------------------------*/
 #define MAX_TEMP		60
 #define DEFAULT_DIFF	10
+#define FLEET_MAX		64		/* max. number of devices in fleet mode */
+
+/** \name fleet mode result codes (per device, max. is the exit code) */
+/**@{*/
+#define FLEET_OK		0		/**< temperatures within limits */
+#define FLEET_TEMP		1		/**< temperature too high */
+#define FLEET_DELTA		2		/**< temperature delta too high */
+#define FLEET_ERROR		3		/**< device access failed */
+/**@}*/
 
 /*-------------------------------------+
 |   INCLUDES                           |
@@ -45,6 +58,9 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#ifdef LINUX
+# include <pthread.h>
+#endif
 #include <MEN/men_typs.h>
 #include <MEN/mdis_api.h>
 #include <MEN/usr_oss.h>
@@ -53,10 +69,51 @@
 
 static const char IdentString[]=MENT_XSTR(MAK_REVISION);
 
+/*-------------------------------------+
+|   TYPEDEFS                           |
++-------------------------------------*/
+/** fleet mode: device */
+typedef struct {
+	char		*name;			/**< device name */
+	MDIS_PATH	path;			/**< MDIS path (-1=not open) */
+	int32		busNbr;			/**< SMBus bus number */
+	int32		convPeriod;		/**< conversion period [ms] */
+	int32		unit;			/**< temperature unit (1 or 1000) */
+	int32		tempDie;		/**< die temperature (unit) */
+	int32		tempRmt;		/**< remote temperature (unit) */
+	int32		tempDiff;		/**< temperature delta (unit) */
+	int32		result;			/**< FLEET_xxx */
+	char		*errInfo;		/**< failed call (FLEET_ERROR) */
+	int32		errCode;		/**< MDIS error code (FLEET_ERROR) */
+	u_int32		ms;				/**< duration of check [ms] */
+} FLEET_DEV;
+
+/** fleet mode: SMBus bus with its devices */
+typedef struct {
+	int32		busNbr;			/**< SMBus bus number */
+	int32		maxtemp;		/**< max. temperature [degree celsius] */
+	int32		tempDelta;		/**< max. delta [degree celsius] */
+	int32		devNum;			/**< number of devices */
+	FLEET_DEV	*dev[FLEET_MAX];/**< devices on this bus */
+#ifdef LINUX
+	pthread_t	thread;			/**< worker thread */
+	int			started;		/**< worker thread created */
+#endif
+} FLEET_BUS;
+
+/*-------------------------------------+
+|   GLOBALS                            |
++-------------------------------------*/
+static FLEET_DEV G_dev[FLEET_MAX];
+static FLEET_BUS G_bus[FLEET_MAX];
+
 /*-------------------------------------+
 |   PROTOTYPES                         |
 +-------------------------------------*/
 static void PrintError( char* );
+static int32 Fleet( char *listP, int32 maxtemp, int32 tempDelta );
+static void *FleetWorker( void *arg );
+static void FleetCheck( FLEET_DEV *dev, int32 maxtemp, int32 tempDelta );
 
 /********************************* header **********************************/
 /**  Prints the headline
@@ -76,18 +133,26 @@ static void usage(void)
 {
 	printf(
 		"\nUsage:     lm63_test <device> [<opts>] \n"
+		"           lm63_test -l=<device>,<device>,... [<opts>] \n"
 		"\nFunction:  LM63 test tool to check temperatures"
 		"\nOptions: \n"
 		"    device    device name e.g. lm63_1 \n"
 		"    [-t=dec]  max. temperature - default: 60 degree Celsius \n"
 		"    [-d=dec]  max. difference between DIE and REMOTE temperature \n"
 		"              - default: 10 degree Celsius \n"
+		"    [-l=list] fleet mode: check all devices of the comma separated \n"
+		"              list once, concurrently per SMBus bus (max. %d) \n"
+		"\nFleet mode result codes (per device, max. is the exit code):\n"
+		"    0=OK, 1=temperature too high, 2=delta too high, 3=device error \n"
 		"\nCalling examples:\n"
 		"\n - test with default values: \n"
 		"     lm63_test lm63_1 \n"
 		"\n - test with user define values: \n"
 		"     lm63_test lm63_1 -t=80 -d=5   \n"
-		"\nCopyright 2009-2019, MEN Mikro Elektronik GmbH\n%s\n\n", IdentString
+		"\n - check several devices: \n"
+		"     lm63_test -l=lm63_1,lm63_2,lm63_3 -t=80 \n"
+		"\nCopyright 2009-2019, MEN Mikro Elektronik GmbH\n%s\n\n",
+		FLEET_MAX, IdentString
 		);
 }
 
@@ -97,7 +162,8 @@ static void usage(void)
  *  \param argc       \IN  argument counter
  *  \param argv       \IN  argument vector
  *
- *  \return	          success (0) or error (1)
+ *  \return	          success (0) or error (1)\n
+ *                    fleet mode: highest result code of all devices
  */
 int main(int argc, char *argv[])
 {
@@ -110,7 +176,7 @@ int main(int argc, char *argv[])
 	/*--------------------+
     |  check arguments    |
     +--------------------*/
-    errstr = UTL_ILLIOPT( "?d=t=", ebuf );
+    errstr = UTL_ILLIOPT( "?d=t=l=", ebuf );
 	if( errstr ) {
 		printf( "*** %s\n", errstr );
 		usage();
@@ -124,6 +190,14 @@ int main(int argc, char *argv[])
 	/*--------------------+
 	|  get arguments      |
 	+--------------------*/
+	maxtemp   = ( (optp = UTL_TSTOPT("t=")) ? atoi(optp) : MAX_TEMP );		/* max temp */
+	tempDelta = ( (optp = UTL_TSTOPT("d=")) ? atoi(optp) : DEFAULT_DIFF );	/* max diff */
+
+	if( (optp = UTL_TSTOPT("l=")) ) {
+		header();
+		return( Fleet( optp, maxtemp, tempDelta ) );
+	}
+
 	deviceP = argv[1];
 
 	if( !deviceP ) {
@@ -132,9 +206,6 @@ int main(int argc, char *argv[])
 		return(1);
 	}
 
-	maxtemp   = ( (optp = UTL_TSTOPT("t=")) ? atoi(optp) : MAX_TEMP );		/* max temp */
-	tempDelta = ( (optp = UTL_TSTOPT("d=")) ? atoi(optp) : DEFAULT_DIFF );	/* max diff */
-
 	/*--------------------+
     |  open path          |
     +--------------------*/
@@ -234,6 +305,221 @@ int main(int argc, char *argv[])
 	return(0);
 }
 
+/*********************************** Fleet *********************************/
+/** Check a list of devices concurrently
+ *
+ *  Opens all devices and groups them by SMBus bus. One worker per bus
+ *  checks its devices one after the other, the buses are checked in
+ *  parallel. Each device is read once (one M_getblock() snapshot),
+ *  so the check takes about one conversion period, independent of
+ *  the number of devices.
+ *
+ *  \param listP      \IN  comma separated device names
+ *  \param maxtemp    \IN  max. temperature [degree celsius]
+ *  \param tempDelta  \IN  max. delta [degree celsius]
+ *
+ *  \return           highest result code (FLEET_xxx)
+ */
+static int32 Fleet( char *listP, int32 maxtemp, int32 tempDelta )
+{
+	FLEET_DEV	*dev;
+	FLEET_BUS	*bus;
+	char		*nameP;
+	int32		devNum=0, busNbr=0, i, b, unit, result=FLEET_OK;
+	int32		maxPeriod=0, failed=0;
+	u_int32		t0, elapsed;
+
+	/*--------------------+
+	|  parse list         |
+	+--------------------*/
+	for( nameP = strtok( listP, "," ); nameP; nameP = strtok( NULL, "," ) ){
+		if( devNum == FLEET_MAX ){
+			printf( "*** too many devices (max. %d)\n", FLEET_MAX );
+			return( FLEET_ERROR );
+		}
+		dev = &G_dev[devNum++];
+		memset( dev, 0, sizeof(*dev) );
+		dev->name = nameP;
+		dev->path = -1;
+	}
+
+	if( !devNum ) {
+		printf( "\n***ERROR: missing LM63 device name!\n" );
+		usage();
+		return( FLEET_ERROR );
+	}
+
+	/*--------------------+
+	|  open, group by bus |
+	+--------------------*/
+	for( i=0; i<devNum; i++ ){
+		dev = &G_dev[i];
+
+		if( (dev->path = M_open( dev->name )) < 0 ){
+			dev->errInfo = "open";
+			goto failed;
+		}
+		if( M_getstat( dev->path, LM63_SMB_BUSNBR, &dev->busNbr ) < 0 ){
+			dev->errInfo = "getstat LM63_SMB_BUSNBR";
+			goto failed;
+		}
+		if( M_getstat( dev->path, LM63_CONV_PERIOD, &dev->convPeriod ) < 0 ){
+			dev->errInfo = "getstat LM63_CONV_PERIOD";
+			goto failed;
+		}
+		if( M_getstat( dev->path, LM63_TEMP_UNIT, &unit ) < 0 ){
+			dev->errInfo = "getstat LM63_TEMP_UNIT";
+			goto failed;
+		}
+		dev->unit = (unit == LM63_UNIT_MILLIDEG) ? 1000 : 1;
+
+		if( dev->convPeriod > maxPeriod )
+			maxPeriod = dev->convPeriod;
+
+		for( b=0; b<busNbr; b++ )
+			if( G_bus[b].busNbr == dev->busNbr )
+				break;
+
+		bus = &G_bus[b];
+		if( b == busNbr ){
+			memset( bus, 0, sizeof(*bus) );
+			bus->busNbr    = dev->busNbr;
+			bus->maxtemp   = maxtemp;
+			bus->tempDelta = tempDelta;
+			busNbr++;
+		}
+		bus->dev[bus->devNum++] = dev;
+		continue;
+
+	failed:
+		dev->result  = FLEET_ERROR;
+		dev->errCode = UOS_ErrnoGet();
+	}
+
+	/*--------------------+
+	|  check              |
+	+--------------------*/
+	printf( "checking %d devices on %d SMBus buses (max. %d / %d degree celsius)\n",
+			(int)devNum, (int)busNbr, (int)maxtemp, (int)tempDelta );
+
+	t0 = UOS_MsecTimerGet();
+
+#ifdef LINUX
+	for( b=0; b<busNbr; b++ )
+		G_bus[b].started = !pthread_create( &G_bus[b].thread, NULL,
+											FleetWorker, &G_bus[b] );
+
+	/* no thread: check in this context */
+	for( b=0; b<busNbr; b++ ){
+		if( G_bus[b].started )
+			pthread_join( G_bus[b].thread, NULL );
+		else
+			FleetWorker( &G_bus[b] );
+	}
+#else
+	for( b=0; b<busNbr; b++ )
+		FleetWorker( &G_bus[b] );
+#endif
+
+	elapsed = UOS_MsecTimerGet() - t0;
+
+	/*--------------------+
+	|  summary            |
+	+--------------------*/
+	printf( "\n%-16s %4s %8s %8s %8s %6s  %s\n",
+			"device", "bus", "die", "remote", "delta", "ms", "result" );
+
+	for( i=0; i<devNum; i++ ){
+		dev = &G_dev[i];
+
+		if( dev->result == FLEET_ERROR ){
+			printf( "%-16s %4s %8s %8s %8s %6s  %d can't %s: %s\n",
+					dev->name, "-", "-", "-", "-", "-", (int)dev->result,
+					dev->errInfo, M_errstring( dev->errCode ) );
+		}
+		else {
+			printf( "%-16s %4d %8.1f %8.1f %8.1f %6u  %d %s\n",
+					dev->name, (int)dev->busNbr,
+					(double)dev->tempDie  / dev->unit,
+					(double)dev->tempRmt  / dev->unit,
+					(double)dev->tempDiff / dev->unit,
+					(unsigned)dev->ms, (int)dev->result,
+					dev->result == FLEET_TEMP  ? "TEMPERATURE TOO HIGH" :
+					dev->result == FLEET_DELTA ? "DELTA TOO HIGH" : "OK" );
+		}
+
+		if( dev->result != FLEET_OK )
+			failed++;
+		if( dev->result > result )
+			result = dev->result;
+
+		if( dev->path >= 0 && M_close( dev->path ) < 0 )
+			PrintError( "close" );
+	}
+
+	printf( "\n%d devices, %d OK, %d failed - %u ms (max. conversion period %d ms)\n",
+			(int)devNum, (int)(devNum - failed), (int)failed,
+			(unsigned)elapsed, (int)maxPeriod );
+
+	return( result );
+}
+
+/******************************** FleetWorker ******************************/
+/** Check all devices of a bus
+ *
+ *  \param arg        \IN  bus (FLEET_BUS)
+ *
+ *  \return           NULL
+ */
+static void *FleetWorker( void *arg )
+{
+	FLEET_BUS	*bus = (FLEET_BUS*)arg;
+	int32		i;
+
+	for( i=0; i<bus->devNum; i++ )
+		FleetCheck( bus->dev[i], bus->maxtemp, bus->tempDelta );
+
+	return( NULL );
+}
+
+/******************************** FleetCheck *******************************/
+/** Read the temperatures of a device once and check the limits
+ *
+ *  \param dev        \IN  device (opened)
+ *                    \OUT temperatures, result, duration
+ *  \param maxtemp    \IN  max. temperature [degree celsius]
+ *  \param tempDelta  \IN  max. delta [degree celsius]
+ */
+static void FleetCheck( FLEET_DEV *dev, int32 maxtemp, int32 tempDelta )
+{
+	int32	buf[LM63_CH_RMTTEMP+1];
+	u_int32	t0 = UOS_MsecTimerGet();
+
+	/* snapshot of both temperature channels */
+	if( M_getblock( dev->path, (u_int8*)buf, sizeof(buf) ) < (int32)sizeof(buf) ){
+		dev->result  = FLEET_ERROR;
+		dev->errInfo = "getblock";
+		dev->errCode = UOS_ErrnoGet();
+		dev->ms      = UOS_MsecTimerGet() - t0;
+		return;
+	}
+	dev->ms = UOS_MsecTimerGet() - t0;
+
+	dev->tempDie  = buf[LM63_CH_TEMP];
+	dev->tempRmt  = buf[LM63_CH_RMTTEMP];
+	dev->tempDiff = dev->tempRmt - dev->tempDie;
+	if( dev->tempDiff < 0 )
+		dev->tempDiff = -dev->tempDiff;
+
+	if( dev->tempDie > maxtemp * dev->unit ||
+		dev->tempRmt > maxtemp * dev->unit )
+		dev->result = FLEET_TEMP;
+	else if( dev->tempDiff > tempDelta * dev->unit )
+		dev->result = FLEET_DELTA;
+	else
+		dev->result = FLEET_OK;
+}
+
 /********************************* PrintError ******************************/
 /** Print MDIS error message
  *
@@ -31,6 +31,11 @@ MAK_LIBS=$(LIB_PREFIX)$(MEN_LIB_DIR)/mdis_api$(LIB_SUFFIX)	\
 		 $(LIB_PREFIX)$(MEN_LIB_DIR)/usr_oss$(LIB_SUFFIX)   \
 		 $(LIB_PREFIX)$(MEN_LIB_DIR)/usr_utl$(LIB_SUFFIX)
 
+# LINUX: worker threads of the fleet mode (see lm63_test.c)
+ifdef MEN_LIN_DIR
+MAK_LIBS+= -lpthread
+endif
+
 MAK_INCL=$(MEN_INC_DIR)/lm63_drv.h	\
          $(MEN_INC_DIR)/men_typs.h	\
          $(MEN_INC_DIR)/mdis_api.h	\
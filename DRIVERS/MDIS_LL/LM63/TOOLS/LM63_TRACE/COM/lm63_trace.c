@@ -0,0 +1,448 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                   LM63_TRACE                       ************
+ ************                                                    ************
+ ****************************************************************************/
+/*!
+ *         \file lm63_trace.c
+ *       \author dieter.pfeuffer@men.de
+ *
+ *        \brief Binary trace recorder and CSV converter for the LM63 driver.
+ *
+ *               Records snapshots of all channels (M_getblock) into a
+ *               compact binary trace file (see lm63_trc.h) or converts a
+ *               trace file into CSV.
+ *
+ *     Required: libraries: mdis_api, usr_oss, usr_utl, lm63_trc
+ *     \switches (none)
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*-------------------------------------+
+|   DEFINES                            |
++-------------------------------------*/
+#define DEFAULT_PERIOD	1000
+#define DEFAULT_FLUSH	60
+#define READ_CHUNK		4096
+
+/*-------------------------------------+
+|   INCLUDES                           |
++-------------------------------------*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <MEN/men_typs.h>
+#include <MEN/mdis_api.h>
+#include <MEN/usr_oss.h>
+#include <MEN/usr_utl.h>
+#include <MEN/lm63_drv.h>
+#include <MEN/lm63_trc.h>
+
+static const char IdentString[]=MENT_XSTR(MAK_REVISION);
+
+/** CSV column names (index: channel) */
+static const char *G_chName[LM63TRC_CH_MAX] = {
+	"temp", "rmt_temp", "fan_speed", "pwm"
+};
+
+/*-------------------------------------+
+|   PROTOTYPES                         |
++-------------------------------------*/
+static void PrintError( char* );
+static int32 Record( char *deviceP, char *fileP, u_int32 period,
+					 u_int32 samples, u_int32 flush );
+static int32 Export( char *fileP, int32 absTime, int32 summary );
+static int32 FileWrite( void *arg, const u_int8 *buf, u_int32 len );
+
+/********************************* header **********************************/
+/**  Prints the headline
+ */
+static void header(void)
+{
+	printf("\n======================="
+		   "\n===    LM63_TRACE   ==="
+		   "\n======================="
+		   "\nCopyright 2026, MEN Mikro Elektronik GmbH\n%s\n\n", IdentString);
+}
+
+/********************************* usage ***********************************/
+/**  Prints the program usage
+ */
+static void usage(void)
+{
+	printf(
+		"\nUsage:     lm63_trace <device> -o=<file> [<opts>] \n"
+		"           lm63_trace -x=<file> [<opts>] \n"
+		"\nFunction:  LM63 binary trace recorder and CSV converter"
+		"\nOptions: \n"
+		"    device    device name e.g. lm63_1 \n"
+		"    -o=file   record into trace file (appended) \n"
+		"    [-p=dec]  sample period [ms] - default: %d \n"
+		"    [-n=dec]  number of samples - default: 0 (until keypress) \n"
+		"    [-f=dec]  write file every n samples - default: %d \n"
+		"    -x=file   convert trace file to CSV (stdout) \n"
+		"    [-a]      absolute time [s since 1970] - default: since start \n"
+		"    [-s]      print summary only \n"
+		"\nCalling examples:\n"
+		"\n - record at 1Hz until keypress: \n"
+		"     lm63_trace lm63_1 -o=lm63_1.trc \n"
+		"\n - convert to CSV: \n"
+		"     lm63_trace -x=lm63_1.trc -a > lm63_1.csv \n"
+		"\nCopyright 2026, MEN Mikro Elektronik GmbH\n%s\n\n",
+		DEFAULT_PERIOD, DEFAULT_FLUSH, IdentString
+		);
+}
+
+/***************************************************************************/
+/** Program main function
+ *
+ *  \param argc       \IN  argument counter
+ *  \param argv       \IN  argument vector
+ *
+ *  \return	          success (0) or error (1)
+ */
+int main(int argc, char *argv[])
+{
+	char      *deviceP=NULL, *fileP;
+	char      *optp=NULL, *errstr=NULL, ebuf[100];
+	u_int32   period, samples, flush;
+
+	/*--------------------+
+    |  check arguments    |
+    +--------------------*/
+    errstr = UTL_ILLIOPT( "?o=p=n=f=x=as", ebuf );
+	if( errstr ) {
+		printf( "*** %s\n", errstr );
+		usage();
+		return(1);
+	}
+	if( UTL_TSTOPT("?") ) {
+		usage();
+		return(0);
+	}
+
+	/*--------------------+
+	|  convert            |
+	+--------------------*/
+	if( (fileP = UTL_TSTOPT("x=")) )
+		return( Export( fileP, UTL_TSTOPT("a") ? 1 : 0,
+						UTL_TSTOPT("s") ? 1 : 0 ) ? 1 : 0 );
+
+	/*--------------------+
+	|  record             |
+	+--------------------*/
+	deviceP = argv[1];
+
+	if( !deviceP || *deviceP == '-' ) {
+		printf( "\n***ERROR: missing LM63 device name!\n" );
+		usage();
+		return(1);
+	}
+	if( !(fileP = UTL_TSTOPT("o=")) ) {
+		printf( "\n***ERROR: missing trace file name!\n" );
+		usage();
+		return(1);
+	}
+
+	period  = ( (optp = UTL_TSTOPT("p=")) ? atoi(optp) : DEFAULT_PERIOD );
+	samples = ( (optp = UTL_TSTOPT("n=")) ? atoi(optp) : 0 );
+	flush   = ( (optp = UTL_TSTOPT("f=")) ? atoi(optp) : DEFAULT_FLUSH );
+
+	header();
+
+	return( Record( deviceP, fileP, period, samples, flush ) ? 1 : 0 );
+}
+
+/********************************** Record *********************************/
+/** Record channel snapshots into trace file
+ *
+ *  \param deviceP    \IN  device name
+ *  \param fileP      \IN  trace file name
+ *  \param period     \IN  sample period [ms]
+ *  \param samples    \IN  number of samples (0=until keypress)
+ *  \param flush      \IN  samples per block (file write)
+ *
+ *  \return	          success (0) or error (1)
+ */
+static int32 Record(
+	char		*deviceP,
+	char		*fileP,
+	u_int32		period,
+	u_int32		samples,
+	u_int32		flush
+)
+{
+	MDIS_PATH	path;
+	FILE		*fp = NULL;
+	LM63TRC_ENC	*enc = NULL;
+	LM63TRC_HDR	hdr;
+	M_SG_BLOCK	blk;
+	int32		nbrOfCh, value, val[LM63TRC_CH_MAX], ret = 1;
+	u_int32		n, t0, elapsed;
+
+	/*--------------------+
+    |  open path          |
+    +--------------------*/
+	if ((path = M_open(deviceP)) < 0) {
+		PrintError("open");
+		return(1);
+	}
+
+	/* get number of channels */
+	if ((M_getstat(path, M_LL_CH_NUMBER, &nbrOfCh)) < 0) {
+		PrintError("getstat M_LL_CH_NUMBER");
+		goto abort;
+	}
+	if( nbrOfCh > LM63TRC_CH_MAX )
+		nbrOfCh = LM63TRC_CH_MAX;
+
+	/*--------------------+
+    |  trace header       |
+    +--------------------*/
+	memset( &hdr, 0, sizeof(hdr) );
+	hdr.chMask   = (1 << nbrOfCh) - 1;
+	hdr.startSec = (u_int32)time( NULL );
+
+	if ((M_getstat(path, LM63_SMB_DEVADDR, &value)) < 0) {
+		PrintError("getstat LM63_SMB_DEVADDR");
+		goto abort;
+	}
+	hdr.smbAddr = value;
+
+	if ((M_getstat(path, LM63_TEMP_UNIT, &value)) < 0) {
+		PrintError("getstat LM63_TEMP_UNIT");
+		goto abort;
+	}
+	hdr.tempUnit = value;
+
+	blk.size = LM63TRC_IDENT_MAX - 1;
+	blk.data = (void*)hdr.ident;
+	if ((M_getstat(path, M_MK_BLK_REV_ID, (int32*)&blk)) < 0) {
+		PrintError("getstat M_MK_BLK_REV_ID");
+		goto abort;
+	}
+
+	/*--------------------+
+    |  open trace file    |
+    +--------------------*/
+	if( (enc = (LM63TRC_ENC*)malloc( sizeof(LM63TRC_ENC) )) == NULL ) {
+		printf( "\n***ERROR: can't alloc encoder!\n" );
+		goto abort;
+	}
+	if( (fp = fopen( fileP, "ab" )) == NULL ) {
+		printf( "\n***ERROR: can't open %s!\n", fileP );
+		goto abort;
+	}
+	if( LM63TRC_EncInit( enc, &hdr, flush, FileWrite, fp ) ) {
+		printf( "\n***ERROR: can't write %s!\n", fileP );
+		goto abort;
+	}
+
+	printf( "recording %d channels every %u ms into %s%s\n", (int)nbrOfCh,
+			(unsigned)period, fileP, samples ? "" : " (press any key to stop)" );
+
+	/*--------------------+
+    |  record             |
+    +--------------------*/
+	memset( val, 0, sizeof(val) );
+
+	for( n=0; !samples || (n < samples); n++ ) {
+		t0 = UOS_MsecTimerGet();
+
+		if ((M_getblock(path, (u_int8*)val, nbrOfCh * 4)) < 0) {
+			PrintError("getblock");
+			goto flush;
+		}
+		if( LM63TRC_EncPut( enc, t0, val ) ) {
+			printf( "\n***ERROR: can't write %s!\n", fileP );
+			goto flush;
+		}
+
+		if( UOS_KeyPressed() != -1 )
+			break;
+
+		elapsed = UOS_MsecTimerGet() - t0;
+		if( elapsed < period )
+			UOS_Delay( period - elapsed );
+	}
+
+	ret = 0;
+	printf( "%u samples recorded\n", (unsigned)n );
+
+	/*--------------------+
+    |  cleanup            |
+    +--------------------*/
+	flush:
+	if( LM63TRC_EncFlush( enc ) ) {
+		printf( "\n***ERROR: can't write %s!\n", fileP );
+		ret = 1;
+	}
+
+	abort:
+	if( fp )
+		fclose( fp );
+	free( enc );
+	if (M_close(path) < 0) {
+		PrintError("close");
+		return(1);
+	}
+
+	return(ret);
+}
+
+/********************************** Export *********************************/
+/** Convert trace file to CSV
+ *
+ *  Each header of the trace file starts a new CSV section with comment
+ *  lines (device identity) and a column header line.
+ *
+ *  \param fileP      \IN  trace file name
+ *  \param absTime    \IN  print absolute time (if known)
+ *  \param summary    \IN  print summary only
+ *
+ *  \return	          success (0) or error (1)
+ */
+static int32 Export(
+	char		*fileP,
+	int32		absTime,
+	int32		summary
+)
+{
+	FILE		*fp;
+	LM63TRC_DEC	*dec;
+	LM63TRC_REC	rec;
+	u_int8		buf[READ_CHUNK];
+	u_int32		len = 0, off = 0, bytes = 0, recs = 0, hdrs = 0, ch, sec;
+	int32		ev, eof = FALSE;
+
+	if( (dec = (LM63TRC_DEC*)malloc( sizeof(LM63TRC_DEC) )) == NULL ) {
+		printf( "\n***ERROR: can't alloc decoder!\n" );
+		return(1);
+	}
+	if( (fp = fopen( fileP, "rb" )) == NULL ) {
+		printf( "\n***ERROR: can't open %s!\n", fileP );
+		free( dec );
+		return(1);
+	}
+
+	LM63TRC_DecInit( dec );
+
+	while( !eof || (off < len) ) {
+		/* feed decoder */
+		if( off == len && !eof ) {
+			len = (u_int32)fread( buf, 1, sizeof(buf), fp );
+			off = 0;
+			bytes += len;
+			eof = (len < sizeof(buf));
+		}
+		off += LM63TRC_DecPut( dec, &buf[off], len - off );
+
+		/* decode */
+		while( (ev = LM63TRC_DecGet( dec, &rec )) != LM63TRC_EV_NONE ) {
+			if( ev == LM63TRC_EV_HDR ) {
+				hdrs++;
+				if( summary )
+					continue;
+				printf( "# ident: %s\n", dec->hdr.ident );
+				printf( "# smb_addr: 0x%02x\n", (unsigned)dec->hdr.smbAddr );
+				printf( "# temp_unit: %s\n",
+						dec->hdr.tempUnit == LM63_UNIT_MILLIDEG ?
+						"milli-degrees Celsius" : "degrees Celsius" );
+				printf( "# start: %u\n", (unsigned)dec->hdr.startSec );
+				printf( "time" );
+				for( ch=0; ch<LM63TRC_CH_MAX; ch++ ) {
+					if( dec->hdr.chMask & (1 << ch) )
+						printf( ",%s", G_chName[ch] );
+				}
+				printf( "\n" );
+			}
+			else if( ev == LM63TRC_EV_REC ) {
+				recs++;
+				if( summary )
+					continue;
+				sec = rec.sec;
+				if( absTime && dec->hdr.startSec )
+					sec += dec->hdr.startSec;
+				printf( "%u.%03u", (unsigned)sec, (unsigned)rec.ms );
+				for( ch=0; ch<LM63TRC_CH_MAX; ch++ ) {
+					if( dec->hdr.chMask & (1 << ch) )
+						printf( ",%d", (int)rec.value[ch] );
+				}
+				printf( "\n" );
+			}
+		}
+	}
+
+	if( dec->errors )
+		fprintf( stderr, "*** %u damaged parts skipped\n",
+				 (unsigned)dec->errors );
+	if( dec->wr != dec->rd )
+		fprintf( stderr, "*** incomplete block at end of file (%u bytes)\n",
+				 (unsigned)(dec->wr - dec->rd) );
+
+	if( summary ) {
+		printf( "file      %s\n", fileP );
+		printf( "bytes     %u\n", (unsigned)bytes );
+		printf( "headers   %u\n", (unsigned)hdrs );
+		printf( "records   %u\n", (unsigned)recs );
+		printf( "errors    %u\n", (unsigned)dec->errors );
+		if( recs )
+			printf( "bytes/rec %.2f\n", (double)bytes / recs );
+	}
+
+	ev = dec->errors ? 1 : 0;
+	fclose( fp );
+	free( dec );
+	return( ev );
+}
+
+/********************************* FileWrite *******************************/
+/** Write function of the trace encoder
+ *
+ *  \param arg        \IN  FILE pointer
+ *  \param buf        \IN  data
+ *  \param len        \IN  length [bytes]
+ *
+ *  \return	          success (0) or error (1)
+ */
+static int32 FileWrite(
+	void			*arg,
+	const u_int8	*buf,
+	u_int32			len
+)
+{
+	FILE	*fp = (FILE*)arg;
+
+	if( fwrite( buf, 1, len, fp ) != len || fflush( fp ) )
+		return(1);
+
+	return(0);
+}
+
+/********************************* PrintError ******************************/
+/** Print MDIS error message
+ *
+ *  \param info       \IN  info string
+*/
+static void PrintError(char *info)
+{
+	printf("*** can't %s: %s\n", info, M_errstring(UOS_ErrnoGet()));
+}
@@ -0,0 +1,629 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                   LM63_TRCTEST                     ************
+ ************                                                    ************
+ ****************************************************************************/
+/*!
+ *         \file lm63_trctest.c
+ *       \author dieter.pfeuffer@men.de
+ *
+ *        \brief Host test of the LM63 binary trace library.
+ *
+ *               Encodes generated records into a memory stream and
+ *               decodes it again, fed in random chunks:
+ *               - round trip of header and records (all channels and
+ *                 a channel subset, time wrap, long gaps) and size of
+ *                 a 1 Hz three-channel recording (2..5 bytes per record)
+ *               - appended streams
+ *               - damaged data: corrupted payload, sync byte and length
+ *                 of a block, garbage between blocks, damaged header and
+ *                 truncated stream; only the damaged block (or the blocks
+ *                 of the damaged header) may be lost, the decoder must
+ *                 resynchronize at the next block
+ *
+ *     Required: libraries: lm63_trc
+ *     \switches (none)
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*-------------------------------------+
+|   DEFINES                            |
++-------------------------------------*/
+#define REC_NUM		4000		/* records per stream */
+#define BLK_RECS	32			/* records per block */
+#define STREAM_MAX	(256*1024)	/* max. stream size [bytes] */
+#define BLK_MAX		((2*REC_NUM)/BLK_RECS + 8)	/* max. blocks per stream */
+#define CHUNK_MAX	300			/* max. decoder input chunk [bytes] */
+
+/* record generators */
+#define GEN_STRESS	0			/* random times and values, value jumps */
+#define GEN_GAPS	1			/* GEN_STRESS with long time gaps */
+#define GEN_LOG		2			/* 1 Hz recording, slow changes */
+
+#define CHECK(expr)	Check( (expr) ? TRUE : FALSE, #expr, __LINE__ )
+
+/*-------------------------------------+
+|   INCLUDES                           |
++-------------------------------------*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <MEN/men_typs.h>
+#include <MEN/lm63_trc.h>
+
+static const char IdentString[]=MENT_XSTR(MAK_REVISION);
+
+/*-------------------------------------+
+|   TYPEDEFS                           |
++-------------------------------------*/
+/** memory stream */
+typedef struct {
+	u_int32	len;				/* stream length [bytes] */
+	u_int32	writes;				/* write calls */
+	u_int32	blkNum;				/* blocks */
+	u_int32	blkOff[BLK_MAX];	/* offset of each block (sync byte) */
+	u_int8	data[STREAM_MAX];
+} STREAM;
+
+/** decoder result */
+typedef struct {
+	u_int32		hdrs;			/* headers decoded */
+	u_int32		errors;			/* LM63TRC_ERR_FORMAT events */
+	u_int32		decErrors;		/* errors field of decoder */
+	u_int32		left;			/* undecoded bytes at end of stream */
+	u_int32		num;			/* records decoded */
+	LM63TRC_HDR	hdr;			/* last header */
+	LM63TRC_REC	rec[2*REC_NUM];	/* records */
+} RESULT;
+
+/** test */
+typedef struct {
+	const char	*name;
+	void		(*funct)(void);
+} TEST;
+
+/*-------------------------------------+
+|   GLOBALS                            |
++-------------------------------------*/
+static u_int32		G_seed;
+static u_int32		G_fail;				/* failed checks of current test */
+static LM63TRC_REC	G_exp[2][REC_NUM];	/* expected records per stream */
+static STREAM		G_stream, G_stream2, G_work;
+static RESULT		G_res;
+static LM63TRC_ENC	G_enc;
+static LM63TRC_DEC	G_dec;
+
+/*-------------------------------------+
+|   PROTOTYPES                         |
++-------------------------------------*/
+static void Check( int32 ok, const char *expr, int line );
+static u_int32 Rand( u_int32 n );
+static int32 StreamWrite( void *arg, const u_int8 *buf, u_int32 len );
+static void HdrMake( LM63TRC_HDR *hdrP, u_int32 chMask, u_int32 smbAddr );
+static void Encode( STREAM *strP, const LM63TRC_HDR *hdrP, u_int32 gen,
+					LM63TRC_REC *expP );
+static void Decode( const STREAM *strP, u_int32 chunkMax, RESULT *resP );
+static int32 RecCmp( const LM63TRC_REC *recP, const LM63TRC_REC *expP,
+					 u_int32 chMask );
+static int32 ResCmp( const RESULT *resP, u_int32 from, const LM63TRC_REC *expP,
+					 u_int32 num, u_int32 chMask );
+static void TestRoundTrip( void );
+static void TestAppend( void );
+static void TestDamaged( void );
+
+/** tests */
+static const TEST G_test[] = {
+	{ "roundtrip",	TestRoundTrip },
+	{ "append",		TestAppend },
+	{ "damaged",	TestDamaged },
+	{ NULL, NULL }
+};
+
+/********************************* header **********************************/
+/**  Prints the headline
+ */
+static void header(void)
+{
+	printf("\n======================="
+		   "\n===   LM63_TRCTEST  ==="
+		   "\n======================="
+		   "\nCopyright 2026, MEN Mikro Elektronik GmbH\n%s\n\n", IdentString);
+}
+
+/********************************* usage ***********************************/
+/**  Prints the program usage
+ */
+static void usage(void)
+{
+	printf(
+		"\nUsage:     lm63_trctest [<test>...]\n"
+		"\nFunction:  LM63 binary trace library test (encoder/decoder)\n"
+		"\nOptions:\n"
+		"    test       test to run (default: all)\n"
+		"               roundtrip, append, damaged\n"
+		"\nExit code: number of failed tests\n\n");
+}
+
+/********************************* main ************************************/
+/** Program main function
+ *
+ *  \param argc       \IN  argument counter
+ *  \param argv       \IN  argument vector
+ *
+ *  \return	          number of failed tests
+ */
+int main( int argc, char *argv[] )
+{
+	const TEST	*testP;
+	int32		n, run, failed = 0;
+
+	header();
+
+	for( n=1; n<argc; n++ ){
+		if( *argv[n] == '-' ){
+			usage();
+			return(1);
+		}
+	}
+
+	for( testP=G_test; testP->name; testP++ ){
+		/* selected? */
+		run = (argc < 2);
+		for( n=1; n<argc; n++ )
+			if( !strcmp( argv[n], testP->name ) )
+				run = TRUE;
+		if( !run )
+			continue;
+
+		G_fail = 0;
+		G_seed = 1;
+		testP->funct();
+
+		printf("%-12s %s\n", testP->name, G_fail ? "FAIL" : "PASS");
+		if( G_fail )
+			failed++;
+	}
+
+	printf("\n%d test(s) failed\n", (int)failed);
+	return( failed );
+}
+
+/********************************* Check ***********************************/
+/** Count and report a failed check
+ *
+ *  \param ok         \IN  check passed
+ *  \param expr       \IN  checked expression
+ *  \param line       \IN  source line
+ */
+static void Check( int32 ok, const char *expr, int line )
+{
+	if( ok )
+		return;
+
+	printf("  line %d: check failed: %s\n", line, expr);
+	G_fail++;
+}
+
+/********************************* Rand ************************************/
+/** Pseudo random number (reproducible)
+ *
+ *  \param n          \IN  range
+ *
+ *  \return           0..n-1
+ */
+static u_int32 Rand( u_int32 n )
+{
+	G_seed = G_seed * 1103515245 + 12345;
+	return( ((G_seed >> 8) & 0xffffff) % n );
+}
+
+/******************************* StreamWrite *******************************/
+/** Write function of the encoder: append to memory stream
+ *
+ *  LM63TRC_EncFlush() writes each block with three calls (prefix,
+ *  payload, checksum), so the block offsets can be noted for the tests.
+ *
+ *  \param arg        \IN  stream
+ *  \param buf        \IN  data
+ *  \param len        \IN  length [bytes]
+ *
+ *  \return           0 or 1 if stream full
+ */
+static int32 StreamWrite( void *arg, const u_int8 *buf, u_int32 len )
+{
+	STREAM	*strP = (STREAM*)arg;
+
+	if( strP->len + len > STREAM_MAX )
+		return(1);
+
+	/* call 0: header, then prefix/payload/checksum of each block */
+	if( strP->writes && ((strP->writes - 1) % 3 == 0) &&
+		(strP->blkNum < BLK_MAX) )
+		strP->blkOff[strP->blkNum++] = strP->len;
+	strP->writes++;
+
+	memcpy( &strP->data[strP->len], buf, len );
+	strP->len += len;
+	return(0);
+}
+
+/********************************* HdrMake *********************************/
+/** Make stream header
+ *
+ *  \param hdrP       \OUT header
+ *  \param chMask     \IN  recorded channels
+ *  \param smbAddr    \IN  SMB address
+ */
+static void HdrMake( LM63TRC_HDR *hdrP, u_int32 chMask, u_int32 smbAddr )
+{
+	memset( hdrP, 0, sizeof(*hdrP) );
+	hdrP->smbAddr  = smbAddr;
+	hdrP->tempUnit = 1;
+	hdrP->chMask   = chMask;
+	hdrP->startSec = 1791763200;
+	sprintf( hdrP->ident, "LM63 - trace test - addr 0x%02x", (int)smbAddr );
+}
+
+/********************************** Encode *********************************/
+/** Encode REC_NUM generated records into a new stream
+ *
+ *  \param strP       \OUT stream
+ *  \param hdrP       \IN  header
+ *  \param gen        \IN  record generator (GEN_xxx)
+ *  \param expP       \OUT expected records (REC_NUM)
+ */
+static void Encode( STREAM *strP, const LM63TRC_HDR *hdrP, u_int32 gen,
+					LM63TRC_REC *expP )
+{
+	/* start near the wrap of the ms counter */
+	u_int32	time = 0xffffffff - 5000, t0 = time, dt, sec = 0, ms = 0;
+	int32	val[LM63TRC_CH_MAX] = { 35000, 45125, 3000, 0 };
+	u_int32	n, ch;
+
+	memset( strP, 0, sizeof(*strP) );
+	CHECK( LM63TRC_EncInit( &G_enc, hdrP, BLK_RECS, StreamWrite, strP ) == 0 );
+
+	for( n=0; n<REC_NUM; n++ ){
+		if( n ){
+			switch( (gen == GEN_LOG) ? 3 : Rand(20) ){
+			case 0:		dt = 0;						break;
+			case 1:		dt = 1 + Rand(10);			break;
+			case 2:		dt = 1000 + Rand(100000);	break;
+			default:	dt = 1000;					break;
+			}
+			/* beyond the record time difference: new block */
+			if( (gen == GEN_GAPS) && (n % 1000 == 500) )
+				dt = 0x80000000 + Rand(1000);
+			time += dt;
+			sec  += dt / 1000;
+			ms   += dt % 1000;
+			if( ms >= 1000 ){
+				ms -= 1000;
+				sec++;
+			}
+		}
+
+		if( gen == GEN_LOG ){
+			/* temperatures drift slowly, fan speed jitters */
+			if( Rand(30) == 0 )
+				val[0] += (Rand(2) ? 1000 : -1000);
+			if( Rand(4) == 0 )
+				val[1] += (Rand(2) ? 125 : -125);
+			if( Rand(3) == 0 )
+				val[2] = 3000 + (int32)Rand(41) - 20;
+		}
+		/* mostly unchanged or small changes, some jumps */
+		else switch( Rand(4) ){
+		case 0:
+			break;
+		case 1:
+			val[Rand(LM63TRC_CH_MAX)] += (int32)Rand(5) - 2;
+			break;
+		default:
+			for( ch=0; ch<LM63TRC_CH_MAX; ch++ ){
+				if( Rand(50) == 0 )
+					val[ch] = (int32)Rand(2000000) - 1000000;
+				else
+					val[ch] += (int32)Rand(251) - 125;
+			}
+		}
+
+		CHECK( LM63TRC_EncPut( &G_enc, time, val ) == 0 );
+
+		expP[n].sec = sec;
+		expP[n].ms  = ms;
+		for( ch=0; ch<LM63TRC_CH_MAX; ch++ )
+			expP[n].value[ch] = val[ch];
+	}
+	CHECK( LM63TRC_EncFlush( &G_enc ) == 0 );
+
+	/* flush without records writes nothing */
+	n = strP->len;
+	CHECK( LM63TRC_EncFlush( &G_enc ) == 0 && strP->len == n );
+	CHECK( time - t0 >= 5000 );
+}
+
+/********************************** Decode *********************************/
+/** Decode stream fed in random chunks
+ *
+ *  \param strP       \IN  stream
+ *  \param chunkMax   \IN  max. chunk size [bytes]
+ *  \param resP       \OUT result
+ */
+static void Decode( const STREAM *strP, u_int32 chunkMax, RESULT *resP )
+{
+	LM63TRC_REC	rec;
+	u_int32		pos = 0, len, taken;
+	int32		ev;
+
+	memset( resP, 0, sizeof(*resP) );
+	LM63TRC_DecInit( &G_dec );
+
+	do {
+		/* next chunk (0 at the end: decode the rest) */
+		len = strP->len - pos;
+		if( len > chunkMax )
+			len = 1 + Rand( chunkMax );
+		taken = LM63TRC_DecPut( &G_dec, &strP->data[pos], len );
+		pos += taken;
+
+		while( (ev = LM63TRC_DecGet( &G_dec, &rec )) != LM63TRC_EV_NONE ){
+			switch( ev ){
+			case LM63TRC_EV_HDR:
+				resP->hdr = G_dec.hdr;
+				resP->hdrs++;
+				break;
+			case LM63TRC_EV_REC:
+				if( resP->num < 2*REC_NUM )
+					resP->rec[resP->num++] = rec;
+				break;
+			case LM63TRC_ERR_FORMAT:
+				resP->errors++;
+				break;
+			default:
+				CHECK( FALSE );
+			}
+		}
+	} while( taken );
+
+	resP->decErrors = G_dec.errors;
+	resP->left = G_dec.wr - G_dec.rd;
+}
+
+/********************************** RecCmp *********************************/
+/** Compare record with expected record
+ *
+ *  \param recP       \IN  decoded record
+ *  \param expP       \IN  expected record
+ *  \param chMask     \IN  recorded channels
+ *
+ *  \return           TRUE if equal
+ */
+static int32 RecCmp( const LM63TRC_REC *recP, const LM63TRC_REC *expP,
+					 u_int32 chMask )
+{
+	u_int32	ch;
+
+	if( (recP->sec != expP->sec) || (recP->ms != expP->ms) )
+		return( FALSE );
+
+	for( ch=0; ch<LM63TRC_CH_MAX; ch++ ){
+		if( (chMask & (1 << ch)) ? (recP->value[ch] != expP->value[ch]) :
+			(recP->value[ch] != 0) )
+			return( FALSE );
+	}
+	return( TRUE );
+}
+
+/********************************** ResCmp *********************************/
+/** Compare decoded records with expected records
+ *
+ *  \param resP       \IN  decoder result
+ *  \param from       \IN  first decoded record to compare
+ *  \param expP       \IN  expected records
+ *  \param num        \IN  number of expected records
+ *  \param chMask     \IN  recorded channels
+ *
+ *  \return           TRUE if equal
+ */
+static int32 ResCmp( const RESULT *resP, u_int32 from, const LM63TRC_REC *expP,
+					 u_int32 num, u_int32 chMask )
+{
+	u_int32	n;
+
+	if( from + num > resP->num ){
+		printf("  %d records decoded, %d expected\n", (int)resP->num,
+			   (int)(from + num));
+		return( FALSE );
+	}
+
+	for( n=0; n<num; n++ ){
+		if( !RecCmp( &resP->rec[from+n], &expP[n], chMask ) ){
+			printf("  record %d: %u.%03u differs from %u.%03u\n", (int)n,
+				   (unsigned)resP->rec[from+n].sec,
+				   (unsigned)resP->rec[from+n].ms,
+				   (unsigned)expP[n].sec, (unsigned)expP[n].ms);
+			return( FALSE );
+		}
+	}
+	return( TRUE );
+}
+
+/****************************** TestRoundTrip ******************************/
+/** Round trip of header and records
+ */
+static void TestRoundTrip( void )
+{
+	static const u_int32 chMask[] = { 0xf, 0x7, 0x5, 0x8 };
+	static const u_int32 chunk[] = { 1, 7, CHUNK_MAX, STREAM_MAX };
+	LM63TRC_HDR	hdr;
+	u_int32		m, c;
+
+	for( m=0; m<sizeof(chMask)/sizeof(chMask[0]); m++ ){
+		HdrMake( &hdr, chMask[m], 0x98 );
+		Encode( &G_stream, &hdr, GEN_GAPS, G_exp[0] );
+
+		for( c=0; c<sizeof(chunk)/sizeof(chunk[0]); c++ ){
+			Decode( &G_stream, chunk[c], &G_res );
+			CHECK( G_res.hdrs == 1 );
+			CHECK( G_res.errors == 0 && G_res.decErrors == 0 );
+			CHECK( G_res.left == 0 );
+			CHECK( G_res.num == REC_NUM );
+			CHECK( ResCmp( &G_res, 0, G_exp[0], REC_NUM, chMask[m] ) );
+			CHECK( G_res.hdr.smbAddr == hdr.smbAddr );
+			CHECK( G_res.hdr.tempUnit == hdr.tempUnit );
+			CHECK( G_res.hdr.chMask == hdr.chMask );
+			CHECK( G_res.hdr.startSec == hdr.startSec );
+			CHECK( !strcmp( G_res.hdr.ident, hdr.ident ) );
+		}
+	}
+
+	/* 1 Hz recording of three channels: 2..5 bytes per record */
+	HdrMake( &hdr, 0x7, 0x98 );
+	Encode( &G_stream, &hdr, GEN_LOG, G_exp[0] );
+	printf("  1 Hz recording: %d records, %d bytes (%.2f bytes/record)\n",
+		   REC_NUM, (int)G_stream.len, (double)G_stream.len / REC_NUM);
+	CHECK( G_stream.len >= 2 * REC_NUM && G_stream.len <= 5 * REC_NUM );
+	Decode( &G_stream, CHUNK_MAX, &G_res );
+	CHECK( G_res.errors == 0 && G_res.num == REC_NUM );
+	CHECK( ResCmp( &G_res, 0, G_exp[0], REC_NUM, hdr.chMask ) );
+
+	/* illegal channel masks */
+	hdr.chMask = 0;
+	CHECK( LM63TRC_EncInit( &G_enc, &hdr, BLK_RECS, StreamWrite, &G_work ) ==
+		   LM63TRC_ERR_PARAM );
+	hdr.chMask = 1 << LM63TRC_CH_MAX;
+	CHECK( LM63TRC_EncInit( &G_enc, &hdr, BLK_RECS, StreamWrite, &G_work ) ==
+		   LM63TRC_ERR_PARAM );
+}
+
+/******************************** TestAppend *******************************/
+/** Appended streams decode with their own header and time base
+ */
+static void TestAppend( void )
+{
+	LM63TRC_HDR	hdr, hdr2;
+
+	HdrMake( &hdr, 0x7, 0x98 );
+	Encode( &G_stream, &hdr, GEN_STRESS, G_exp[0] );
+	HdrMake( &hdr2, 0x3, 0x9a );
+	Encode( &G_stream2, &hdr2, GEN_GAPS, G_exp[1] );
+
+	CHECK( G_stream.len + G_stream2.len <= STREAM_MAX );
+	G_work = G_stream;
+	memcpy( &G_work.data[G_work.len], G_stream2.data, G_stream2.len );
+	G_work.len += G_stream2.len;
+
+	Decode( &G_work, CHUNK_MAX, &G_res );
+	CHECK( G_res.hdrs == 2 );
+	CHECK( G_res.errors == 0 && G_res.left == 0 );
+	CHECK( G_res.num == 2*REC_NUM );
+	CHECK( ResCmp( &G_res, 0, G_exp[0], REC_NUM, hdr.chMask ) );
+	CHECK( ResCmp( &G_res, REC_NUM, G_exp[1], REC_NUM, hdr2.chMask ) );
+	CHECK( G_res.hdr.smbAddr == hdr2.smbAddr && G_res.hdr.chMask == 0x3 );
+}
+
+/******************************** TestDamaged ******************************/
+/** Damaged data costs the damaged block only
+ */
+static void TestDamaged( void )
+{
+	static const u_int8 garbage[] = {
+		LM63TRC_SYNC, 0x05, 'L', '6', 0x00, LM63TRC_SYNC, 0xff, 0xff, 'L'
+	};
+	LM63TRC_HDR	hdr, hdr2;
+	u_int32		k, off, blk, from, num, pos;
+
+	/* without long gaps, block k holds records k*BLK_RECS.. */
+	HdrMake( &hdr, 0xf, 0x98 );
+	Encode( &G_stream, &hdr, GEN_STRESS, G_exp[0] );
+	CHECK( G_stream.blkNum == REC_NUM / BLK_RECS );
+
+	for( k=0; k<4; k++ ){
+		/* damage a block in the middle */
+		blk  = G_stream.blkNum / 2 + k;
+		off  = G_stream.blkOff[blk];
+		from = blk * BLK_RECS;
+		G_work = G_stream;
+
+		switch( k ){
+		case 0:		/* payload byte */
+			G_work.data[(off + G_stream.blkOff[blk+1]) / 2] ^= 0x10;
+			break;
+		case 1:		/* sync byte */
+			G_work.data[off] = 0x00;
+			break;
+		case 2:		/* length: longer than the block */
+			G_work.data[off+1] = (u_int8)(G_work.data[off+1] + 3);
+			break;
+		case 3:		/* checksum */
+			G_work.data[G_stream.blkOff[blk+1] - 1] ^= 0x01;
+			break;
+		}
+
+		Decode( &G_work, CHUNK_MAX, &G_res );
+		if( G_res.errors == 0 || G_res.decErrors == 0 ||
+			G_res.num != REC_NUM - BLK_RECS ||
+			!ResCmp( &G_res, 0, G_exp[0], from, hdr.chMask ) ||
+			!ResCmp( &G_res, from, &G_exp[0][from + BLK_RECS],
+					 REC_NUM - from - BLK_RECS, hdr.chMask ) ){
+			printf("  damage %d: %d records, %d errors\n", (int)k,
+				   (int)G_res.num, (int)G_res.errors);
+			G_fail++;
+		}
+		CHECK( G_res.left == 0 );
+	}
+
+	/* garbage between blocks: no record lost */
+	blk = 10;
+	pos = G_stream.blkOff[blk];
+	G_work = G_stream;
+	memcpy( &G_work.data[pos], garbage, sizeof(garbage) );
+	memcpy( &G_work.data[pos + sizeof(garbage)], &G_stream.data[pos],
+			G_stream.len - pos );
+	G_work.len += sizeof(garbage);
+	Decode( &G_work, CHUNK_MAX, &G_res );
+	CHECK( G_res.errors > 0 );
+	CHECK( G_res.num == REC_NUM );
+	CHECK( ResCmp( &G_res, 0, G_exp[0], REC_NUM, hdr.chMask ) );
+
+	/* truncated in the last block: complete blocks decoded */
+	G_work = G_stream;
+	G_work.len = G_stream.blkOff[G_stream.blkNum-1] + 5;
+	Decode( &G_work, CHUNK_MAX, &G_res );
+	CHECK( G_res.errors == 0 );
+	CHECK( G_res.left == 5 );
+	num = (G_stream.blkNum - 1) * BLK_RECS;
+	CHECK( G_res.num == num );
+	CHECK( ResCmp( &G_res, 0, G_exp[0], num, hdr.chMask ) );
+
+	/* damaged header: its blocks are skipped up to the next header */
+	HdrMake( &hdr2, 0x5, 0x9a );
+	Encode( &G_stream2, &hdr2, GEN_STRESS, G_exp[1] );
+	G_work = G_stream;
+	G_work.data[1] = 'X';
+	memcpy( &G_work.data[G_work.len], G_stream2.data, G_stream2.len );
+	G_work.len += G_stream2.len;
+	Decode( &G_work, CHUNK_MAX, &G_res );
+	CHECK( G_res.hdrs == 1 );
+	CHECK( G_res.errors > 0 );
+	CHECK( G_res.num == REC_NUM );
+	CHECK( ResCmp( &G_res, 0, G_exp[1], REC_NUM, hdr2.chMask ) );
+	CHECK( G_res.hdr.smbAddr == hdr2.smbAddr );
+}
@@ -82,6 +82,25 @@
 #define LM63_STEPPING_DIE_REV	0xFF	/**< Stepping/Die Rev. ID */
 /**@}*/
 
+/*! \defgroup lm63_cfg_bits LM63 configuration register bits
+
+  LM63 configuration register (0x03) bit definitions
+*/
+/**@{*/
+#define LM63_CFG_ALERT_MASK		0x80 /**< ALERT output masked */
+#define LM63_CFG_STANDBY		0x40 /**< standby (one-shot conversions only) */
+/**@}*/
+
+/*! \defgroup lm63_alst_bits LM63 ALERT status register bits
+
+  LM63 ALERT status (0x02) register bit definitions
+  (the ALERT cause bits of the status and mask register are LM63_ALERT_xxx,
+  see lm63_drv.h)
+*/
+/**@{*/
+#define LM63_ALST_BUSY			0x80 /**< conversion in progress (status only) */
+/**@}*/
+
 
 /*! \defgroup xxxdefgroup header defines
 
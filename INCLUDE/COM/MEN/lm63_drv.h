@@ -40,21 +40,227 @@
 /*-----------------------------------------+
 |  TYPEDEFS                                |
 +-----------------------------------------*/
+/** sample of the periodic sampler (LM63_BLK_FIFO) */
+typedef struct {
+	u_int32	time;		/**< time the sample was taken since driver init [ms] */
+	int32	ch;			/**< channel (LM63_CH_xxx) */
+	int32	value;		/**< channel value */
+} LM63_SAMPLE;
+
+/** number of lookup table entries */
+#define LM63_LUT_NUM	8
+
+/** fan lookup table (LM63_BLK_LUT) */
+typedef struct {
+	int32	hys;		/**< hysteresis (0..31) [degrees Celsius] */
+	struct {
+		int32	temp;	/**< temperature (0..127) [degrees Celsius], ascending */
+		int32	pwm;	/**< PWM duty cycle (0..100) [%] */
+	} entry[LM63_LUT_NUM];	/**< lookup table entries */
+} LM63_LUT;
+
+/** sensor values of the aggregator (LM63_BLK_SENSORS) */
+typedef struct {
+	int32	error;		/**< 0 or error code of sensor access (values are 0) */
+	int32	temp;		/**< LM63 die temperature (see LM63_TEMP_UNIT) */
+	int32	rmtTemp;	/**< remote temperature (see LM63_TEMP_UNIT) */
+	int32	fanSpeed;	/**< fan speed [rpm] */
+} LM63_SENSOR_VAL;
+
+/** number of latency histogram buckets */
+#define LM63_PERF_BUCKETS	24
+
+/** number of channels with latency histogram */
+#define LM63_PERF_CH		4
+
+/** latency histogram
+ *
+ *  bucket[0] counts calls below 1us, bucket[n] calls of 2^(n-1)..2^n-1 us,
+ *  the last bucket all longer calls.
+ */
+typedef struct {
+	u_int32	count;		/**< number of calls */
+	u_int32	sumUs;		/**< total time [us] (wraps) */
+	u_int32	maxUs;		/**< longest call [us] */
+	u_int32	bucket[LM63_PERF_BUCKETS];	/**< calls per latency range */
+} LM63_HIST;
+
+/** performance counters (LM63_BLK_PERF)
+ *
+ *  The transaction and device read counters are exact, the histograms may
+ *  rarely lose a count of concurrent calls.
+ */
+typedef struct LM63_PERF {
+	u_int32		xfers;		/**< SMBus transactions */
+	u_int32		xferBytes;	/**< SMBus data bytes transferred */
+	u_int32		xferErrors;	/**< failed SMBus transactions */
+	u_int32		xferRetries;	/**< retried SMBus transactions (SMB_RETRY) */
+	u_int32		xferDeadline;	/**< retries refused by deadline (SMB_DEADLINE) */
+	u_int32		readValue;	/**< device reads of M_read() */
+	u_int32		readValueUs;	/**< time of device reads of M_read() [us] */
+	LM63_HIST	ch[LM63_PERF_CH];	/**< M_read() per channel */
+	LM63_HIST	read;		/**< M_read() */
+	LM63_HIST	blockRead;	/**< M_getblock() */
+	LM63_HIST	getStat;	/**< M_getstat() */
+} LM63_PERF;
+
+/** number of channels with statistics (input channels) */
+#define LM63_STATS_CH		3
+
+/** statistics of an input channel
+ *
+ *  min, max and mean are undefined (0) if count is 0.
+ */
+typedef struct {
+	u_int32	count;		/**< device reads since reset */
+	int32	min;		/**< min. value */
+	int32	max;		/**< max. value */
+	int32	mean;		/**< mean value (rounded down) */
+	int32	ewma;		/**< exponentially weighted moving average
+							 (see LM63_EWMA_TAU, not reset) */
+	int32	last;		/**< latest value (not reset) */
+} LM63_CH_STATS;
+
+/** channel statistics (LM63_BLK_STATS, LM63_BLK_STATS_RST) */
+typedef struct {
+	u_int32			intervalMs;	/**< time since reset [ms] */
+	LM63_CH_STATS	ch[LM63_STATS_CH];	/**< statistics per channel */
+} LM63_STATS;
 
 /*-----------------------------------------+
 |  DEFINES                                 |
 +-----------------------------------------*/
 /** \name LM63 specific Getstat/Setstat codes
  *  \anchor getstat_setstat_codes
- *  Note: not yet used</td>
  */
 /**@{*/
-#define LM63_XXX		M_DEV_OF+0x00   /**< G,S: description\n
-											      Values: \n
-												  Default: \n*/
+#define LM63_CACHE_BYPASS	M_DEV_OF+0x00   /**< G,S: bypass register shadow\n
+											      Values: 0=use shadow, 1=always read device\n
+												  Default: 0\n*/
+#define LM63_SMB_WORDREAD	M_DEV_OF+0x01   /**< G: SMBus word read used for tach count\n
+											      Values: 0=byte reads, 1=word read\n
+												  Default: see descriptor key SMB_WORD_READ\n*/
+#define LM63_SMPL_PERIOD	M_DEV_OF+0x02   /**< G,S: sample period of current channel [ms]\n
+											      Values: 0=not sampled, 1..n\n
+												  Default: see descriptor key SMPL_PERIOD_n\n*/
+#define LM63_SMPL_START		M_DEV_OF+0x03   /**< G,S: start/stop periodic sampler\n
+											      Values: 0=stop, 1=start\n
+												  Default: 0\n*/
+#define LM63_FIFO_COUNT		M_DEV_OF+0x04   /**< G: number of samples in FIFO\n
+												  S: discard all samples\n*/
+#define LM63_FIFO_OVERFLOW	M_DEV_OF+0x05   /**< G: samples lost due to full FIFO\n
+												  S: reset counter\n*/
+#define LM63_FIFO_HWM		M_DEV_OF+0x06   /**< G,S: FIFO high-watermark\n
+											      Values: 0=off, 1..512 [samples]\n
+												  Default: 0\n*/
+#define LM63_FIFO_SIG_SET	M_DEV_OF+0x07   /**< G: signal installed\n
+												  S: install signal sent when FIFO high-watermark is reached\n
+											      Values: signal code\n*/
+#define LM63_FIFO_SIG_CLR	M_DEV_OF+0x08   /**< S: deinstall FIFO high-watermark signal\n*/
+#define LM63_ALERT_ENABLE	M_DEV_OF+0x09   /**< G,S: enable ALERT handling\n
+											      Values: 0=disable, 1=enable\n
+												  Default: see descriptor key ALERT_ENABLE\n*/
+#define LM63_ALERT_MASKED	M_DEV_OF+0x0a   /**< G,S: masked ALERT causes (LM63_ALERT_xxx)\n
+											      Values: 0x00..0x5f\n
+												  Default: see descriptor key ALERT_MASK\n*/
+#define LM63_ALERT_LATCH	M_DEV_OF+0x0b   /**< G: latched ALERT causes (LM63_ALERT_xxx)\n
+												  S: clear latched causes (value: causes to clear)\n*/
+#define LM63_ALERT_SIG_SET	M_DEV_OF+0x0c   /**< G: signal installed\n
+												  S: install signal sent on ALERT\n
+											      Values: signal code\n*/
+#define LM63_ALERT_SIG_CLR	M_DEV_OF+0x0d   /**< S: deinstall ALERT signal\n*/
+#define LM63_ALERT_STATUS	M_DEV_OF+0x0e   /**< G: current ALERT status (LM63_ALERT_xxx)\n*/
+#define LM63_LIM_TEMP_HIGH	M_DEV_OF+0x0f   /**< G,S: local high setpoint\n
+											      Values: -128..127 [degrees Celsius] (step: 1),\n
+											      see LM63_TEMP_UNIT\n
+												  Default: see descriptor key LIM_TEMP_HIGH\n*/
+#define LM63_LIM_RMT_HIGH	M_DEV_OF+0x10   /**< G,S: remote high setpoint\n
+											      Values: -128..127.875 [degrees Celsius] (step: 0.125),\n
+											      see LM63_TEMP_UNIT\n
+												  Default: see descriptor key LIM_RMT_HIGH\n*/
+#define LM63_LIM_RMT_LOW	M_DEV_OF+0x11   /**< G,S: remote low setpoint\n
+											      Values: -128..127.875 [degrees Celsius] (step: 0.125),\n
+											      see LM63_TEMP_UNIT\n
+												  Default: see descriptor key LIM_RMT_LOW\n*/
+#define LM63_LIM_RMT_TCRIT	M_DEV_OF+0x12   /**< G,S: remote TCRIT setpoint\n
+											      Values: -128..127 [degrees Celsius] (step: 1),\n
+											      see LM63_TEMP_UNIT\n
+												  Default: see descriptor key LIM_RMT_TCRIT\n*/
+#define LM63_LIM_RMT_TCRIT_HYS M_DEV_OF+0x13 /**< G,S: remote TCRIT hysteresis\n
+											      Values: 0..255 [degrees Celsius] (step: 1),\n
+											      see LM63_TEMP_UNIT\n
+												  Default: see descriptor key LIM_RMT_TCRIT_HYS\n*/
+#define LM63_LIM_FANSPEED	M_DEV_OF+0x14   /**< G,S: min. fan speed\n
+											      Values: 0=off, 1..10800000/TACH_PULSE [rpm]\n
+												  Default: see descriptor key LIM_FANSPEED\n*/
+#define LM63_PWM_MANUAL		M_DEV_OF+0x15   /**< G,S: PWM output control\n
+											      Values: 0=lookup table, 1=PWM channel\n
+												  Default: 0\n*/
+#define LM63_CONV_MODE		M_DEV_OF+0x16   /**< G,S: conversion mode\n
+											      Values: 0=continuous, 1=one-shot on read\n
+												  Default: see descriptor key CONV_MODE\n*/
+#define LM63_TEMP_UNIT		M_DEV_OF+0x17   /**< G,S: unit of temperature channels\n
+												  and LM63_LIM_xxx temperature limits\n
+											      Values: see \ref temp_units\n
+												  Default: see descriptor key TEMP_UNIT\n*/
+#define LM63_SENSOR_NUM		M_DEV_OF+0x18   /**< G: number of sensors (see LM63_BLK_SENSORS)\n*/
+#define LM63_COALESCE_WIN	M_DEV_OF+0x19   /**< G,S: window for reuse of device reads\n
+											      Values: 0..n [ms]\n
+												  Default: see descriptor key COALESCE_WINDOW\n*/
+#define LM63_COALESCED		M_DEV_OF+0x1a   /**< G,S: number of device reads saved by the shadow\n
+											      (approximate, concurrent calls may lose a count)\n
+											      Values: G: 0..n, S: new counter value (e.g. 0)\n*/
+#define LM63_INIT_SAVED		M_DEV_OF+0x1b   /**< G: SMBus transactions saved by INIT_VERIFY/WARM_ATTACH\n
+											      (skipped writes minus verify reads)\n*/
+#define LM63_INIT_TIME		M_DEV_OF+0x1c   /**< G: duration of hardware init [ms]\n*/
+#define LM63_WARM			M_DEV_OF+0x1d   /**< G: attached to device configured by previous session\n
+											      Values: 0=no, 1=yes (see descriptor key WARM_ATTACH)\n*/
+#define LM63_XFER_COUNT		M_DEV_OF+0x1e   /**< G,S: number of SMBus transactions\n
+											      Values: G: 0..n, S: new counter value (e.g. 0)\n*/
+#define LM63_PERF_RESET		M_DEV_OF+0x1f   /**< S: reset performance counters (LM63_BLK_PERF)\n*/
+#define LM63_EWMA_TAU		M_DEV_OF+0x20   /**< G,S: time constant of channel statistics EWMA\n
+											      Values: 1..30000 [ms]\n
+												  Default: see descriptor key EWMA_TAU\n*/
+#define LM63_SMB_DEVADDR	M_DEV_OF+0x21   /**< G: SMB address of the device (see descriptor key SMB_DEVADDR)\n*/
+#define LM63_SMB_BUSNBR		M_DEV_OF+0x22   /**< G: SMBus bus number of the device (see descriptor key SMB_BUSNBR)\n*/
+#define LM63_CONV_PERIOD	M_DEV_OF+0x23   /**< G: conversion period [ms]\n*/
+#define LM63_DEADBAND		M_DEV_OF+0x24   /**< G,S: deadband of current channel for the sample FIFO\n
+											      Values: 0=off (all samples), 1..n: min. change to report\n
+												  Default: see descriptor key DEADBAND_n\n*/
+#define LM63_SILENCE_MAX	M_DEV_OF+0x25   /**< G,S: max. time without sample of current channel in the FIFO (deadband on)\n
+											      Values: 0=unlimited, 1..n [ms]\n
+												  Default: see descriptor key SILENCE_MAX_n\n*/
+#define LM63_DEADBAND_CNT	M_DEV_OF+0x26   /**< G,S: number of samples suppressed by the deadband\n
+											      Values: G: 0..n, S: new counter value (e.g. 0)\n*/
+#define LM63_FIFO_WAIT		M_DEV_OF+0x27   /**< G,S: max. wait time of LM63_BLK_FIFO for the block size\n
+											      or LM63_FIFO_HWM samples (samples taken meanwhile)\n
+											      Values: 0=no wait, 1..n [ms], -1=forever\n
+												  Default: 0\n*/
+#define LM63_SMPL_MISSED	M_DEV_OF+0x28   /**< G,S: number of sample periods missed (previous sample not yet taken)\n
+											      Values: G: 0..n, S: new counter value (e.g. 0)\n*/
 
 /* LM63 specific Getstat/Setstat block codes */
-#define LM63_BLK_XXX	M_DEV_BLK_OF+0x00   /**< G: description*/
+#define LM63_BLK_FIFO		M_DEV_BLK_OF+0x00   /**< G: get samples from FIFO (LM63_SAMPLE[])\n*/
+#define LM63_BLK_LUT		M_DEV_BLK_OF+0x01   /**< G,S: fan lookup table (LM63_LUT)\n*/
+#define LM63_BLK_SENSORS	M_DEV_BLK_OF+0x02   /**< G: read all sensors (LM63_SENSOR_VAL[])\n*/
+#define LM63_BLK_PERF		M_DEV_BLK_OF+0x03   /**< G: performance counters (LM63_PERF)\n*/
+#define LM63_BLK_STATS		M_DEV_BLK_OF+0x04   /**< G: channel statistics (LM63_STATS)\n*/
+#define LM63_BLK_STATS_RST	M_DEV_BLK_OF+0x05   /**< G: channel statistics (LM63_STATS),
+												     reset in the same step\n*/
+/**@}*/
+
+
+/** \name LM63 ALERT causes
+ *  \anchor alert_causes
+ */
+/**@{*/
+#define LM63_ALERT_LHIGH	0x40	/**< local high setpoint exceeded */
+#define LM63_ALERT_RHIGH	0x10	/**< remote high setpoint exceeded */
+#define LM63_ALERT_RLOW		0x08	/**< remote low setpoint exceeded */
+#define LM63_ALERT_RDFA		0x04	/**< remote diode open */
+#define LM63_ALERT_RCRIT	0x02	/**< remote TCRIT setpoint exceeded */
+#define LM63_ALERT_TACH		0x01	/**< fan speed below limit (tach count above limit) */
+#define LM63_ALERT_ALL		0x5f	/**< all causes */
 /**@}*/
 
 
@@ -65,6 +271,15 @@
 #define LM63_CH_TEMP		0	/**< LM63 die temperature (-55..125) [degrees Celsius] */
 #define LM63_CH_RMTTEMP		1	/**< remote temperature (-55..125) [degrees Celsius] */
 #define LM63_CH_FANSPEED	2	/**< fan speed [rpm] */
+#define LM63_CH_PWM			3	/**< PWM duty cycle (0..100) [%] */
+/**@}*/
+
+/** \name LM63 temperature units (LM63_TEMP_UNIT)
+ *  \anchor temp_units
+ */
+/**@{*/
+#define LM63_UNIT_DEG		0	/**< degrees Celsius */
+#define LM63_UNIT_MILLIDEG	1	/**< milli-degrees Celsius */
 /**@}*/
 
 
@@ -0,0 +1,108 @@
+/***********************  I n c l u d e  -  F i l e  ***********************/
+/*!
+ *        \file  lm63_log.h
+ *
+ *      \author  dieter.pfeuffer@men.de
+ *
+ *       \brief  Layout of the lm63_log ring file
+ *
+ *               The ring file has a fixed size: a header page followed by
+ *               recNum record slots. The logger maps the file into memory
+ *               and overwrites the oldest record when the ring is full.
+ *               Other processes map the same file read-only to read the
+ *               records while the logger is running.
+ *
+ *               Writer (record number n):
+ *  \code
+ *  rec = slot[n % recNum]
+ *  rec->nbr = LM63LOG_NBR_INVALID     (barrier)
+ *  write rec->sec, ms, error, value   (barrier)
+ *  rec->nbr = n                       (barrier)
+ *  hdr->head = n + 1
+ *  \endcode
+ *
+ *               Reader (all records currently in the ring):
+ *  \code
+ *  h = hdr->head
+ *  for n = (h > recNum ? h - recNum : 0) .. h-1:
+ *      rec = slot[n % recNum]
+ *      read rec->nbr, copy record, read rec->nbr again
+ *      record valid if both equal n (otherwise overwritten meanwhile)
+ *  \endcode
+ *
+ *               recNum is a power of two, so n % recNum stays continuous
+ *               when the record number wraps. The writer skips record
+ *               number LM63LOG_NBR_INVALID when it wraps, the reader
+ *               ignores it.
+ *
+ *    \switches  (none)
+ */
+ /*
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _LM63_LOG_H
+#define _LM63_LOG_H
+
+#ifdef __cplusplus
+      extern "C" {
+#endif
+
+/*-----------------------------------------+
+|  DEFINES                                 |
++-----------------------------------------*/
+#define LM63LOG_MAGIC		"LM63LOG"	/**< file magic (incl. '\0') */
+#define LM63LOG_VERSION		1			/**< layout version */
+#define LM63LOG_HDR_SIZE	4096		/**< header area (offset of slot 0) */
+#define LM63LOG_CH_MAX		4			/**< max. channels per record */
+#define LM63LOG_IDENT_MAX	256			/**< max. ident string length (incl. '\0') */
+#define LM63LOG_NBR_INVALID	0xffffffff	/**< record being written */
+
+/*-----------------------------------------+
+|  TYPEDEFS                                |
++-----------------------------------------*/
+/** ring file header (at offset 0) */
+typedef struct {
+	char		magic[8];		/**< LM63LOG_MAGIC */
+	u_int32		version;		/**< LM63LOG_VERSION */
+	u_int32		hdrSize;		/**< offset of slot 0 [bytes] */
+	u_int32		recSize;		/**< size of a slot [bytes] */
+	u_int32		recNum;			/**< number of slots (power of two) */
+	u_int32		chNum;			/**< channels per record */
+	u_int32		period;			/**< sample period [ms] */
+	u_int32		smbAddr;		/**< SMB address of the device */
+	u_int32		tempUnit;		/**< LM63_TEMP_UNIT of temperature values */
+	u_int32		pid;			/**< process ID of logger (0=not running) */
+	volatile u_int32 head;		/**< records written (free running) */
+	char		ident[LM63LOG_IDENT_MAX];	/**< driver ident string */
+} LM63LOG_HDR;
+
+/** record slot */
+typedef struct {
+	volatile u_int32 nbr;		/**< record number or LM63LOG_NBR_INVALID */
+	u_int32		sec;			/**< sample time [s since 1970] */
+	u_int32		ms;				/**< sample time, fraction [ms] */
+	int32		error;			/**< 0 or MDIS error code of M_getblock() */
+	int32		value[LM63LOG_CH_MAX];	/**< values (index: channel) */
+} LM63LOG_REC;
+
+#ifdef __cplusplus
+      }
+#endif
+
+#endif /* _LM63_LOG_H */
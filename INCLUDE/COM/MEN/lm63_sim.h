@@ -0,0 +1,123 @@
+/***********************  I n c l u d e  -  F i l e  ***********************/
+/*!
+ *        \file  lm63_sim.h
+ *
+ *      \author  dieter.pfeuffer@men.de
+ *
+ *       \brief  Header file for the LM63 SMBus simulator library
+ *
+ *               The library provides a simulated SMB_HANDLE with a
+ *               register-level LM63 model for host builds of the LM63
+ *               driver (testing and benchmarking without hardware).
+ *
+ *    \switches  LM63SIM_OSS - provide OSS_GetSmbHdl() for host builds
+ */
+ /*
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _LM63_SIM_H
+#define _LM63_SIM_H
+
+#ifdef __cplusplus
+      extern "C" {
+#endif
+
+/*-----------------------------------------+
+|  TYPEDEFS                                |
++-----------------------------------------*/
+/** simulated SMBus (opaque) */
+typedef struct LM63SIM_BUS LM63SIM_BUS;
+
+/** simulated LM63 device (opaque) */
+typedef struct LM63SIM_DEV LM63SIM_DEV;
+
+/** waveform point (values between points are interpolated linearly) */
+typedef struct {
+	u_int32	time;			/**< time since waveform start [ms] */
+	int32	value;			/**< temperature [milli-degrees Celsius] or
+								 fan speed [rpm] */
+} LM63SIM_POINT;
+
+/** bus statistics */
+typedef struct {
+	u_int32	readByte;		/**< ReadByteData transactions */
+	u_int32	readWord;		/**< ReadWordData transactions */
+	u_int32	writeByte;		/**< WriteByteData transactions */
+	u_int32	nack;			/**< transactions to absent devices */
+	u_int32	injected;		/**< transactions failed by error injection */
+	u_int32	lockedWrites;	/**< ignored writes to read-only/locked registers */
+	u_int32	conversions;	/**< temperature/tach conversions (all devices) */
+	u_int32	alerts;			/**< ALERT callbacks */
+	u_int32	busUs;			/**< simulated bus time [us] */
+} LM63SIM_STATS;
+
+/*-----------------------------------------+
+|  DEFINES                                 |
++-----------------------------------------*/
+/** \name LM63SIM_BusCreate() flags */
+/**@{*/
+#define LM63SIM_REALTIME	0x01	/**< clock runs with host time and the
+									     latency is spent by busy waiting
+									     (default: virtual clock advanced by
+									     the latency of each transaction) */
+/**@}*/
+
+/** \name waveforms */
+/**@{*/
+#define LM63SIM_WAVE_TEMP		0	/**< local temperature [milli-degrees Celsius] */
+#define LM63SIM_WAVE_RMTTEMP	1	/**< remote temperature [milli-degrees Celsius] */
+#define LM63SIM_WAVE_FANSPEED	2	/**< fan speed [rpm] */
+#define LM63SIM_WAVE_NUM		3	/**< number of waveforms */
+/**@}*/
+
+#define LM63SIM_POINT_MAX		256	/**< max. points per waveform */
+#define LM63SIM_BUS_MAX			8	/**< max. registered buses */
+#define LM63SIM_CONV_MS			10	/**< duration of a conversion [ms] */
+
+/*-----------------------------------------+
+|  PROTOTYPES                              |
++-----------------------------------------*/
+extern int32 LM63SIM_BusCreate( u_int32 busNbr, u_int32 flags,
+								LM63SIM_BUS **busP );
+extern void LM63SIM_BusDestroy( LM63SIM_BUS **busP );
+extern SMB_HANDLE* LM63SIM_SmbHdl( LM63SIM_BUS *bus );
+extern int32 LM63SIM_GetSmbHdl( u_int32 busNbr, void **smbHdlP );
+extern void LM63SIM_Latency( LM63SIM_BUS *bus, u_int32 byteUs,
+							 u_int32 wordUs );
+extern void LM63SIM_Advance( LM63SIM_BUS *bus, u_int32 ms );
+extern u_int32 LM63SIM_TimeGet( LM63SIM_BUS *bus );
+extern void LM63SIM_StatsGet( LM63SIM_BUS *bus, LM63SIM_STATS *statsP,
+							  u_int32 clear );
+extern void LM63SIM_ErrInject( LM63SIM_BUS *bus, u_int32 errEvery,
+							   u_int32 errBurst, int32 errCode );
+
+extern int32 LM63SIM_DevAdd( LM63SIM_BUS *bus, u_int16 smbAddr,
+							 u_int32 tachPuls, LM63SIM_DEV **devP );
+extern void LM63SIM_DevReset( LM63SIM_DEV *dev );
+extern int32 LM63SIM_WaveSet( LM63SIM_DEV *dev, u_int32 wave,
+							  const LM63SIM_POINT *pointP, u_int32 num,
+							  u_int32 loop );
+extern u_int8 LM63SIM_RegGet( LM63SIM_DEV *dev, u_int8 reg );
+extern void LM63SIM_RegSet( LM63SIM_DEV *dev, u_int8 reg, u_int8 val );
+
+#ifdef __cplusplus
+      }
+#endif
+
+#endif /* _LM63_SIM_H */
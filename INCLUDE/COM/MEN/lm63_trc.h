@@ -0,0 +1,181 @@
+/***********************  I n c l u d e  -  F i l e  ***********************/
+/*!
+ *        \file  lm63_trc.h
+ *
+ *      \author  dieter.pfeuffer@men.de
+ *
+ *       \brief  Header file for the LM63 binary trace library
+ *
+ *               Compact binary format for long-term recording of LM63
+ *               channel values: encoder and streaming decoder.
+ *
+ *               Stream format (all numbers are unsigned LEB128 varints
+ *               unless noted, signed values are zigzag encoded):
+ *
+ *  \code
+ *  stream:  header block* [header block*]...
+ *
+ *  header:  'L' '6' '3' 'T'   magic (4 bytes)
+ *           version           1 byte (LM63TRC_VERSION)
+ *           smbAddr           SMB address of the device (SMB_DEVADDR)
+ *           tempUnit          LM63_TEMP_UNIT of the temperature values
+ *           chMask            recorded channels (bit n: LM63_CH_xxx n)
+ *           startSec          wall clock of time 0 [s since 1970] (0=unknown)
+ *           identLen, ident   driver ident string (IdentString)
+ *
+ *  block:   0xb5              sync byte (LM63TRC_SYNC)
+ *           len               payload length (1..LM63TRC_BLK_MAX)
+ *           sec, ms           time of the first record since time 0
+ *           payload           records
+ *           chk               Fletcher-16 of payload (2 bytes, LSB first)
+ *
+ *  record:  head              dt << 1 | same
+ *                             dt:   time since previous record [ms]
+ *                             same: 1=all values unchanged (no deltas)
+ *           delta[]           if !same: value - previous value
+ *                             for each channel of chMask (ascending)
+ * \endcode
+ *
+ *               Each block starts with previous values 0 and previous time
+ *               equal to the block time, so blocks decode independently.
+ *               A decoder can skip a block by its length and resynchronizes
+ *               at the next sync byte after a damaged block. Recordings can
+ *               be appended: a header may follow any block.
+ *
+ *    \switches  (none)
+ */
+ /*
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _LM63_TRC_H
+#define _LM63_TRC_H
+
+#ifdef __cplusplus
+      extern "C" {
+#endif
+
+/*-----------------------------------------+
+|  DEFINES                                 |
++-----------------------------------------*/
+#define LM63TRC_VERSION		1		/**< format version */
+#define LM63TRC_SYNC		0xb5	/**< block sync byte */
+#define LM63TRC_CH_MAX		4		/**< max. channels per record */
+#define LM63TRC_IDENT_MAX	256		/**< max. ident string length (incl. '\0') */
+#define LM63TRC_BLK_MAX		4096	/**< max. block payload [bytes] */
+#define LM63TRC_HDR_MAX		(4 + 1 + 4*5 + 5 + LM63TRC_IDENT_MAX)
+									/**< max. encoded header size [bytes] */
+#define LM63TRC_REC_MAX		(5 + LM63TRC_CH_MAX*5)
+									/**< max. encoded record size [bytes] */
+#define LM63TRC_DEC_BUF		(LM63TRC_BLK_MAX + 32 + LM63TRC_HDR_MAX)
+									/**< decoder buffer size [bytes] */
+
+/** \name error codes */
+/**@{*/
+#define LM63TRC_ERR_PARAM	-1		/**< illegal parameter */
+#define LM63TRC_ERR_WRITE	-2		/**< write function failed */
+#define LM63TRC_ERR_FORMAT	-3		/**< damaged data skipped */
+/**@}*/
+
+/** \name LM63TRC_DecGet() events */
+/**@{*/
+#define LM63TRC_EV_NONE		0		/**< more data required */
+#define LM63TRC_EV_HDR		1		/**< header decoded */
+#define LM63TRC_EV_REC		2		/**< record decoded */
+/**@}*/
+
+/*-----------------------------------------+
+|  TYPEDEFS                                |
++-----------------------------------------*/
+/** stream header */
+typedef struct {
+	u_int32	smbAddr;		/**< SMB address of the device */
+	u_int32	tempUnit;		/**< LM63_TEMP_UNIT of temperature values */
+	u_int32	chMask;			/**< recorded channels (bit n: channel n) */
+	u_int32	startSec;		/**< wall clock of time 0 [s] (0=unknown) */
+	char	ident[LM63TRC_IDENT_MAX];	/**< driver ident string */
+} LM63TRC_HDR;
+
+/** decoded record */
+typedef struct {
+	u_int32	sec;			/**< time since time 0 [s] */
+	u_int32	ms;				/**< time since time 0, fraction [ms] */
+	int32	value[LM63TRC_CH_MAX];	/**< values (index: channel) */
+} LM63TRC_REC;
+
+/** write function of the encoder
+ *
+ *  \return \c 0 on success, otherwise error
+ */
+typedef int32 LM63TRC_WRITE( void *arg, const u_int8 *buf, u_int32 len );
+
+/** encoder state */
+typedef struct {
+	LM63TRC_WRITE	*writeFn;	/**< write function */
+	void		*arg;			/**< argument of write function */
+	u_int32		chMask;			/**< recorded channels */
+	u_int32		blkRecs;		/**< max. records per block */
+	u_int32		recs;			/**< records in current block */
+	u_int32		started;		/**< first record encoded */
+	u_int32		time;			/**< time of previous record [ms] (wraps) */
+	u_int32		sec;			/**< time of previous record since time 0 [s] */
+	u_int32		ms;				/**< time of previous record, fraction [ms] */
+	u_int32		blkSec;			/**< time of first record of block [s] */
+	u_int32		blkMs;			/**< time of first record of block [ms] */
+	int32		prev[LM63TRC_CH_MAX];	/**< previous values */
+	u_int32		len;			/**< payload length */
+	u_int8		blk[LM63TRC_BLK_MAX];	/**< payload of current block */
+} LM63TRC_ENC;
+
+/** decoder state */
+typedef struct {
+	LM63TRC_HDR	hdr;			/**< current header */
+	u_int32		hdrValid;		/**< header decoded */
+	u_int32		chNum;			/**< channels per record */
+	u_int32		errors;			/**< damaged units skipped */
+	u_int32		inBlk;			/**< decoding records of a block */
+	u_int32		pos;			/**< read position in buf */
+	u_int32		end;			/**< end of payload in buf */
+	u_int32		sec;			/**< time of previous record [s] */
+	u_int32		ms;				/**< time of previous record, fraction [ms] */
+	int32		prev[LM63TRC_CH_MAX];	/**< previous values */
+	u_int32		rd;				/**< first unconsumed byte in buf */
+	u_int32		wr;				/**< end of data in buf */
+	u_int8		buf[LM63TRC_DEC_BUF];	/**< input buffer */
+} LM63TRC_DEC;
+
+/*-----------------------------------------+
+|  PROTOTYPES                              |
++-----------------------------------------*/
+extern int32 LM63TRC_EncInit( LM63TRC_ENC *enc, const LM63TRC_HDR *hdrP,
+							  u_int32 blkRecs, LM63TRC_WRITE *writeFn,
+							  void *arg );
+extern int32 LM63TRC_EncPut( LM63TRC_ENC *enc, u_int32 timeMs,
+							 const int32 *valP );
+extern int32 LM63TRC_EncFlush( LM63TRC_ENC *enc );
+
+extern void LM63TRC_DecInit( LM63TRC_DEC *dec );
+extern u_int32 LM63TRC_DecPut( LM63TRC_DEC *dec, const u_int8 *buf,
+							   u_int32 len );
+extern int32 LM63TRC_DecGet( LM63TRC_DEC *dec, LM63TRC_REC *recP );
+
+#ifdef __cplusplus
+      }
+#endif
+
+#endif /* _LM63_TRC_H */